@@ -5,6 +5,7 @@ CONFIG -= app_bundle
 #CONFIG += release
 CONFIG += debug
 CONFIG += c++17
+CONFIG += thread
 
 # Select the graphics backend by uncommenting it.
 # - GL graphics requires the GLUT and GLEW libraries.
@@ -27,6 +28,17 @@ GRAPHICS = qt
 #PROFILING = enabled
 PROFILING = disabled
 
+# Store the CPM lattice as 16-bit spins instead of ints, see
+# spatial/spin.hpp. Halves the lattice traffic, but allows at most
+# 32767 cells.
+#COMPACT_SPINS = enabled
+COMPACT_SPINS = disabled
+
+# Store the CPM lattice in tiles of 4 x 4 sites instead of column by
+# column, see spatial/spin_lattice.hpp.
+#TILED_LATTICE = enabled
+TILED_LATTICE = disabled
+
 #USECUDA = enabled
 USECUDA = disabled
 
@@ -86,6 +98,15 @@ contains ( USECUDA, disabled ){
    SOURCES += reaction_diffusion/*.cpp
 }
 
+contains ( USECUDA, enabled ){
+   # pde_cuda.cu includes pde.cpp, but not the helpers it uses
+   SOURCES += reaction_diffusion/chemotaxis_potential.cpp \
+              reaction_diffusion/fft.cpp \
+              reaction_diffusion/multigrid.cpp \
+              reaction_diffusion/spectral_diffusion.cpp \
+              reaction_diffusion/tridiagonal.cpp
+}
+
 
 INCLUDEPATH += adhesions/ \
                cellular_potts/ \
@@ -175,3 +196,13 @@ contains( PROFILING, enabled ) {
   QMAKE_CXXFLAGS_RELEASE += -DPROFILING_ENABLED
   QMAKE_CXXFLAGS_DEBUG += -DPROFILING_ENABLED
 }
+
+contains( COMPACT_SPINS, enabled ) {
+  QMAKE_CXXFLAGS_RELEASE += -DCOMPACT_SPINS_ENABLED
+  QMAKE_CXXFLAGS_DEBUG += -DCOMPACT_SPINS_ENABLED
+}
+
+contains( TILED_LATTICE, enabled ) {
+  QMAKE_CXXFLAGS_RELEASE += -DTILED_LATTICE_ENABLED
+  QMAKE_CXXFLAGS_DEBUG += -DTILED_LATTICE_ENABLED
+}
@@ -4,6 +4,8 @@
 #include "sqr.hpp"
 #include "vec2.hpp"
 
+#include <algorithm>
+
 extern Parameter par;
 
 /* Return a list of coordinates of pixels in range.
@@ -34,23 +36,29 @@ std::vector<PixelPos> adhesion_zone(CellularPotts const &ca) {
 
   auto neighbours = neighbour_list();
 
-  for (int y = 0; y < par.sizey; ++y) {
-    for (int x = 0; x < par.sizex; ++x) {
-      PixelPos pixel(x, y);
-
-      int cur_cell = ca.Sigma(x, y);
-      if (cur_cell > 0) {
-        for (PixelDisplacement nb : neighbours) {
-          PixelPos np = pixel + nb;
-          if ((np.x >= 0) && (np.x < par.sizex) && (np.y >= 0) &&
-              (np.y < par.sizey) && (ca.Sigma(np.x, np.y) != cur_cell)) {
-            result.push_back(pixel);
-            break;
-          }
+  // visit the pixels of the cells rather than the whole lattice
+  const auto &pixels = ca.GetCellPixels();
+  for (int cur_cell = 1; cur_cell < pixels.Cells(); ++cur_cell) {
+    for (auto const &p : pixels.Pixels(cur_cell)) {
+      PixelPos pixel(p[0], p[1]);
+
+      for (PixelDisplacement nb : neighbours) {
+        PixelPos np = pixel + nb;
+        if ((np.x >= 0) && (np.x < par.sizex) && (np.y >= 0) &&
+            (np.y < par.sizey) && (ca.Sigma(np.x, np.y) != cur_cell)) {
+          result.push_back(pixel);
+          break;
         }
       }
     }
   }
 
+  // keep the order of a scan of the lattice, rows first, so that random
+  // choices from the zone do not depend on the order of the pixel lists
+  std::sort(result.begin(), result.end(),
+            [](PixelPos const &a, PixelPos const &b) {
+              return (a.y < b.y) || ((a.y == b.y) && (a.x < b.x));
+            });
+
   return result;
 }
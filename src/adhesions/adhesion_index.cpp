@@ -202,7 +202,7 @@ namespace {
    }
 }
 
-void AdhesionIndex::set_myosin(const ACT::ActField act_field) {
+void AdhesionIndex::set_myosin(const ACT::ActField &act_field) {
     for (auto & pos_adhesions : adhesions_by_pixel_) {
         auto pos = pos_adhesions.first;
         auto act_percentage = act_field.Value(pos) / par.max_Act;
@@ -216,11 +216,12 @@ void AdhesionIndex::set_myosin(const ACT::ActField act_field) {
     }
 }
 
-void AdhesionIndex::setting_force_on_adhesions(std::vector<ParPos> midpoints, int** sigma) {
+void AdhesionIndex::setting_force_on_adhesions(std::vector<ParPos> midpoints,
+                                               const SpinLattice &sigma) {
     for (auto& pos_adhesions : adhesions_by_pixel_) {
         for (auto& awe : pos_adhesions.second) {
             Force force(0.0, 0.0);
-            auto spin = sigma[pos_adhesions.first.x][pos_adhesions.first.y];
+            auto spin = sigma(pos_adhesions.first.x, pos_adhesions.first.y);
             auto center = midpoints[spin];
             auto delta  = center - awe.position;
             delta = (1.0 / delta.length()) * delta;
@@ -193,10 +193,11 @@ class AdhesionIndex {
          * 
          * @param act_field Actin field on which myosin is based.
         */
-        void set_myosin(const ACT::ActField);
+        void set_myosin(const ACT::ActField &);
 
         /// Helper function in rebuild(), run before  setting_size.
-        void setting_force_on_adhesions(std::vector<ParPos> midpoints, int** sigma);
+        void setting_force_on_adhesions(std::vector<ParPos> midpoints,
+                                        const SpinLattice &sigma);
         
         /// Helper function in rebuild(), run after setting_force.
         void setting_size_on_adhesions();
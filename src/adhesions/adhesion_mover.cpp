@@ -125,6 +125,22 @@ double AdhesionMover::move_dh(PixelPos source_pixel, PixelPos target_pixel,
     return source_dh + target_dh;
 }
 
+double AdhesionMover::move_dh_lower_bound(PixelPos from, PixelPos to) const
+{
+    // Extensions and retractions that move adhesions can lower the energy
+    // by any amount, only the yielding penalty is known not to.
+    if (!index_.get_adhesions(from).empty())
+        return -std::numeric_limits<double>::infinity();
+
+    if (index_.get_adhesions(to).empty())
+        return 0.0;
+
+    if (par.adhesion_yielding)
+        return std::min(0.0, 1.0 * par.adhesion_yielding_lambda);
+
+    return -std::numeric_limits<double>::infinity();
+}
+
 void AdhesionMover::commit_move(PixelPos source_pixel, PixelPos target_pixel,
                                 AdhesionDisplacements const &displacements)
 {
@@ -168,7 +184,7 @@ void AdhesionMover::update(ECMBoundaryState const &ecm_boundary)
     index_.setting_size_on_adhesions();
 }
 
-void AdhesionMover::update_myosin(const ACT::ActField act_field){
+void AdhesionMover::update_myosin(const ACT::ActField &act_field){
     index_.set_myosin(act_field);
 }
 
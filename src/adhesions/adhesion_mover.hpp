@@ -71,6 +71,18 @@ class AdhesionMover {
                 PixelPos from, PixelPos to,
                 AdhesionDisplacements & displacements) const;
 
+        /** A cheap lower bound on move_dh().
+         *
+         * This does not select any displacements. If there is no cheap
+         * bound, because adhesions at the source pixel would move to a place
+         * of lower energy, it returns minus infinity.
+         *
+         * @param from Pixel to be copied from
+         * @param to Pixel to copied to
+         * @return A value that move_dh(from, to) will not be below.
+         */
+        double move_dh_lower_bound(PixelPos from, PixelPos to) const;
+
         /** Update the adhesions following a move.
          *
          * This modifies the associated ECM as well as the cache, so update()
@@ -116,7 +128,7 @@ class AdhesionMover {
 
         void ContractAdhesionInCells(double); 
         
-        void update_myosin(const ACT::ActField act_field); 
+        void update_myosin(const ACT::ActField &act_field);
 
         
         
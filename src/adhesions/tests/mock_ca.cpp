@@ -13,3 +13,22 @@ int MockCellularPotts::Sigma(int x, int y) const {
     return sigma_return_values.at({x, y});
 }
 
+
+const std::vector<MockCellPixels::Pixel> &MockCellPixels::Pixels(int cell) const {
+    static const std::vector<Pixel> none;
+    return cell < Cells() ? pixels[cell] : none;
+}
+
+
+MockCellPixels MockCellularPotts::GetCellPixels() const {
+    MockCellPixels result;
+    for (auto const &value : sigma_return_values) {
+        int cell = value.second;
+        if (cell <= 0)
+            continue;
+        if (cell >= result.Cells())
+            result.pixels.resize(cell + 1);
+        result.pixels[cell].push_back({value.first.x, value.first.y});
+    }
+    return result;
+}
@@ -1,15 +1,33 @@
 #pragma once
 
+#include <array>
 #include <tuple>
 #include <unordered_map>
+#include <vector>
 
 #include "vec2.hpp"
 
 
+class MockCellPixels {
+    public:
+        using Pixel = std::array<int, 2>;
+
+        int Cells() const { return static_cast<int>(pixels.size()); }
+        const std::vector<Pixel> &Pixels(int cell) const;
+
+        std::vector<std::vector<Pixel>> pixels;
+};
+
+
 class MockCellularPotts {
     public:
         int Sigma(int x, int y) const;
 
+        /* Pixels of the cells in sigma_return_values, which unlike those of
+         * the real CPM may be on the edge of the lattice.
+         */
+        MockCellPixels GetCellPixels() const;
+
         std::unordered_map<PixelPos, int> sigma_return_values;
 };
 
@@ -1,17 +1,21 @@
 #include <act.hpp>
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <parameter.hpp>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 extern Parameter par;
 
 using namespace ACT;
 namespace
 {
-    double GeoMetricMean(ActField const &act_field, int **sigma, PixelPos pos)
+    double GeoMetricMean(ActField const &act_field, const SpinLattice &sigma,
+                         PixelPos pos)
     {
         // NO BOUNDS CHECK for sigma!!!
-        int mainspin = sigma[pos.x][pos.y];
+        int mainspin = sigma(pos.x, pos.y);
         double output = 1.0;
         int count = 0;
         for (int i = -1; i <= 1; i++)
@@ -19,8 +23,21 @@ namespace
             {
                 PixelPos neighbour_pos(i, j);
                 neighbour_pos += pos;
-                if (sigma[neighbour_pos.x][neighbour_pos.y] == mainspin)
+                if (sigma(neighbour_pos.x, neighbour_pos.y) == mainspin)
                 {
+                    // with periodic boundaries, sigma's halo holds periodic
+                    // images; the act field only has the lattice itself
+                    if (par.periodic_boundaries)
+                    {
+                        if (neighbour_pos.x <= 0)
+                            neighbour_pos.x += par.sizex - 2;
+                        if (neighbour_pos.y <= 0)
+                            neighbour_pos.y += par.sizey - 2;
+                        if (neighbour_pos.x >= par.sizex - 1)
+                            neighbour_pos.x -= par.sizex - 2;
+                        if (neighbour_pos.y >= par.sizey - 1)
+                            neighbour_pos.y -= par.sizey - 2;
+                    }
                     double value = act_field.Value(neighbour_pos);
                     if (value <= 0.0) {
                         return 0.0;
@@ -35,67 +52,144 @@ namespace
     }
 }
 
-void ActField::IncreaseValue(PixelPos pos, double value) {
-    value_[pos] += value;
+ActField::ActField(int sizex, int sizey)
+{
+    Resize(sizex, sizey);
 }
 
-double ActField::Value(PixelPos pos) const
+void ActField::Resize(int sizex, int sizey)
 {
-    auto it = value_.find(pos);
-    if (it != value_.end())
+    sizex = std::max(sizex, sizex_);
+    sizey = std::max(sizey, sizey_);
+
+    Array2d<float> value(sizex, sizey);
+    std::vector<int> active_index(sizex * sizey, -1);
+    float *data = value.get_data();
+    const float *old_data = value_.get_data();
+    for (int &site : active_)
     {
-        return it->second;
+        const int x = site / sizey_, y = site % sizey_;
+        const int new_site = x * sizey + y;
+        data[new_site] = old_data[site];
+        active_index[new_site] = active_index_[site];
+        site = new_site;
     }
-    return 0.0;
+
+    sizex_ = sizex;
+    sizey_ = sizey;
+    value_ = std::move(value);
+    active_index_ = std::move(active_index);
+}
+
+int ActField::Activate(PixelPos pos)
+{
+    if (pos.x < 0 || pos.y < 0)
+        throw std::out_of_range("ActField: pixel outside of the lattice");
+    if (pos.x >= sizex_ || pos.y >= sizey_)
+        Resize(std::max(pos.x + 1, 2 * sizex_), std::max(pos.y + 1, 2 * sizey_));
+
+    const int site = Site(pos);
+    if (active_index_[site] == -1)
+    {
+        active_index_[site] = static_cast<int>(active_.size());
+        active_.push_back(site);
+    }
+    return site;
+}
+
+void ActField::IncreaseValue(PixelPos pos, double value) {
+    const int site = Activate(pos);
+    value_.get_data()[site] += value;
+}
+
+double ActField::Value(PixelPos pos) const
+{
+    const int site = Site(pos);
+    if (site == -1)
+        return 0.0;
+    return value_.get_data()[site];
 }
 
 void ActField::SetValue(PixelPos pos, double value)
 {
     if (value > 0.0)
-        value_[pos] = value;
-    else{
-        value_.erase(pos);
+    {
+        const int site = Activate(pos);
+        value_.get_data()[site] = value;
+        return;
     }
+
+    const int site = Site(pos);
+    if (site == -1 || active_index_[site] == -1)
+        return;
+    // move the last live pixel into the hole
+    const int i = active_index_[site];
+    active_[i] = active_.back();
+    active_index_[active_[i]] = i;
+    active_.pop_back();
+    active_index_[site] = -1;
+    value_.get_data()[site] = 0.0f;
 }
 
 void ActField::Decrease()
 {
-    auto it = value_.begin();
-    while (it != value_.end())
+    float *data = value_.get_data();
+    for (int site : active_)
+        data[site] -= 1.0f;
+
+    // drop pixels that ran out, keeping the others in order
+    std::size_t n = 0;
+    for (int site : active_)
     {
-        it->second -= 1.0;
-        if (it->second <= 0.0)
+        if (data[site] > 0.0f)
         {
-            it = value_.erase(it);
+            active_index_[site] = static_cast<int>(n);
+            active_[n++] = site;
         }
         else
         {
-            it++;
+            data[site] = 0.0f;
+            active_index_[site] = -1;
         }
     }
+    active_.resize(n);
+}
+
+std::unordered_map<PixelPos, double> ACT::getValue(const ActField &act_field)
+{
+    std::unordered_map<PixelPos, double> values;
+    const float *data = act_field.value_.get_data();
+    for (int site : act_field.active_)
+        values[{site / act_field.sizey_, site % act_field.sizey_}] = data[site];
+    return values;
 }
 
-double ACT::DeltaH(ActField const &act_field, int **sigma, PixelPos from,
-                   PixelPos to, double const lambda_act, double const max_Act)
+double ACT::DeltaH(ActField const &act_field, const SpinLattice &sigma,
+                   PixelPos from, PixelPos to, double const lambda_act,
+                   double const max_Act)
 {
+    // most cells have no act, e.g. all but the tip cells in ISV
+    if (lambda_act == 0.0)
+        return 0.0;
+
     double GM_source = GeoMetricMean(act_field, sigma, from);
-    if (sigma[from.x][from.y] == 0 && GM_source >0)
+    if (sigma(from.x, from.y) == 0 && GM_source >0)
         throw std::runtime_error("from medium has positive act!!");
 
     double GM_target = GeoMetricMean(act_field, sigma, to);
-    if (sigma[to.x][to.y] == 0 && GM_target >0)
+    if (sigma(to.x, to.y) == 0 && GM_target >0)
         throw std::runtime_error("to medium has positive act!!");
 
     return (lambda_act / max_Act) * (GM_source - GM_target);
 }
 
-void ACT::commit_move(ActField &act_field, int **sigma, PixelPos from,
-                      PixelPos to)
+void ACT::commit_move(ActField &act_field, const SpinLattice &sigma,
+                      PixelPos from, PixelPos to)
 {
-    if (sigma[from.x][from.y] > 0){
+    if (sigma(from.x, from.y) > 0){
         act_field.SetValue(to, par.max_Act);
     }
 
-    if (sigma[from.x][from.y] == 0)
+    if (sigma(from.x, from.y) == 0)
         act_field.SetValue(to, 0);
 }
\ No newline at end of file
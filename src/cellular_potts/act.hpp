@@ -1,14 +1,27 @@
 #pragma once
+#include <array2d.hpp>
+#include <spin_lattice.hpp>
 #include <unordered_map>
 #include <vec2.hpp>
+#include <vector>
 
 namespace ACT
 {
 
     /// @brief Stores the actin value per alive pixel.
+    ///
+    /// Values are kept in a dense array, together with a list of the pixels
+    /// that have one, so that lookups need no hashing and Decrease() only
+    /// visits live pixels. The array grows to fit pixels that are set outside
+    /// of it.
     class ActField
     {
     public:
+        ActField() = default;
+
+        /// @brief Create a field that fits a lattice of sizex by sizey
+        ActField(int sizex, int sizey);
+
         /// @brief Get the actin value of a pixel. If pixel is not alive returns
         /// 0.0.
         /// @param Position.
@@ -34,11 +47,35 @@ namespace ACT
         /// pixel if act value is 0
         void Decrease();
 
-        /// @brief Method used for testing.
-        friend std::unordered_map<PixelPos, double> getValue(ActField);
+        // reads the live pixels, see below
+        friend std::unordered_map<PixelPos, double> getValue(const ActField &);
     private:
-        std::unordered_map<PixelPos, double> value_;
+        /// @brief Index of pos in value_, or -1 if it's outside of it
+        int Site(PixelPos pos) const
+        {
+            if (pos.x < 0 || pos.x >= sizex_ || pos.y < 0 || pos.y >= sizey_)
+                return -1;
+            return pos.x * sizey_ + pos.y;
+        }
+
+        /// @brief Site of pos, growing the field if needed, and make it live
+        int Activate(PixelPos pos);
+
+        /// @brief Make the field at least sizex by sizey
+        void Resize(int sizex, int sizey);
+
+        int sizex_ = 0, sizey_ = 0;
+        Array2d<float> value_;
+        // per site, the index into active_, or -1 if the site has no value
+        std::vector<int> active_index_;
+        std::vector<int> active_;
     };
+
+    /// @brief The live pixels of an act field and their values, e.g. for
+    /// output.
+    /// @param act_field The act field to read.
+    std::unordered_map<PixelPos, double> getValue(const ActField &act_field);
+
     /// @brief Compute the deltaH that should be substracted from the DH.
     /// @param act_field Actin field which values should be used.
     /// @param sigma The spin configuration that should be used.
@@ -48,8 +85,9 @@ namespace ACT
     /// @param max_act Maxium Actin value.
     /// @return DeltaH contribution, should be substracted from the total
     /// hamiltonian to give a discount for high act movements.
-    double DeltaH(ActField const &act_field, int **sigma, PixelPos from,
-                  PixelPos to, double const lambda_act, double const max_act);
+    double DeltaH(ActField const &act_field, const SpinLattice &sigma,
+                  PixelPos from, PixelPos to, double const lambda_act,
+                  double const max_act);
 
     /// @brief Commit a move. If the move is an extension (spin of target > 0),
     /// sets the act value of the target to maxact. Should be called after a
@@ -59,7 +97,7 @@ namespace ACT
     /// @param sigma The spin field used.
     /// @param from The source pixel
     /// @param to The target pixel.
-    void commit_move(ActField &act_field, int **sigma, PixelPos from,
-                     PixelPos to);
+    void commit_move(ActField &act_field, const SpinLattice &sigma,
+                     PixelPos from, PixelPos to);
 
 }
@@ -0,0 +1,58 @@
+#include "act_pixels.hpp"
+
+ActPixels::ActPixels(int sizex, int sizey)
+    : sizey_(sizey), level_(sizex * sizey, 0), index_(sizex * sizey, -1)
+{
+}
+
+void ActPixels::SetAlive(int x, int y, int level)
+{
+    const int site = x * sizey_ + y;
+    level_[site] = level;
+    if (index_[site] == -1)
+    {
+        index_[site] = static_cast<int>(alive_.size());
+        alive_.push_back({x, y});
+    }
+}
+
+void ActPixels::Kill(int x, int y)
+{
+    const int site = x * sizey_ + y;
+    level_[site] = 0;
+    const int i = index_[site];
+    if (i == -1)
+        return;
+
+    // move the last alive pixel into the hole
+    const auto last = alive_.back();
+    alive_[i] = last;
+    index_[last[0] * sizey_ + last[1]] = i;
+    alive_.pop_back();
+    index_[site] = -1;
+}
+
+void ActPixels::Age(double value)
+{
+    for (const auto &pixel : alive_)
+    {
+        int &level = level_[pixel[0] * sizey_ + pixel[1]];
+        if (level > 0)
+            level = static_cast<int>(level - value);
+    }
+}
+
+void NeighbourChanges::Reset(std::size_t size)
+{
+    for (int cell : touched_)
+    {
+        count_[cell] = 0;
+        touched_flag_[cell] = false;
+    }
+    touched_.clear();
+    if (count_.size() < size)
+    {
+        count_.resize(size, 0);
+        touched_flag_.resize(size, false);
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <vector>
+
+/** @brief Act levels and the set of alive pixels of the Act model.
+ *
+ * Levels are stored densely, one per lattice site, and the alive pixels in a
+ * list with a per-site index into it, so that looking up, inserting and
+ * removing a pixel are all O(1) without hashing or allocation.
+ */
+class ActPixels
+{
+public:
+    ActPixels() = default;
+    ActPixels(int sizex, int sizey);
+
+    //! @brief Act level of pixel (x,y), 0 if it has none
+    int Level(int x, int y) const { return level_[x * sizey_ + y]; }
+
+    //! @brief Make (x,y) alive with the given act level
+    void SetAlive(int x, int y, int level);
+
+    //! @brief Remove (x,y) from the alive pixels and reset its act level
+    void Kill(int x, int y);
+
+    //! @brief Whether (x,y) is alive
+    bool Alive(int x, int y) const { return index_[x * sizey_ + y] != -1; }
+
+    /** @brief Lower the act level of all alive pixels with a positive level
+     * by value, truncating the result
+     */
+    void Age(double value);
+
+    //! @brief The alive pixels, in no particular order
+    const std::vector<std::array<int, 2>> &AlivePixels() const
+    {
+        return alive_;
+    }
+
+private:
+    int sizey_ = 0;
+    std::vector<int> level_;
+    // position of each site in alive_, or -1
+    std::vector<int> index_;
+    std::vector<std::array<int, 2>> alive_;
+};
+
+/** @brief Neighbour count changes of a copy attempt, for cells with ids in
+ * [0, size)
+ *
+ * A dense array of counts that is reused between copy attempts. Only the
+ * entries that were touched are cleared by Reset(), so the cost of an attempt
+ * is proportional to the neighbourhood size rather than the number of cells.
+ */
+class NeighbourChanges
+{
+public:
+    //! @brief Clear all counts, and make room for cells [0, size)
+    void Reset(std::size_t size);
+
+    //! @brief Add delta to the count of cell
+    void Add(int cell, int delta)
+    {
+        if (!touched_flag_[cell])
+        {
+            touched_flag_[cell] = true;
+            touched_.push_back(cell);
+        }
+        count_[cell] += delta;
+    }
+
+    int operator[](int cell) const { return count_[cell]; }
+
+    //! @brief Cells whose count was changed since the last Reset()
+    const std::vector<int> &Touched() const { return touched_; }
+
+private:
+    std::vector<int> count_;
+    std::vector<bool> touched_flag_;
+    std::vector<int> touched_;
+};
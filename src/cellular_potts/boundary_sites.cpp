@@ -0,0 +1,23 @@
+#include "boundary_sites.hpp"
+#include <algorithm>
+
+void BoundarySites::Reset(std::int64_t n_sites)
+{
+    edges_.assign(n_sites, 0);
+    sites_.clear();
+    stale_ = 0;
+    total_edges_ = 0;
+}
+
+void BoundarySites::Prune()
+{
+    auto end = std::remove_if(sites_.begin(), sites_.end(),
+                              [this](std::int64_t site) {
+                                  if (Edges(site) > 0)
+                                      return false;
+                                  edges_[site] = 0;
+                                  return true;
+                              });
+    sites_.erase(end, sites_.end());
+    stale_ = 0;
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+/** @brief The lattice sites on a cell boundary, for picking copy attempts.
+ *
+ * Stores for every site how many of its neighbours have a different spin
+ * (its edges), and keeps a list of the sites that have edges. A site takes a
+ * single byte, and a site on the list eight more, where the edge list takes
+ * eight bytes per neighbour of every site. Sites are numbered with 64-bit
+ * integers, so that large lattices do not overflow.
+ *
+ * Sites that lose their last edge stay on the list, and are removed in bulk
+ * once they make up half of it. Users drawing from the list must therefore
+ * skip sites without edges.
+ */
+class BoundarySites
+{
+public:
+    //! @brief Make room for n_sites sites, none of which has edges
+    void Reset(std::int64_t n_sites);
+
+    //! @brief Number of edges of site
+    int Edges(std::int64_t site) const { return edges_[site] & count_mask; }
+
+    //! @brief Add delta to the edges of site, updating the list of sites
+    void AddEdges(std::int64_t site, int delta)
+    {
+        const int old_edges = Edges(site);
+        edges_[site] += delta;
+        total_edges_ += delta;
+        if (old_edges == 0 && delta > 0)
+        {
+            if (edges_[site] & listed)
+                stale_--;
+            else
+            {
+                edges_[site] |= listed;
+                sites_.push_back(site);
+            }
+        }
+        else if (old_edges > 0 && old_edges + delta == 0)
+        {
+            if (++stale_ * 2 > Size())
+                Prune();
+        }
+    }
+
+    //! @brief Number of sites on the list, including some without edges
+    std::int64_t Size() const
+    {
+        return static_cast<std::int64_t>(sites_.size());
+    }
+
+    //! @brief The i'th site on the list, in no particular order
+    std::int64_t Site(std::int64_t i) const { return sites_[i]; }
+
+    //! @brief Sum of the edges of all sites
+    std::int64_t TotalEdges() const { return total_edges_; }
+
+private:
+    //! @brief Remove the sites without edges from the list
+    void Prune();
+
+    // the high bit of a site's byte tells whether it is on the list
+    static constexpr unsigned char listed = 0x80;
+    static constexpr unsigned char count_mask = 0x7f;
+
+    std::vector<unsigned char> edges_;
+    std::vector<std::int64_t> sites_;
+    std::int64_t stale_ = 0;
+    std::int64_t total_edges_ = 0;
+};
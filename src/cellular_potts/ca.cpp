@@ -26,6 +26,8 @@ Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
 // This code derives from a Cellular Potts implementation written around 1995
 // by Nick Savill
 
+#include <algorithm>
+#include <bitset>
 #include <cstdlib>
 #include <cstring>
 #include <fstream>
@@ -74,7 +76,7 @@ extern Parameter par;
 /** PRIVATE **/
 
 using namespace std;
-void CellularPotts::BaseInitialisation(vector<Cell> *cells)
+void CellularPotts::BaseInitialisation(CellPool *cells)
 {
     CopyProb(par.T);
     cell = cells;
@@ -85,16 +87,19 @@ void CellularPotts::BaseInitialisation(vector<Cell> *cells)
               "[1-4]).";
 }
 
-CellularPotts::CellularPotts(vector<Cell> *cells, const int sx, const int sy)
+CellularPotts::CellularPotts(CellPool *cells, const int sx, const int sy)
     : adhesion_mover(*this)
 {
-    sigma = 0;
     frozen = false;
     thetime = 0;
     zygote_area = 0;
 
     edgelist = nullptr;
     orderedgelist = nullptr;
+    mcs_rate_elapsed = std::chrono::steady_clock::duration::zero();
+    mcs_rate_count = 0;
+    cpm_rng = CounterRNG(CurrentSeed(), 0);
+    halo_filled = false;
 
     BaseInitialisation(cells);
     sizex = sx;
@@ -105,13 +110,13 @@ CellularPotts::CellularPotts(vector<Cell> *cells, const int sx, const int sy)
     // fill borders with special border state
     for (int x = 0; x < sizex; x++)
     {
-        sigma[x][0] = -1;
-        sigma[x][sizey - 1] = -1;
+        sigma(x, 0) = -1;
+        sigma(x, sizey - 1) = -1;
     }
     for (int y = 0; y < sizey; y++)
     {
-        sigma[0][y] = -1;
-        sigma[sizex - 1][y] = -1;
+        sigma(0, y) = -1;
+        sigma(sizex - 1, y) = -1;
     }
 
     if (par.neighbours >= 1 && par.neighbours <= 4)
@@ -119,11 +124,12 @@ CellularPotts::CellularPotts(vector<Cell> *cells, const int sx, const int sy)
     else
         throw "Panic in CellularPotts: parameter neighbours invalid (choose "
               "[1-4])";
+
+    SelectAmoebaeMove();
 }
 
 CellularPotts::CellularPotts(void) : adhesion_mover(*this)
 {
-    sigma = 0;
     sizex = 0;
     sizey = 0;
     frozen = false;
@@ -132,37 +138,36 @@ CellularPotts::CellularPotts(void) : adhesion_mover(*this)
 
     edgelist = nullptr;
     orderedgelist = nullptr;
+    mcs_rate_elapsed = std::chrono::steady_clock::duration::zero();
+    mcs_rate_count = 0;
+    cpm_rng = CounterRNG(CurrentSeed(), 0);
+    halo_filled = false;
 
     CopyProb(par.T);
 
     // fill borders with special border state
     for (int x = 0; x < sizex; x++)
     {
-        sigma[x][0] = -1;
-        sigma[x][sizey - 1] = -1;
+        sigma(x, 0) = -1;
+        sigma(x, sizey - 1) = -1;
     }
     for (int y = 0; y < sizey; y++)
     {
-        sigma[0][y] = -1;
-        sigma[sizex - 1][y] = -1;
+        sigma(0, y) = -1;
+        sigma(sizex - 1, y) = -1;
     }
     if (par.neighbours >= 1 && par.neighbours <= 4)
         n_nb = nbh_level[par.neighbours];
     else
         throw "Panic in CellularPotts: parameter neighbours invalid (choose "
               "[1-4])";
+
+    SelectAmoebaeMove();
 }
 
 // destructor (virtual)
 CellularPotts::~CellularPotts(void)
 {
-    if (sigma)
-    {
-        free(sigma[0]);
-        free(sigma);
-        sigma = 0;
-    }
-
     if (edgelist)
     {
         delete edgelist;
@@ -176,28 +181,93 @@ CellularPotts::~CellularPotts(void)
 
 void CellularPotts::AllocateSigma(int sx, int sy)
 {
+    InvalidateSpinIndices();
 
     sizex = sx;
     sizey = sy;
 
-    sigma = (int **)malloc(sizex * sizeof(int *));
-    if (sigma == NULL)
-        MemoryWarning();
+    // The lattice and its border are surrounded by pad more layers of border
+    // sites, so that the neighbourhood of any interior site is addressable.
+    sigma = SpinLattice(sizex, sizey, halo - 1, -1);
 
-    sigma[0] = (int *)malloc(sizex * sizey * sizeof(int));
-    if (sigma[0] == NULL)
-        MemoryWarning();
+    /* Clear CA plane */
+    {
+        for (int x = 0; x < sizex; x++)
+            for (int y = 0; y < sizey; y++)
+                sigma(x, y) = 0;
+    }
+    act_pixels = ActPixels(sizex, sizey);
+    act_field = ACT::ActField(sizex, sizey);
+}
 
+void CellularPotts::FillHalo(void)
+{
+    halo_filled = par.periodic_boundaries;
+    if (!halo_filled)
+        return; // the ring and the halo are border sites already
+
+    const int pad = halo - 1;
+    const int px = sizex - 2, py = sizey - 2;
+    for (int x = -pad; x < sizex + pad; x++)
     {
-        for (int i = 1; i < sizex; i++)
-            sigma[i] = sigma[i - 1] + sizey;
+        const bool edge_column = x < 1 || x > px;
+        const int xw = (x < 1) ? x + px : (x > px) ? x - px : x;
+        for (int y = -pad; y < sizey + pad; y++)
+        {
+            if (y == 1 && !edge_column)
+                y = py + 1; // skip the interior of the column
+            const int yw = (y < 1) ? y + py : (y > py) ? y - py : y;
+            sigma(x, y) = sigma(xw, yw);
+        }
     }
+}
 
-    /* Clear CA plane */
+void CellularPotts::ClearHalo(void)
+{
+    if (!halo_filled)
+        return;
+
+    const int pad = halo - 1;
+    for (int x = -pad; x < sizex + pad; x++)
     {
-        for (int i = 0; i < sizex * sizey; i++)
-            sigma[0][i] = 0;
+        const bool edge_column = x < 1 || x > sizex - 2;
+        for (int y = -pad; y < sizey + pad; y++)
+        {
+            if (y == 1 && !edge_column)
+                y = sizey - 1;
+            sigma(x, y) = -1;
+        }
     }
+    halo_filled = false;
+}
+
+void CellularPotts::UpdateHaloImages(int x, int y)
+{
+    const int px = sizex - 2, py = sizey - 2;
+    int xs[2] = {x, x}, ys[2] = {y, y};
+    int n_x = 1, n_y = 1;
+    if (x <= halo)
+        xs[n_x++] = x + px;
+    else if (x > px - halo)
+        xs[n_x++] = x - px;
+    if (y <= halo)
+        ys[n_y++] = y + py;
+    else if (y > py - halo)
+        ys[n_y++] = y - py;
+
+    for (int i = 0; i < n_x; i++)
+        for (int j = 0; j < n_y; j++)
+            if (i || j)
+                sigma(xs[i], ys[j]) = sigma(x, y);
+}
+
+std::vector<int> CellularPotts::getSigmaArray() const
+{
+    std::vector<int> array(sizex * sizey);
+    for (int x = 0; x < sizex; x++)
+        for (int y = 0; y < sizey; y++)
+            array[x * sizey + y] = sigma(x, y);
+    return array;
 }
 
 void CellularPotts::AllocateMatrix(Dish &beast)
@@ -226,6 +296,16 @@ void CellularPotts::AllocateMatrix(Dish &beast)
 
 void CellularPotts::InitialiseEdgeList(void)
 {
+    if (par.cpm_update_scheme == "boundary")
+    {
+        InitialiseBoundarySites();
+        return;
+    }
+    if (par.cpm_update_scheme == "nfold")
+    {
+        nfold.built = false;
+        return;
+    }
     edgelist =
         new int[(par.sizex - 2) * (par.sizey - 2) * nbh_level[par.neighbours]];
     orderedgelist =
@@ -257,7 +337,7 @@ void CellularPotts::InitialiseEdgeList(void)
         neighbour = k % nbh_level[par.neighbours] + 1;
         x = pixel % (sizex - 2) + 1;
         y = pixel / (sizex - 2) + 1;
-        c = sigma[x][y];
+        c = sigma(x, y);
         xp = nx[neighbour] + x;
         yp = ny[neighbour] + y;
 
@@ -273,12 +353,12 @@ void CellularPotts::InitialiseEdgeList(void)
                 xp = xp - sizex + 2;
             if (yp >= sizey - 1)
                 yp = yp - sizey + 2;
-            cp = sigma[xp][yp];
+            cp = sigma(xp, yp);
         }
         else if (xp <= 0 || yp <= 0 || xp >= sizex - 1 || yp >= sizey - 1)
             cp = -1;
         else
-            cp = sigma[xp][yp];
+            cp = sigma(xp, yp);
         if (cp != c && cp != -1)
         {
             // if a pixel and its neighbour have a different sigma, add a unique
@@ -292,12 +372,6 @@ void CellularPotts::InitialiseEdgeList(void)
     }
 }
 
-double sat(double x)
-{
-    return x / (par.saturation * x + 1.);
-    // return x;
-}
-
 int CellularPotts::IsingDeltaH(int x, int y, PDE *PDEfield)
 {
     int DH = 0, H_before = 0, H_after = 0;
@@ -306,7 +380,7 @@ int CellularPotts::IsingDeltaH(int x, int y, PDE *PDEfield)
     int J = par.lambda;
 
     /* Compute energydifference *IF* the flip were to occur */
-    sxy = sigma[x][y];
+    sxy = sigma(x, y);
 
     /* DH due to spin alignment */
 #ifdef DBG_KAWASAKI
@@ -334,7 +408,7 @@ int CellularPotts::IsingDeltaH(int x, int y, PDE *PDEfield)
             if (yn >= sizey - 1)
                 yn = yn - sizey + 2;
 
-            neigh_sxy = sigma[xn][yn];
+            neigh_sxy = sigma(xn, yn);
 
         } // periodic boundaries
         else
@@ -343,7 +417,7 @@ int CellularPotts::IsingDeltaH(int x, int y, PDE *PDEfield)
             if (xn <= 0 || yn <= 0 || xn >= sizex - 1 || yn >= sizey - 1)
                 neigh_sxy = -1;
             else
-                neigh_sxy = sigma[xn][yn];
+                neigh_sxy = sigma(xn, yn);
         }
 
         if (neigh_sxy == -1)
@@ -375,7 +449,7 @@ int CellularPotts::PottsDeltaH(int x, int y, int new_state)
     int J = par.lambda;
 
     /* Compute energydifference *IF* the flip were to occur */
-    sxy = sigma[x][y];
+    sxy = sigma(x, y);
 
     /* DH due to spin alignment */
 
@@ -400,7 +474,7 @@ int CellularPotts::PottsDeltaH(int x, int y, int new_state)
             if (yn >= sizey - 1)
                 yn = yn - sizey + 2;
 
-            neigh_sxy = sigma[xn][yn];
+            neigh_sxy = sigma(xn, yn);
 
         } // periodic boundaries
         else
@@ -409,7 +483,7 @@ int CellularPotts::PottsDeltaH(int x, int y, int new_state)
             if (xn <= 0 || yn <= 0 || xn >= sizex - 1 || yn >= sizey - 1)
                 neigh_sxy = -1;
             else
-                neigh_sxy = sigma[xn][yn];
+                neigh_sxy = sigma(xn, yn);
         }
 
         if (neigh_sxy == -1)
@@ -440,8 +514,8 @@ int CellularPotts::KawasakiDeltaH(int x, int y, int xp, int yp, PDE *PDEfield)
     int neigh_sxy, neigh_sxyp;
 
     /* Compute energydifference *IF* the copying were to occur */
-    sxy = sigma[x][y];
-    sxyp = sigma[xp][yp];
+    sxy = sigma(x, y);
+    sxyp = sigma(xp, yp);
 
     /* DH due to cell adhesion */
 #ifdef DBG_KAWASAKI
@@ -472,7 +546,7 @@ int CellularPotts::KawasakiDeltaH(int x, int y, int xp, int yp, PDE *PDEfield)
             if (yn >= sizey - 1)
                 yn = yn - sizey + 2;
 
-            neigh_sxy = sigma[xn][yn];
+            neigh_sxy = sigma(xn, yn);
 
             if (xpn <= 0)
                 xpn = sizex - 2 + xpn;
@@ -483,7 +557,7 @@ int CellularPotts::KawasakiDeltaH(int x, int y, int xp, int yp, PDE *PDEfield)
             if (ypn >= sizey - 1)
                 ypn = ypn - sizey + 2;
 
-            neigh_sxyp = sigma[xpn][ypn];
+            neigh_sxyp = sigma(xpn, ypn);
 
         } // periodic boundaries
         else
@@ -492,12 +566,12 @@ int CellularPotts::KawasakiDeltaH(int x, int y, int xp, int yp, PDE *PDEfield)
             if (xn <= 0 || yn <= 0 || xn >= sizex - 1 || yn >= sizey - 1)
                 neigh_sxy = -1;
             else
-                neigh_sxy = sigma[xn][yn];
+                neigh_sxy = sigma(xn, yn);
 
             if (xpn <= 0 || ypn <= 0 || xpn >= sizex - 1 || ypn >= sizey - 1)
                 neigh_sxyp = -1;
             else
-                neigh_sxyp = sigma[xpn][ypn];
+                neigh_sxyp = sigma(xpn, ypn);
         }
 
         if (neigh_sxy == -1)
@@ -532,29 +606,33 @@ int CellularPotts::KawasakiDeltaH(int x, int y, int xp, int yp, PDE *PDEfield)
 
 #include "deltah.hpp"
 int CellularPotts::DeltaH(int x, int y, int xp, int yp, PDE *PDEfield,
-                          AdhesionDisplacements *adh_disp)
+                          AdhesionDisplacements *adh_disp, EnergyTerms *terms)
 {
     int DH = 0;
-    int i, sxy, sxyp;
-    int neighsite;
+    int sxy, sxyp;
 
     /* Compute energydifference *IF* the copying were to occur */
-    sxy = sigma[x][y];
-    sxyp = sigma[xp][yp];
+    sxy = sigma(x, y);
+    sxyp = sigma(xp, yp);
+    EnergyTerms dh;
 
 // if (par.target_area > 0 )
-        DH += DeltaH::area_constraint(cell, sxy, sxyp);
+        dh.area = DeltaH::area_constraint(hot_cells, sxy, sxyp);
 //    else
-//        DH += DeltaH::linear_area_constraint(cell, sxy, sxyp);
+//        dh.area = DeltaH::linear_area_constraint(hot_cells, sxy, sxyp);
+    DH += dh.area;
 
-    DH += DeltaH::length_constraint(n_nb, x, y, xp, yp, sigma, cell, sxy, sxyp);
+    dh.length = DeltaH::length_change(x, y, hot_cells, sxy, sxyp);
+    DH += -(int)(-dh.length);
 
     /* DH due to cell adhesion */
-    DH += DeltaH::contact_energy(n_nb, x, y, xp, yp, sigma, cell, sxy, sxyp);
+    dh.adhesion = DeltaH::contact_energy(n_nb, x, y, xp, yp, sigma, hot_cells, sxy, sxyp);
+    DH += dh.adhesion;
 
     {
-        double dh = DeltaH::spreading_constraint(cell, sxy, sxyp);
-        DH -= dh;
+        double spreading = DeltaH::spreading_constraint(hot_cells, sxy, sxyp);
+        DH -= spreading;
+        dh.spreading = -spreading;
     }
     if (PDEfield && (par.vecadherinknockout || (sxyp == 0 || sxy == 0)))
     {
@@ -563,7 +641,10 @@ int CellularPotts::DeltaH(int x, int y, int xp, int yp, PDE *PDEfield,
         // only chemotactic extensions contribute to energy change
         if (!(par.extensiononly && sxyp == 0))
         {
-            DH += DeltaH::chemotaxis(x, y, xp, yp, PDEfield);
+            dh.chemotaxis = DeltaH::chemotaxis(
+                x, y, xp, yp, PDEfield->GetChemotaxisPotential(),
+                hot_cells.Tau(sxyp > 0 ? sxyp : sxy));
+            DH += dh.chemotaxis;
         }
     }
 
@@ -572,8 +653,8 @@ int CellularPotts::DeltaH(int x, int y, int xp, int yp, PDE *PDEfield,
     {
         if (adh_disp)
         {
-            double adh_dh = adhesion_mover.move_dh({xp, yp}, {x, y}, *adh_disp);
-            DH += static_cast<int>(round(adh_dh));
+            dh.ecm = adhesion_mover.move_dh({xp, yp}, {x, y}, *adh_disp);
+            DH += static_cast<int>(round(dh.ecm));
         }
         else
         {
@@ -585,10 +666,13 @@ int CellularPotts::DeltaH(int x, int y, int xp, int yp, PDE *PDEfield,
 
     if (par.lambda_Act > 0) {
         if ( sxyp > 0 )
-            DH -= ACT::DeltaH(act_field, sigma, {xp,yp}, {x,y}, (*cell)[sxyp].lambda_act,par.max_Act);
+            dh.act = -ACT::DeltaH(act_field, sigma, {xp,yp}, {x,y}, hot_cells.LambdaAct(sxyp),par.max_Act);
         else 
-            DH -= ACT::DeltaH(act_field, sigma, {xp,yp}, {x,y}, (*cell)[sxy].lambda_act, par.max_Act);
+            dh.act = -ACT::DeltaH(act_field, sigma, {xp,yp}, {x,y}, hot_cells.LambdaAct(sxy), par.max_Act);
+        DH += dh.act;
     }
+    if (terms)
+        *terms = dh;
     return DH;
 }
 
@@ -599,6 +683,9 @@ int CellularPotts::Act_AmoebaeMove(PDE *PDEfield)
     int SumDH = 0;
     if (frozen)
         return 0;
+    // the copies below are not accounted for in Energy()
+    energy_live = false;
+    FillHalo();
     loop = (sizex - 2) * (sizey - 2);
     for (int i = 0; i < loop; i++)
     {
@@ -610,12 +697,11 @@ int CellularPotts::Act_AmoebaeMove(PDE *PDEfield)
         int xyp = (int)(n_nb * RANDOM() + 1);
         int xp = nx[xyp] + x;
         int yp = ny[xyp] + y;
-        int k = sigma[x][y];
-        int kp;
+        int k = sigma(x, y);
         if (par.periodic_boundaries)
         {
-            // since we are asynchronic, we cannot just copy the borders once
-            // every MCS
+            // (xp,yp) is also used to index the act and matrix fields, which
+            // have no halo
             if (xp <= 0)
                 xp = sizex - 2 + xp;
             if (yp <= 0)
@@ -624,19 +710,8 @@ int CellularPotts::Act_AmoebaeMove(PDE *PDEfield)
                 xp = xp - sizex + 2;
             if (yp >= sizey - 1)
                 yp = yp - sizey + 2;
-            kp = sigma[xp][yp];
-        }
-        else
-        {
-            if (xp <= 0 || yp <= 0 || xp >= sizex - 1 || yp >= sizey - 1)
-            {
-                kp = -1;
-            }
-            else
-            {
-                kp = sigma[xp][yp];
-            }
         }
+        int kp = sigma(xp, yp);
         // test for border state (relevant only if we do not use
         // periodic boundaries)
         if (kp != -1)
@@ -660,34 +735,10 @@ int CellularPotts::Act_AmoebaeMove(PDE *PDEfield)
                         if (par.lambda_Act > 0)
                         {
                             // Update actin field
-                            if (sigma[x][y] > 0)
-                            {
-                                actPixels[{x, y}] = par.max_Act;
-                                std::unordered_set<
-                                    std::array<int, 2>>::const_iterator it =
-                                    (alivePixels.find({x, y}));
-                                if (it == alivePixels.end())
-                                {
-                                    alivePixels.insert({x, y});
-                                }
-                            }
+                            if (sigma(x, y) > 0)
+                                act_pixels.SetAlive(x, y, par.max_Act);
                             else
-                            {
-                                std::unordered_set<
-                                    std::array<int, 2>>::const_iterator it =
-                                    (alivePixels.find({x, y}));
-                                if (it != alivePixels.end())
-                                {
-                                    alivePixels.erase({x, y});
-                                }
-                                std::unordered_map<std::array<int, 2>,
-                                                   int>::const_iterator ap =
-                                    (actPixels.find({x, y}));
-                                if (ap != actPixels.end())
-                                {
-                                    actPixels.erase({x, y});
-                                }
-                            }
+                                act_pixels.Kill(x, y);
                         }
                         // Update adhesive areas
                         if (kp == 0)
@@ -708,7 +759,7 @@ int CellularPotts::Act_AmoebaeMove(PDE *PDEfield)
                         if (par.lambda_matrix > 0)
                         {
                             // Update matrix interaction field
-                            if (sigma[x][y] > 0)
+                            if (sigma(x, y) > 0)
                             {
                                 // matrixPixels[{x,y}]=0;
                                 matrix[x][y] = 0;
@@ -724,6 +775,7 @@ int CellularPotts::Act_AmoebaeMove(PDE *PDEfield)
             }
         }
     }
+    ClearHalo();
     return SumDH;
 }
 
@@ -735,8 +787,8 @@ int CellularPotts::Act_DeltaH(int x, int y, int xp, int yp, PDE *PDEfield)
 
     /* Compute energydifference *IF* the copying were to occur */
     int DH_adhesive_energy = 0;
-    sxy = sigma[x][y];
-    sxyp = sigma[xp][yp];
+    sxy = sigma(x, y);
+    sxyp = sigma(xp, yp);
     if (sxyp <= -1)
     {
         sxyp = 0;
@@ -744,38 +796,15 @@ int CellularPotts::Act_DeltaH(int x, int y, int xp, int yp, PDE *PDEfield)
 
     /* DH due to cell adhesion */
     // also compute changes in neighbours for alignment with newneighbours
-    std::vector<int> xy_neighbour_changes(cell->size(), 0);
-    std::vector<int> xyp_neighbour_changes(cell->size(), 0);
+    xy_neighbour_changes.Reset(cell->size());
+    xyp_neighbour_changes.Reset(cell->size());
     for (i = 1; i <= n_nb; i++)
     {
         int xp2, yp2;
         xp2 = x + nx[i];
         yp2 = y + ny[i];
-        if (par.periodic_boundaries)
-        {
-
-            // since we are asynchronic, we cannot just copy the borders once
-            // every MCS
-
-            if (xp2 <= 0)
-                xp2 = sizex - 2 + xp2;
-            if (yp2 <= 0)
-                yp2 = sizey - 2 + yp2;
-            if (xp2 >= sizex - 1)
-                xp2 = xp2 - sizex + 2;
-            if (yp2 >= sizey - 1)
-                yp2 = yp2 - sizey + 2;
-
-            neighsite = sigma[xp2][yp2];
-        }
-        else
-        {
-
-            if (xp2 <= 0 || yp2 <= 0 || xp2 >= sizex - 1 || yp2 >= sizey - 1)
-                neighsite = -1;
-            else
-                neighsite = sigma[xp2][yp2];
-        }
+        // the halo holds border sites or periodic images
+        neighsite = sigma(xp2, yp2);
         if (neighsite == -1)
         { // border
             DH_adhesive_energy += (sxyp == 0 ? 0 : par.border_energy) -
@@ -789,9 +818,9 @@ int CellularPotts::Act_DeltaH(int x, int y, int xp, int yp, PDE *PDEfield)
             if ((i <= 4) | par.extended_neighbour_border)
             {
                 if (neighsite != sxy)
-                    xy_neighbour_changes[neighsite] -= 1;
+                    xy_neighbour_changes.Add(neighsite, -1);
                 if (neighsite != sxyp)
-                    xyp_neighbour_changes[neighsite] += 1;
+                    xyp_neighbour_changes.Add(neighsite, 1);
             }
         }
     }
@@ -877,9 +906,9 @@ int CellularPotts::Act_DeltaH(int x, int y, int xp, int yp, PDE *PDEfield)
         // only chemotactic extensions contribute to energy change
         if (!(par.extensiononly && sxyp == 0))
         {
-            DDH =
-                (int)(par.chemotaxis * (sat(PDEfield->get_PDEvars(0, x, y)) -
-                                        sat(PDEfield->get_PDEvars(0, xp, yp))));
+            DDH = (int)-DeltaH::chemotaxis(
+                x, y, xp, yp, PDEfield->GetChemotaxisPotential(),
+                (*cell)[sxyp > 0 ? sxyp : sxy].tau);
 
             DH -= DDH;
         }
@@ -933,15 +962,15 @@ int CellularPotts::Act_DeltaH(int x, int y, int xp, int yp, PDE *PDEfield)
             for (int i2 = -1; i2 <= 1; i2++)
             {
 
-                if (sigma[xp + i1][yp + i2] >= 0 &&
-                    sigma[xp + i1][yp + i2] == sigma[xp][yp])
+                if (sigma(xp + i1, yp + i2) >= 0 &&
+                    sigma(xp + i1, yp + i2) == sigma(xp, yp))
                 {
                     Act_expanding *= GetActLevel(xp + i1, yp + i2);
                     nxp++;
                 }
 
-                if (sigma[x + i1][y + i2] >= 0 &&
-                    sigma[x + i1][y + i2] == sigma[x][y])
+                if (sigma(x + i1, y + i2) >= 0 &&
+                    sigma(x + i1, y + i2) == sigma(x, y))
                 {
                     Act_retracting *= GetActLevel(x + i1, y + i2);
                     nret++;
@@ -1013,10 +1042,12 @@ int CellularPotts::Act_DeltaH(int x, int y, int xp, int yp, PDE *PDEfield)
 void CellularPotts::ConvertSpin(int x, int y, int xp, int yp)
 {
     int tmpcell;
-    if ((tmpcell = sigma[x][y]))
+    if ((tmpcell = sigma(x, y)))
     { // if tmpcell is not MEDIUM
         (*cell)[tmpcell].DecrementArea();
         (*cell)[tmpcell].RemoveSiteFromMoments(x, y);
+        if (hot_cells.Live())
+            hot_cells.RemoveSite(tmpcell, x, y);
         (*cell)[tmpcell].SetPerimeter(
             GetNewPerimeterIfXYWereRemoved(tmpcell, x, y));
         if (!(*cell)[tmpcell].Area())
@@ -1025,47 +1056,63 @@ void CellularPotts::ConvertSpin(int x, int y, int xp, int yp)
         }
     }
 
-    if ((tmpcell = sigma[xp][yp]))
+    if ((tmpcell = sigma(xp, yp)))
     { // if tmpcell is not MEDIUM
         (*cell)[tmpcell].IncrementArea();
         (*cell)[tmpcell].AddSiteToMoments(x, y);
+        if (hot_cells.Live())
+            hot_cells.AddSite(tmpcell, x, y);
         (*cell)[tmpcell].SetPerimeter(
             GetNewPerimeterIfXYWereAdded(tmpcell, x, y));
     }
-    sigma[x][y] = sigma[xp][yp];
+    const int old_spin = sigma(x, y);
+    sigma(x, y) = sigma(xp, yp);
+    if (halo_filled)
+        UpdateHaloImages(x, y);
+    UpdateSpinIndices(x, y, old_spin);
 }
 
 void CellularPotts::ExchangeSpin(int x, int y, int xp, int yp)
 {
     int tmpcell;
-    if ((tmpcell = sigma[x][y]))
+    if ((tmpcell = sigma(x, y)))
     { // if tmpcell is not MEDIUM
         //(*cell)[tmpcell].DecrementArea();
         (*cell)[tmpcell].RemoveSiteFromMoments(x, y);
     }
 
-    if ((tmpcell = sigma[xp][yp]))
+    if ((tmpcell = sigma(xp, yp)))
     { // if tmpcell is not MEDIUM
         //(*cell)[tmpcell].DecrementArea();
         (*cell)[tmpcell].RemoveSiteFromMoments(x, y);
     }
 
-    if ((tmpcell = sigma[x][y]))
+    if ((tmpcell = sigma(x, y)))
     { // if tmpcell is not MEDIUM
         //(*cell)[tmpcell].IncrementArea();
         (*cell)[tmpcell].AddSiteToMoments(x, y);
     }
 
-    if ((tmpcell = sigma[xp][yp]))
+    if ((tmpcell = sigma(xp, yp)))
     { // if tmpcell is not MEDIUM
         //(*cell)[tmpcell].IncrementArea();
         (*cell)[tmpcell].AddSiteToMoments(x, y);
     }
 
     // Exchange spins
-    tmpcell = sigma[x][y];
-    sigma[x][y] = sigma[xp][yp];
-    sigma[xp][yp] = tmpcell;
+    tmpcell = sigma(x, y);
+    sigma(x, y) = sigma(xp, yp);
+    UpdateSpinIndices(x, y, tmpcell);
+    sigma(xp, yp) = tmpcell;
+    UpdateSpinIndices(xp, yp, sigma(x, y));
+}
+
+void CellularPotts::UpdateSpinIndices(int x, int y, int old_spin)
+{
+    if (cell_pixels.Live())
+        cell_pixels.Update(sigma, x, y, old_spin);
+    if (contact_graph.Live())
+        contact_graph.Update(sigma, x, y, old_spin);
 }
 
 /** PUBLIC **/
@@ -1090,6 +1137,37 @@ int CellularPotts::CopyvProb(int DH, double stiff, bool anneal)
         return 0;
 }
 
+int CellularPotts::CopyvProb(int DH, double stiff, bool anneal, double u)
+{
+    double dd;
+    int s;
+    s = (int)stiff;
+    if (DH <= -s)
+        return 2;
+    if (anneal)
+        return 0;
+    if (DH + s > BOLTZMANN - 1)
+        dd = exp(-((double)(DH + s) / par.T));
+    else
+        dd = copyprob[DH + s];
+
+    if (u < dd)
+        return 1;
+    else
+        return 0;
+}
+
+double CellularPotts::CopyProbability(int DH, bool anneal) const
+{
+    if (DH <= 0)
+        return 1.0;
+    if (anneal)
+        return 0.0;
+    if (DH > BOLTZMANN - 1)
+        return exp(-((double)DH / par.T));
+    return copyprob[DH];
+}
+
 void CellularPotts::CopyProb(double T)
 {
     int i;
@@ -1108,133 +1186,244 @@ void CellularPotts::FreezeAmoebae(void)
 //! Monte Carlo Step. Returns summed energy change
 int CellularPotts::AmoebaeMove(PDE *PDEfield, bool anneal)
 {
-    int p;
-    float loop;
-    thetime++;
-    int SumDH = 0;
+    auto start = std::chrono::steady_clock::now();
+    int SumDH;
+    if (par.cell_compaction_interval > 0 &&
+        thetime % par.cell_compaction_interval == 0)
+        CompactCells();
+    FillHalo();
+    hot_cells.Refresh(*cell);
+    if (energy_live)
+        SyncCellEnergy();
+    if (PDEfield)
+    {
+        // bring the chemotactic potential up to date here, rather than from
+        // the first copy attempt, which may be on any thread
+        if (!par.chemotaxis_strengths.empty() &&
+            (int)par.chemotaxis_strengths.size() / par.n_chem <=
+                Cell::MaxTau())
+            throw std::runtime_error(
+                "CellularPotts::AmoebaeMove(): chemotaxis_strengths has no"
+                " row for cell type " +
+                std::to_string(Cell::MaxTau()));
+        PDEfield->GetChemotaxisPotential();
+    }
+    if (par.cpm_update_scheme == "checkerboard")
+        SumDH = CheckerboardAmoebaeMove(PDEfield, anneal);
+    else
+        SumDH = (this->*edge_list_move)(PDEfield, anneal);
+    if (par.connectivity_check_interval > 0 &&
+        thetime % par.connectivity_check_interval == 0)
+        CheckConnectivity();
+    if (energy_live && par.energy_check_interval > 0 &&
+        thetime % par.energy_check_interval == 0)
+        CheckEnergy();
+    hot_cells.Stop();
+    ClearHalo();
+
+    if (par.mcs_rate_report_interval > 0)
+        ReportMCSRate(std::chrono::steady_clock::now() - start);
+    return SumDH;
+}
 
-    int positionedge;
-    int targetedge;
-    int targetsite;
-    int targetneighbour;
-    int x, y;
-    int xp, yp;
+int CellularPotts::CompactCells()
+{
+    const int n_cells = cell->size();
+    cell_id_mapping.assign(n_cells, -1);
+    int n_kept = 0;
+    for (int c = 0; c < n_cells; c++)
+    {
+        const Cell &cl = (*cell)[c];
+        if (c == 0 || cl.AliveP() || cl.Area() > 0)
+            cell_id_mapping[c] = n_kept++;
+    }
+    if (n_kept == n_cells)
+        return 0;
 
-    int H_diss;
-    int D_H;
+    // Renumbering moves no pixels, so the energy totals carry over, except
+    // for the area terms of the removed cells
+    const bool energy_was_live = energy_live;
+    InvalidateSpinIndices();
+    for (int x = 0; x < sizex; x++)
+        for (int y = 0; y < sizey; y++)
+            if (sigma(x, y) > 0)
+                sigma(x, y) = cell_id_mapping[sigma(x, y)];
 
-    int edgeadjusting;
-    int xn, yn; // neighbour cells
+    cell->Compact(cell_id_mapping);
+    auto new_id = [this](int id) {
+        return (id > 0 && cell_id_mapping[id] != -1) ? cell_id_mapping[id] : 0;
+    };
+    for (int c = 0; c < n_kept; c++)
+    {
+        Cell &cl = (*cell)[c];
+        cl.sigma = c;
+        cl.mother = new_id(cl.mother);
+        cl.daughter = new_id(cl.daughter);
+    }
+    Cell::maxsigma = n_kept;
+    history.remap(cell_id_mapping);
+    if (energy_was_live)
+    {
+        const int n_typed = std::min<int>(n_cells, energy_tau.size());
+        for (int c = 0; c < n_typed; c++)
+            if (cell_id_mapping[c] != -1)
+                energy_tau[cell_id_mapping[c]] = energy_tau[c];
+        energy_tau.resize(n_kept);
+        energy_live = true;
+        SyncCellEnergy();
+    }
+    return n_cells - n_kept;
+}
 
-    if (frozen)
-        return 0;
+void CellularPotts::CheckConnectivity() const
+{
+    auto fragmented = Connectivity::FragmentedCells(
+        sigma, sizex, sizey, par.periodic_boundaries);
+    if (fragmented.empty())
+        return;
 
-    loop = static_cast<float>(sizeedgelist) / static_cast<float>(n_nb);
-    for (int i = 0; i < loop; i++)
+    std::string cells;
+    for (int c : fragmented)
+        cells += " " + std::to_string(c);
+    throw std::runtime_error("CellularPotts::CheckConnectivity(): cells in "
+                             "more than one piece at MCS " +
+                             std::to_string(thetime) + ":" + cells);
+}
+
+int CellularPotts::NeighbourSpin(int x, int y, int i) const
+{
+    int xn = x + nx[i];
+    int yn = y + ny[i];
+    if (par.periodic_boundaries)
     {
-        // take a random entry of the edgelist
-        positionedge = (int)(RANDOM() * sizeedgelist);
-        // find the corresponding edge
-        targetedge = orderedgelist[positionedge];
-        // find the lattice site corresponding to this edge
-        targetsite = targetedge / n_nb;
-        // find the neighbour corresponding to this edge
-        targetneighbour = (targetedge % n_nb) + 1;
-
-        // find the x and y coordinate corresponding to the target site
-        x = targetsite % (sizex - 2) + 1;
-        y = targetsite / (sizex - 2) + 1;
-
-        // find the neighbouring site corresponding to this edge
-        xp = nx[targetneighbour] + x;
-        yp = ny[targetneighbour] + y;
-        if (par.periodic_boundaries)
-        {
-            // since we are asynchronic, we cannot just copy the borders once
-            // every MCS
-            if (xp <= 0)
-                xp = sizex - 2 + xp;
-            if (yp <= 0)
-                yp = sizey - 2 + yp;
-            if (xp >= sizex - 1)
-                xp = xp - sizex + 2;
-            if (yp >= sizey - 1)
-                yp = yp - sizey + 2;
-        }
-        if (not(LocalConnectedness(x, y, sigma[x][y]) &&
-                LocalConnectedness(x, y, sigma[xp][yp])))
-        {
-            continue;
-        }
+        const int w = sizex - 2, h = sizey - 2;
+        xn = (xn - 1 + w) % w + 1;
+        yn = (yn - 1 + h) % h + 1;
+    }
+    else if (xn < 1 || yn < 1 || xn > sizex - 2 || yn > sizey - 2)
+        return -1;
+    return sigma(xn, yn);
+}
 
-        //    // connectivity dissipation:
-        H_diss=0;
-        //    if (!ConnectivityPreservedP(x,y))
-        //      H_diss=par.conn_diss;
+double CellularPotts::SiteContactEnergy(int x, int y, int spin) const
+{
+    double e = 0.0;
+    for (int i = 1; i <= n_nb; i++)
+    {
+        const int neighsite = NeighbourSpin(x, y, i);
+        if (neighsite == -1)
+            e += (spin == 0 ? 0 : par.border_energy);
+        else if (neighsite != spin)
+            e += Cell::J[(*cell)[spin].tau][(*cell)[neighsite].tau];
+    }
+    return e;
+}
 
-        AdhesionDisplacements adh_disp;
-        D_H = DeltaH(x, y, xp, yp, PDEfield, &adh_disp);
+void CellularPotts::MeasureCellEnergy(EnergyTerms &e) const
+{
+    const double Ah = par.non_intergrin_binding_area;
+    for (int c = 1; c < (int)cell->size(); c++)
+    {
+        const Cell &cl = (*cell)[c];
+        const int area = cl.Area();
+        e.area += par.lambda * sqr(area - cl.target_area);
+        // a cell without pixels has no length
+        if (area > 0)
+        {
+            e.length += par.lambda2 *
+                        DSQR(cl.fit_ellipse.length() - cl.target_length);
+            e.spreading -= par.lambda_spread * area / (area + Ah);
+        }
+    }
+}
 
-        if ((p = CopyvProb(D_H, H_diss, anneal)) > 0)
+EnergyTerms CellularPotts::MeasureEnergy() const
+{
+    EnergyTerms e;
+    // pairs of cells are seen from both sides, the border from one
+    for (int x = 1; x < sizex - 1; x++)
+        for (int y = 1; y < sizey - 1; y++)
         {
-            if (par.adhesions_enabled)
+            const int spin = sigma(x, y);
+            if (spin == -1)
+                continue;
+            for (int i = 1; i <= n_nb; i++)
             {
-                adhesion_mover.commit_move({xp, yp}, {x, y}, adh_disp);
+                const int neighsite = NeighbourSpin(x, y, i);
+                if (neighsite == -1)
+                    e.adhesion += (spin == 0 ? 0 : par.border_energy);
+                else if (neighsite != spin)
+                    e.adhesion +=
+                        0.5 * Cell::J[(*cell)[spin].tau][(*cell)[neighsite].tau];
             }
-            ACT::commit_move(act_field, sigma, {xp, yp}, {x, y});
-            if (sigma[xp][yp] != 0)
-                history.add_extension({x, y}, sigma[xp][yp]);
-            ConvertSpin(
-                x, y, xp,
-                yp); // sigma(x,y) will get the same value as sigma(xp,yp)
-            for (int j = 1; j <= n_nb; j++)
-            {
-                xn = nx[j] + x;
-                yn = ny[j] + y;
-                edgeadjusting = targetsite * n_nb + j - 1;
-
-                if (par.periodic_boundaries)
-                {
-                    // since we are asynchronic, we cannot just copy the borders
-                    // once every MCS
-                    if (xn <= 0)
-                        xn = sizex - 2 + xn;
-                    if (yn <= 0)
-                        yn = sizey - 2 + yn;
-                    if (xn >= sizex - 1)
-                        xn = xn - sizex + 2;
-                    if (yn >= sizey - 1)
-                        yn = yn - sizey + 2;
-                }
-                if (xn > 0 && yn > 0 && xn < sizex - 1 && yn < sizey - 1)
-                { // if the neighbour site is within the lattice
-                    if (edgelist[edgeadjusting] == -1 &&
-                        sigma[xn][yn] != sigma[x][y] &&
-                        sigma[xn][yn] != -1)
-                    {
-                        // if there should be an edge between (x,y) and (xn,yn)
-                        // and it is not there yet, add it
-                        AddEdgeToEdgelist(edgeadjusting);
-                        // adjust loop because two edges were removeed
-                        loop += 2.0 / n_nb;
-                    }
-                    if (edgelist[edgeadjusting] != -1 &&
-                        (sigma[xn][yn] == sigma[x][y] || sigma[xn][yn] == -1)) 
-                    {
-                        // if there should be no edge between (x,y) and (xn,yn),
-                        // but there is an edge remove it
-                        RemoveEdgeFromEdgelist(edgeadjusting);
-                        // adjust loop because two edges were removed
-                        loop -= 2.0 / n_nb;
-                    }
-                }
-            }
-            SumDH += D_H;
         }
+
+    MeasureCellEnergy(e);
+    return e;
+}
+
+const EnergyTerms &CellularPotts::Energy() const
+{
+    if (!energy_live)
+    {
+        const EnergyTerms measured = MeasureEnergy();
+        energy.adhesion = measured.adhesion;
+        energy.area = measured.area;
+        energy.length = measured.length;
+        energy.spreading = measured.spreading;
+        energy_tau.resize(cell->size());
+        for (int c = 0; c < (int)cell->size(); c++)
+            energy_tau[c] = (*cell)[c].tau;
+        energy_live = true;
     }
-    history.validate(sigma);
-    act_field.Decrease();
-    return SumDH;
+    return energy;
+}
+
+void CellularPotts::SyncCellEnergy()
+{
+    const int n = cell->size();
+    bool retyped = false;
+    for (int c = 0; c < n && c < (int)energy_tau.size(); c++)
+        retyped = retyped || energy_tau[c] != (*cell)[c].tau;
+    if (retyped)
+    {
+        energy_live = false;
+        Energy();
+        return;
+    }
+    energy_tau.resize(n);
+    for (int c = 0; c < n; c++)
+        energy_tau[c] = (*cell)[c].tau;
+
+    EnergyTerms e;
+    MeasureCellEnergy(e);
+    energy.area = e.area;
+    energy.length = e.length;
+    energy.spreading = e.spreading;
+}
+
+double CellularPotts::CheckEnergy()
+{
+    const EnergyTerms measured = MeasureEnergy();
+    const std::pair<const char *, double EnergyTerms::*> terms[] = {
+        {"adhesion", &EnergyTerms::adhesion},
+        {"area", &EnergyTerms::area},
+        {"length", &EnergyTerms::length},
+        {"spreading", &EnergyTerms::spreading}};
+    double worst = 0.0;
+    for (const auto &term : terms)
+    {
+        const double kept = energy.*term.second;
+        const double actual = measured.*term.second;
+        const double drift = std::abs(kept - actual);
+        worst = std::max(worst, drift);
+        if (drift > 1e-6 * std::max(1.0, std::abs(actual)))
+            cerr << "CellularPotts::CheckEnergy(): at MCS " << thetime
+                 << " the " << term.first << " energy was kept as " << kept
+                 << " but is " << actual << endl;
+        energy.*term.second = actual;
+    }
+    return worst;
 }
 
 CellECMInteractions CellularPotts::GetCellECMInteractions() const
@@ -1262,7 +1451,7 @@ void CellularPotts::PlotSigma(Graphics *g, int mag)
         {
             for (int xm = 0; xm < mag; xm++)
                 for (int ym = 0; ym < mag; ym++)
-                    g->Point(sigma[x][y], mag * x + xm, mag * y + ym);
+                    g->Point(sigma(x, y), mag * x + xm, mag * y + ym);
         }
 }
 
@@ -1274,144 +1463,61 @@ void CellularPotts::PlotIsing(Graphics *g, int mag)
         {
             for (int xm = 0; xm < mag; xm++)
                 for (int ym = 0; ym < mag; ym++)
-                    g->Point(sigma[x][y] == 0 ? 0 : 1, mag * x + xm,
+                    g->Point(sigma(x, y) == 0 ? 0 : 1, mag * x + xm,
                              mag * y + ym);
         }
 }
 
-int **CellularPotts::SearchNandPlot(Graphics *g, bool get_neighbours)
+void CellularPotts::SearchNandPlot(Graphics *g)
 {
-    int i, j, q;
-    int **neighbours = 0;
-
-    /* Allocate neighbour matrix */
-    if (get_neighbours)
-    {
-        neighbours = (int **)malloc((cell->size() + 1) * sizeof(int *));
-        if (neighbours == NULL)
-            MemoryWarning();
-
-        neighbours[0] = (int *)malloc((cell->size() + 1) * (cell->size() + 1) *
-                                      sizeof(int));
-        if (neighbours[0] == NULL)
-            MemoryWarning();
-
-        for (i = 1; i < (int)cell->size() + 1; i++)
-            neighbours[i] = neighbours[i - 1] + (cell->size() + 1);
-
-        /* Clear this matrix */
-        for (i = 0; i < ((int)cell->size() + 1) * ((int)cell->size() + 1); i++)
-            neighbours[0][i] = EMPTY;
-    }
+    int i, j;
 
     for (i = 0; i < sizex - 1; i++)
         for (j = 0; j < sizey - 1; j++)
         {
             int colour;
-            if (sigma[i][j] <= 0)
+            if (sigma(i, j) <= 0)
             {
                 colour = 0;
             }
             else
             {
-                colour = (*cell)[sigma[i][j]].Colour();
-                // colour = sigma[i][j];
+                colour = (*cell)[sigma(i, j)].Colour();
+                // colour = sigma(i, j);
             }
 
-            if (g && sigma[i][j] > 0) /* if draw */
+            if (g && sigma(i, j) > 0) /* if draw */
                 g->Point(colour, i, j);
 
-            if (sigma[i][j] !=
-                sigma[i + 1][j]) /* if cellborder */ /* etc. etc. */
+            if (sigma(i, j) !=
+                sigma(i + 1, j)) /* if cellborder */ /* etc. etc. */
             {
                 if (g)
                     g->Point(1, i + 1, j);
-                if (get_neighbours)
-                {
-                    if (sigma[i][j] > 0)
-                    {
-                        for (q = 0; q < (int)cell->size(); q++)
-                            if (neighbours[sigma[i][j]][q] == EMPTY)
-                            {
-                                neighbours[sigma[i][j]][q] = sigma[i + 1][j];
-                                break;
-                            }
-                            else if (neighbours[sigma[i][j]][q] ==
-                                     sigma[i + 1][j])
-                                break;
-                    }
-                    if (sigma[i + 1][j] > 0)
-                    {
-                        for (q = 0; q < (int)cell->size(); q++)
-                            if (neighbours[sigma[i + 1][j]][q] == EMPTY)
-                            {
-                                neighbours[sigma[i + 1][j]][q] = sigma[i][j];
-                                break;
-                            }
-                            else if (neighbours[sigma[i + 1][j]][q] ==
-                                     sigma[i][j])
-                                break;
-                    }
-                }
             }
-            else if (g && sigma[i][j] > 0)
+            else if (g && sigma(i, j) > 0)
                 g->Point(colour, i + 1, j);
 
-            if (sigma[i][j] != sigma[i][j + 1])
+            if (sigma(i, j) != sigma(i, j + 1))
             {
 
                 if (g)
                     g->Point(1, i, j + 1);
-
-                if (get_neighbours)
-                {
-                    if (sigma[i][j] > 0)
-                    {
-                        for (q = 0; q < (int)cell->size(); q++)
-                            if (neighbours[sigma[i][j]][q] == EMPTY)
-                            {
-                                neighbours[sigma[i][j]][q] = sigma[i][j + 1];
-                                break;
-                            }
-                            else if (neighbours[sigma[i][j]][q] ==
-                                     sigma[i][j + 1])
-                                break;
-                    }
-
-                    if (sigma[i][j + 1] > 0)
-                    {
-
-                        for (q = 0; q < (int)cell->size(); q++)
-                            if (neighbours[sigma[i][j + 1]][q] == EMPTY)
-                            {
-                                neighbours[sigma[i][j + 1]][q] = sigma[i][j];
-                                break;
-                            }
-                            else if (neighbours[sigma[i][j + 1]][q] ==
-                                     sigma[i][j])
-                                break;
-                    }
-                }
             }
-            else if (g && sigma[i][j] > 0)
+            else if (g && sigma(i, j) > 0)
                 g->Point(colour, i, j + 1);
 
             /* Cells that touch eachother's corners are NO neighbours */
 
-            if (sigma[i][j] != sigma[i + 1][j + 1] ||
-                sigma[i + 1][j] != sigma[i][j + 1])
+            if (sigma(i, j) != sigma(i + 1, j + 1) ||
+                sigma(i + 1, j) != sigma(i, j + 1))
             {
                 if (g)
                     g->Point(1, i + 1, j + 1);
             }
-            else if (g && sigma[i][j] > 0)
+            else if (g && sigma(i, j) > 0)
                 g->Point(colour, i + 1, j + 1);
         }
-
-    if (get_neighbours)
-        return neighbours;
-    else
-        return 0;
 }
 
 void CellularPotts::SearchNandPlotClear(Graphics *g)
@@ -1421,19 +1527,19 @@ void CellularPotts::SearchNandPlotClear(Graphics *g)
         for (int j = 0; j < sizey - 1; j++)
         {
             /* if cellborder */ /* etc. etc. */
-            if (sigma[i][j] != sigma[i + 1][j])
+            if (sigma(i, j) != sigma(i + 1, j))
             {
                 if (g)
                     g->Point(1, i + 1, j);
             }
-            if (sigma[i][j] != sigma[i][j + 1])
+            if (sigma(i, j) != sigma(i, j + 1))
             {
                 if (g)
                     g->Point(1, i, j + 1);
             }
             /* Cells that touch eachother's corners are NO neighbours */
-            if (sigma[i][j] != sigma[i + 1][j + 1] ||
-                sigma[i + 1][j] != sigma[i][j + 1])
+            if (sigma(i, j) != sigma(i + 1, j + 1) ||
+                sigma(i + 1, j) != sigma(i, j + 1))
             {
                 if (g)
                     g->Point(1, i + 1, j + 1);
@@ -1483,27 +1589,27 @@ int **CellularPotts::SearchNeighboursMatrix()
                 }
 
                 /* if cellborder */ /* etc. etc. */
-                if (sigma[i][j] != sigma[i + 1][j])
+                if (sigma(i, j) != sigma(i + 1, j))
                 {
-                    neighbours[sigma[i][j]][sigma[iplus][j]] += 1;
-                    neighbours[sigma[iplus][j]][sigma[i][j]] += 1;
+                    neighbours[sigma(i, j)][sigma(iplus, j)] += 1;
+                    neighbours[sigma(iplus, j)][sigma(i, j)] += 1;
                 }
-                if (sigma[i][j] != sigma[i][j + 1])
+                if (sigma(i, j) != sigma(i, j + 1))
                 {
-                    neighbours[sigma[i][j]][sigma[i][jplus]] += 1;
-                    neighbours[sigma[i][jplus]][sigma[i][j]] += 1;
+                    neighbours[sigma(i, j)][sigma(i, jplus)] += 1;
+                    neighbours[sigma(i, jplus)][sigma(i, j)] += 1;
                 }
                 // if extended_neighbour_border is true, also count cells
                 // touching by a corner.
                 if (par.extended_neighbour_border)
                 {
-                    if (sigma[i][j] != sigma[i + 1][j + 1])
+                    if (sigma(i, j) != sigma(i + 1, j + 1))
                     {
-                        neighbours[sigma[i][j]][sigma[iplus][jplus]] += 1;
+                        neighbours[sigma(i, j)][sigma(iplus, jplus)] += 1;
                     }
-                    if (sigma[i + 1][j] != sigma[i][j + 1])
+                    if (sigma(i + 1, j) != sigma(i, j + 1))
                     {
-                        neighbours[sigma[iplus][j]][sigma[i][jplus]] += 1;
+                        neighbours[sigma(iplus, j)][sigma(i, jplus)] += 1;
                     }
                 }
             }
@@ -1534,19 +1640,7 @@ int CellularPotts::GetNewPerimeterIfXYWereAdded(int sxyp, int x, int y)
         xp2 = x + nx[i];
         yp2 = y + ny[i];
 
-        if (par.periodic_boundaries)
-        {
-
-            if (xp2 <= 0)
-                xp2 = sizex - 2 + xp2;
-            if (yp2 <= 0)
-                yp2 = sizey - 2 + yp2;
-            if (xp2 >= sizex - 1)
-                xp2 = xp2 - sizex + 2;
-            if (yp2 >= sizey - 1)
-                yp2 = yp2 - sizey + 2;
-        }
-        if (sigma[xp2][yp2] == sxyp)
+        if (sigma(xp2, yp2) == sxyp)
         {
             perim--;
         }
@@ -1573,19 +1667,7 @@ int CellularPotts::GetNewPerimeterIfXYWereRemoved(int sxy, int x, int y)
         int xp2, yp2;
         xp2 = x + nx[i];
         yp2 = y + ny[i];
-        if (par.periodic_boundaries)
-        {
-
-            if (xp2 <= 0)
-                xp2 = sizex - 2 + xp2;
-            if (yp2 <= 0)
-                yp2 = sizey - 2 + yp2;
-            if (xp2 >= sizex - 1)
-                xp2 = xp2 - sizex + 2;
-            if (yp2 >= sizey - 1)
-                yp2 = yp2 - sizey + 2;
-        }
-        if (sigma[xp2][yp2] == sxy)
+        if (sigma(xp2, yp2) == sxy)
         {
             perim++;
         }
@@ -1599,8 +1681,8 @@ int CellularPotts::GetNewPerimeterIfXYWereRemoved(int sxy, int x, int y)
 
 int CellularPotts::GetActLevel(int x, int y)
 {
-    if (sigma[x][y] > 0)
-        return (actPixels[{x, y}]);
+    if (sigma(x, y) > 0)
+        return act_pixels.Level(x, y);
     else
         return (0);
 }
@@ -1620,6 +1702,7 @@ int CellularPotts::GetMatrixLevel(int x, int y)
 
 void CellularPotts::ReadZygotePicture(void)
 {
+    InvalidateSpinIndices();
     int pix, cells, i, j, c, p, checkx, checky;
     char **pixelmap;
     char pixel[3];
@@ -1654,8 +1737,9 @@ void CellularPotts::ReadZygotePicture(void)
         pixelmap[i][pix] = '\0';
     }
 
-    for (i = 0; i < sizex * sizey; i++)
-        sigma[0][i] = 0;
+    for (i = 0; i < sizex; i++)
+        for (j = 0; j < sizey; j++)
+            sigma(i, j) = 0;
     fprintf(stderr, "[%d %d]\n", checkx, checky);
 
     int offs_x, offs_y;
@@ -1674,12 +1758,12 @@ void CellularPotts::ReadZygotePicture(void)
             {
                 if (!(strcmp(pixelmap[c], pixel)))
                 {
-                    if ((sigma[offs_x + i][offs_y + j] = c))
+                    if ((sigma(offs_x + i, offs_y + j) = c))
                     {
 
                         // if c is _NOT_ medium (then c=0)
                         // assign pixel values from "sigmamax"
-                        sigma[offs_x + i][offs_y + j] += (Cell::MaxSigma() - 1);
+                        sigma(offs_x + i, offs_y + j) += (Cell::MaxSigma() - 1);
                     }
                 }
             }
@@ -1692,13 +1776,13 @@ void CellularPotts::ConstructInitCells(Dish &beast)
 {
 
     // Get the maximum cell ID (mostly equal to the cell number)
-    int loop = sizex * sizey;
     int cells = 0;
-    for (int i = 0; i < loop; i++)
-    {
-        if (cells < sigma[0][i])
-            cells = sigma[0][i];
-    }
+    for (int x = 0; x < sizex; x++)
+        for (int y = 0; y < sizey; y++)
+        {
+            if (cells < sigma(x, y))
+                cells = sigma(x, y);
+        }
 
     cerr << "[ cells = " << cells << "]\n";
 
@@ -1707,7 +1791,7 @@ void CellularPotts::ConstructInitCells(Dish &beast)
     {
         for (int i = 0; i < cells; i++)
         {
-            cell->push_back(Cell(beast));
+            cell->emplace_back(beast);
         }
     }
 
@@ -1718,7 +1802,7 @@ void CellularPotts::ConstructInitCells(Dish &beast)
 
     // set zygote_area to mean cell area.
     int mean_area = 0;
-    for (vector<Cell>::iterator c = cell->begin(); c != cell->end(); c++)
+    for (CellPool::iterator c = cell->begin(); c != cell->end(); c++)
     {
         mean_area += c->Area();
     }
@@ -1730,7 +1814,7 @@ void CellularPotts::ConstructInitCells(Dish &beast)
     cout << "mean_area = " << mean_area << "\n";
     // set all cell areas to the mean area
     {
-        for (vector<Cell>::iterator c = cell->begin(); c != cell->end(); c++)
+        for (CellPool::iterator c = cell->begin(); c != cell->end(); c++)
         {
             if (par.target_area >= 0)
             {
@@ -1747,7 +1831,7 @@ void CellularPotts::ConstructInitCells(Dish &beast)
 void CellularPotts::MeasureCellSizes(void)
 {
     // Clean areas of all cells, including medium
-    for (vector<Cell>::iterator c = cell->begin(); c != cell->end(); c++)
+    for (CellPool::iterator c = cell->begin(); c != cell->end(); c++)
     {
         c->SetTargetArea(0);
         c->area = 0;
@@ -1755,21 +1839,20 @@ void CellularPotts::MeasureCellSizes(void)
     }
 
     // calculate the area of the cells
-    for (int x = 1; x < sizex - 1; x++)
+    const CellPixels &pixels = GetCellPixels();
+    const int n_cells = std::min<int>(cell->size(), pixels.Cells());
+    for (int c = 1; c < n_cells; c++)
     {
-        for (int y = 1; y < sizey - 1; y++)
+        for (const auto &pixel : pixels.Pixels(c))
         {
-            if (sigma[x][y] > 0)
-            {
-                (*cell)[sigma[x][y]].IncrementTargetArea();
-                (*cell)[sigma[x][y]].IncrementArea();
-                (*cell)[sigma[x][y]].AddSiteToMoments(x, y);
-            }
+            (*cell)[c].IncrementTargetArea();
+            (*cell)[c].IncrementArea();
+            (*cell)[c].AddSiteToMoments(pixel[0], pixel[1]);
         }
     }
 
     // set the actual area to the target area
-    for (vector<Cell>::iterator c = cell->begin(); c != cell->end(); c++)
+    for (CellPool::iterator c = cell->begin(); c != cell->end(); c++)
     {
         c->SetAreaToTarget();
     }
@@ -1783,11 +1866,11 @@ void CellularPotts::MeasureCellSize(Cell &c)
     {
         for (int y = 1; y < sizey - 1; y++)
         {
-            if (sigma[x][y] == c.sigma)
+            if (sigma(x, y) == c.sigma)
             {
-                (*cell)[sigma[x][y]].IncrementTargetArea();
-                (*cell)[sigma[x][y]].IncrementArea();
-                (*cell)[sigma[x][y]].AddSiteToMoments(x, y);
+                (*cell)[sigma(x, y)].IncrementTargetArea();
+                (*cell)[sigma(x, y)].IncrementArea();
+                (*cell)[sigma(x, y)].AddSiteToMoments(x, y);
             }
         }
     }
@@ -1799,7 +1882,7 @@ void CellularPotts::MeasureCellPerimeters()
     {
         for (int y = 1; y < sizey - 1; y++)
         {
-            if (sigma[x][y] > 0)
+            if (sigma(x, y) > 0)
             {
                 for (int i = 1; i <= n_nb; i++)
                 {
@@ -1818,11 +1901,11 @@ void CellularPotts::MeasureCellPerimeters()
                             yp2 = yp2 - sizey + 2;
                     }
                     // did we find a border?
-                    if (sigma[xp2][yp2] != sigma[x][y])
+                    if (sigma(xp2, yp2) != sigma(x, y))
                     {
                         // add to the perimeter of the cell
-                        (*cell)[sigma[x][y]].IncrementTargetPerimeter();
-                        (*cell)[sigma[x][y]].IncrementPerimeter();
+                        (*cell)[sigma(x, y)].IncrementTargetPerimeter();
+                        (*cell)[sigma(x, y)].IncrementPerimeter();
                     }
                 }
             }
@@ -1871,7 +1954,7 @@ Dir *CellularPotts::FindCellDirections(void) const
     /* Find sumx, sumy, sumxx and sumxy for all cells */
     for (int x = 0; x < sizex; x++)
         for (int y = 0; y < sizey; y++)
-            if (sigma[x][y] > 0)
+            if (sigma(x, y) > 0)
             {
                 sumx[0] += (double)x;
                 sumy[0] += (double)y;
@@ -1881,14 +1964,14 @@ Dir *CellularPotts::FindCellDirections(void) const
 
                 n[0]++;
 
-                sumx[sigma[x][y]] += (double)x;
-                sumy[sigma[x][y]] += (double)y;
+                sumx[sigma(x, y)] += (double)x;
+                sumy[sigma(x, y)] += (double)y;
 
-                sumxx[sigma[x][y]] += (double)x * x;
-                sumxy[sigma[x][y]] += (double)x * y;
-                sumyy[sigma[x][y]] += (double)y * y;
+                sumxx[sigma(x, y)] += (double)x * x;
+                sumxy[sigma(x, y)] += (double)x * y;
+                sumyy[sigma(x, y)] += (double)y * y;
 
-                n[sigma[x][y]]++;
+                n[sigma(x, y)]++;
             }
 
     /* Compute the principal axes for all cells */
@@ -1954,17 +2037,33 @@ void CellularPotts::ShowDirections(Graphics &g, const Dir *celldir) const
                    (int)((celldir[i].aa1 + celldir[i].bb1 * sizey) * 2), 2);
 }
 
-void CellularPotts::DivideCells(vector<bool> which_cells, vector<Cell> &cells)
+void CellularPotts::DivideCells(vector<bool> which_cells, CellPool &cells)
 {
-    ::DivideCells(which_cells, cells,
-                  sigma); // The :: tells the compiler to look for a function
-                          // not in the class.
+    ::DivideCells(which_cells, cells, sigma, GetCellPixels(),
+                  [this](int x, int y, int old_spin) {
+                      UpdateSpinIndices(x, y, old_spin);
+                      if (energy_live)
+                      {
+                          const int spin = sigma(x, y);
+                          if (spin >= (int)energy_tau.size())
+                              energy_tau.resize(spin + 1);
+                          energy_tau[spin] = (*cell)[spin].tau;
+                          energy.adhesion += SiteContactEnergy(x, y, spin) -
+                                             SiteContactEnergy(x, y, old_spin);
+                      }
+                  }); // The :: tells the compiler to look for a function
+                      // not in the class.
+    if (energy_live)
+        SyncCellEnergy();
+    if (halo_filled)
+        FillHalo();
 }
 
 /**! Fill the plane with initial cells
  \return actual amount of cells (some are not draw due to overlap) */
 int CellularPotts::ThrowInCells(int n, int cellsize)
 {
+    InvalidateSpinIndices();
 
     //  int gapx=(sizex-nx*cellsize)/(nx+1);
     // int gapy=(sizey-ny*cellsize)/(ny+1);
@@ -1986,7 +2085,7 @@ int CellularPotts::ThrowInCells(int n, int cellsize)
                       (y - cellsize / 2) * (y - cellsize / 2)) <
                      ((cellsize / 2) * (cellsize / 2))) &&
                     (x0 + x < sizex && y0 + y < sizey))
-                    if (sigma[x0 + x][y0 + y])
+                    if (sigma(x0 + x, y0 + y))
                     {
                         overlap = true;
                         break;
@@ -2000,7 +2099,7 @@ int CellularPotts::ThrowInCells(int n, int cellsize)
                           (y - cellsize / 2) * (y - cellsize / 2)) <
                          ((cellsize / 2) * (cellsize / 2))) &&
                         (x0 + x < sizex && y0 + y < sizey))
-                        sigma[x0 + x][y0 + y] = cellnum;
+                        sigma(x0 + x, y0 + y) = cellnum;
             cellnum++;
         }
     }
@@ -2010,23 +2109,23 @@ int CellularPotts::ThrowInCells(int n, int cellsize)
     // fill borders with special border state
     for (int x = 0; x < sizex - 1; x++)
     {
-        sigma[x][0] = -1;
-        sigma[x][sizey - 1] = -1;
+        sigma(x, 0) = -1;
+        sigma(x, sizey - 1) = -1;
     }
     for (int y = 0; y < sizey - 1; y++)
     {
-        sigma[0][y] = -1;
-        sigma[sizex - 1][y] = -1;
+        sigma(0, y) = -1;
+        sigma(sizex - 1, y) = -1;
     }
     for (int x = 1; x < sizex - 2; x++)
     {
-        sigma[x][1] = 0;
-        sigma[x][sizey - 2] = 0;
+        sigma(x, 1) = 0;
+        sigma(x, sizey - 2) = 0;
     }
     for (int y = 1; y < sizey - 2; y++)
     {
-        sigma[1][y] = 0;
-        sigma[sizex - 2][y] = 0;
+        sigma(1, y) = 0;
+        sigma(sizex - 2, y) = 0;
     }
     return cellnum;
 }
@@ -2056,11 +2155,12 @@ int CellularPotts::GrowInCells(int n_cells, int cell_size, double subfield,
 
 void CellularPotts::RandomSpins(double prob)
 {
+    InvalidateSpinIndices();
     for (int x = 1; x <= sizex - 2; x++)
     {
         for (int y = 1; y < sizey - 2; y++)
         {
-            sigma[x][y] = (RANDOM() < prob) ? 0 : 1;
+            sigma(x, y) = (RANDOM() < prob) ? 0 : 1;
         }
     }
     cerr << "RandomSpins done" << endl;
@@ -2069,25 +2169,11 @@ void CellularPotts::RandomSpins(double prob)
 int CellularPotts::GrowInCells(int n_cells, int cell_size, int sx, int sy,
                                int offset_x, int offset_y)
 {
+    InvalidateSpinIndices();
 
     // make initial cells using Eden Growth
 
-    int **new_sigma = (int **)malloc(sizex * sizeof(int *));
-    if (new_sigma == NULL)
-        MemoryWarning();
-
-    new_sigma[0] = (int *)malloc(sizex * sizey * sizeof(int));
-    if (new_sigma[0] == NULL)
-        MemoryWarning();
-
-    for (int i = 1; i < sizex; i++)
-        new_sigma[i] = new_sigma[i - 1] + sizey;
-
-    /* Clear CA plane */
-    {
-        for (int i = 0; i < sizex * sizey; i++)
-            new_sigma[0][i] = 0;
-    }
+    SpinLattice new_sigma(sizex, sizey, 0, 0);
 
     // scatter initial points, or place a cell in the middle
     // if only one cell is desired
@@ -2100,14 +2186,15 @@ int CellularPotts::GrowInCells(int n_cells, int cell_size, int sx, int sy,
             for (int i = 0; i < n_cells; i++)
             {
 
-                sigma[RandomNumber(sx) + offset_x]
-                     [RandomNumber(sy) + offset_y] = ++cellnum;
+                const int x = RandomNumber(sx) + offset_x;
+                const int y = RandomNumber(sy) + offset_y;
+                sigma(x, y) = ++cellnum;
             }
         }
     }
     else
     {
-        sigma[sx][sy] = ++cellnum;
+        sigma(sx, sy) = ++cellnum;
     }
 
     // Do Eden growth for a number of time steps
@@ -2118,7 +2205,7 @@ int CellularPotts::GrowInCells(int n_cells, int cell_size, int sx, int sy,
                 for (int y = 1; y < sizey - 1; y++)
                 {
 
-                    if (sigma[x][y] == 0)
+                    if (sigma(x, y) == 0)
                     {
                         // take a random neighbour
                         int xyp = (int)(8 * RANDOM() + 1);
@@ -2128,17 +2215,17 @@ int CellularPotts::GrowInCells(int n_cells, int cell_size, int sx, int sy,
                         //  NB removing this border test yields interesting
                         //  effects :-)
                         // You get a ragged border, which you may like!
-                        if ((kp = sigma[xp][yp]) != -1)
+                        if ((kp = sigma(xp, yp)) != -1)
                             if (kp > (cellnum - n_cells))
-                                new_sigma[x][y] = kp;
+                                new_sigma(x, y) = kp;
                             else
-                                new_sigma[x][y] = 0;
+                                new_sigma(x, y) = 0;
                         else
-                            new_sigma[x][y] = 0;
+                            new_sigma(x, y) = 0;
                     }
                     else
                     {
-                        new_sigma[x][y] = sigma[x][y];
+                        new_sigma(x, y) = sigma(x, y);
                     }
                 }
 
@@ -2148,21 +2235,19 @@ int CellularPotts::GrowInCells(int n_cells, int cell_size, int sx, int sy,
                 {
                     for (int y = 1; y < sizey - 1; y++)
                     {
-                        sigma[x][y] = new_sigma[x][y];
+                        sigma(x, y) = new_sigma(x, y);
                     }
                 }
             }
         }
     }
-    free(new_sigma[0]);
-    free(new_sigma);
-
     return cellnum;
 }
 
 /** Draw a square cell in at (cx,cy) */
 int CellularPotts::SquareCell(int sig, int cx, int cy, int size)
 {
+    InvalidateSpinIndices();
     int xmin, xmax;
     xmin = cx - size / 2;
     if (xmin < 1)
@@ -2183,190 +2268,81 @@ int CellularPotts::SquareCell(int sig, int cx, int cy, int size)
     {
         for (int y = ymin; y <= ymax; y++)
         {
-            sigma[x][y] = sig;
+            sigma(x, y) = sig;
         }
     }
     return 1;
 }
 
+namespace
+{
+    // Whether the neighbours of (x,y) belong to at most two cells, and none
+    // of them to the medium. We need this heuristic to prevent stalling at
+    // cell-cell borders: the constraint is not enforced at an interface of
+    // two cells.
+    bool TwoCellInterface(const SpinLattice &sigma, int x, int y)
+    {
+        int cells[8];
+        int n_cells = 0;
+        for (int i = 0; i < 8; i++)
+        {
+            int s_nb =
+                sigma(x + Connectivity::ring_x[i], y + Connectivity::ring_y[i]);
+            if (s_nb == 0)
+                return false;
+            if (std::find(cells, cells + n_cells, s_nb) == cells + n_cells)
+                cells[n_cells++] = s_nb;
+        }
+        return n_cells <= 2;
+    }
+}
+
 // Predicate returns true when connectivity is locally preserved
 // if the value of the central site would be changed
 bool CellularPotts::ConnectivityPreservedP(int x, int y)
 {
-    // Use local nx and ny in a cyclic order (starts at upper left corner)
-    // first site is repeated, for easier looping
-    const int cyc_nx[10] = {-1, -1, 0, 1, 1, 1, 0, -1, -1, -1};
-    const int cyc_ny[10] = {0, -1, -1, -1, 0, 1, 1, 1, 0, -1};
-
-    int sxy = sigma[x][y]; // the central site
+    int sxy = sigma(x, y); // the central site
     if (sxy == 0)
         return true;
 
-    int n_borders =
-        0; // to count the amount of sites in state sxy bordering a site !=sxy
-
-    static int stack[8]; // stack to count number of different surrounding cells
-    int stackp = -1;
-    bool one_of_neighbours_medium = false;
-    for (int i = 1; i <= 8; i++)
-    {
-        int s_nb = sigma[x + cyc_nx[i]][y + cyc_ny[i]];
-        int s_next_nb = sigma[x + cyc_nx[i + 1]][y + cyc_ny[i + 1]];
-
-        if ((s_nb == sxy || s_next_nb == sxy) && (s_nb != s_next_nb))
-        {
-            // check whether s_nb is adjacent to non-identical site,
-            // count it
-            n_borders++;
-        }
-        int j;
-        bool on_stack_p = false;
-
-        // we need the next heuristic to prevent stalling at
-        // cell-cell borders
-        // do not enforce constraint at two cell interface(no medium)
-        if (s_nb)
-        {
-            for (j = stackp; j >= 0; j--)
-            {
-                if (s_nb == stack[j])
-                {
-                    on_stack_p = true;
-                    break;
-                }
-            }
-            if (!on_stack_p)
-            {
-                if (stackp > 6)
-                {
-                    cerr << "Stack overflow, stackp=" << stackp << "\n";
-                }
-                stack[++stackp] = s_nb;
-            }
-        }
-        else
-        {
-            one_of_neighbours_medium = true;
-        }
-    }
-
-    // number of different neighbours is stackp+1;
-    if (n_borders > 2 && ((stackp + 1) > 2 || one_of_neighbours_medium))
-    {
-        return false;
-    }
-    else
+    // count the sites in state sxy bordering a site != sxy
+    unsigned mask = Connectivity::SameSpinMask(sigma, x, y, sxy);
+    if (Connectivity::border_count[mask] <= 2)
         return true;
+    return TwoCellInterface(sigma, x, y);
 }
 
 // Predicate returns true when cluster connectivity is locally preserved
 // if the value of the central site would be changed
 bool CellularPotts::ConnectivityPreservedPCluster(int x, int y)
 {
-
-    // Use local nx and ny in a cyclic order (starts at upper left corner)
-    // first site is repeated, for easier looping
-    const int cyc_nx[10] = {-1, -1, 0, 1, 1, 1, 0, -1, -1, -1};
-    const int cyc_ny[10] = {0, -1, -1, -1, 0, 1, 1, 1, 0, -1};
-
-    int sxy = sigma[x][y]; // the central site
+    int sxy = sigma(x, y); // the central site
     if (sxy == 0)
         return true;
 
-    int n_borders =
-        0; // to count the amount of sites in state sxy bordering a site !=sxy
-
-    static int stack[8]; // stack to count number of different surrounding cells
-    int stackp = -1;
-    bool one_of_neighbours_medium = false;
-
-    for (int i = 1; i <= 8; i++)
-    {
-        int xcn = x + cyc_nx[i];
-        int ycn = y + cyc_ny[i];
-        int xncn = x + cyc_nx[i + 1];
-        int yncn = y + cyc_ny[i + 1];
-
-        if (par.periodic_boundaries)
-        {
-            if (xcn <= 0)
-                xcn = sizex - 2 + xcn;
-            if (ycn <= 0)
-                ycn = sizey - 2 + ycn;
-            if (xcn >= sizex - 1)
-                xcn = xcn - sizex + 2;
-            if (ycn >= sizey - 1)
-                ycn = ycn - sizey + 2;
-            if (xncn <= 0)
-                xncn = sizex - 2 + xncn;
-            if (yncn <= 0)
-                yncn = sizey - 2 + yncn;
-            if (xncn >= sizex - 1)
-                xncn = xncn - sizex + 2;
-            if (yncn >= sizey - 1)
-                yncn = yncn - sizey + 2;
-        }
-
-        int s_nb = sigma[xcn][ycn];
-        int s_next_nb = sigma[xncn][yncn];
-
-        if ((s_nb > 0 || s_next_nb > 0) && (s_nb == 0 || s_next_nb == 0))
-        {
-
-            // check whether s_nb is adjacent to non-identical site,
-            // count it
-            n_borders++;
-        }
-        int j;
-        bool on_stack_p = false;
-        // we need the next heuristic to prevent stalling at
-        // cell-cell borders
-        // do not enforce constraint at two cell interface(no medium)
-        if (s_nb)
-        {
-            for (j = stackp; j >= 0; j--)
-            {
-                if (s_nb == stack[j])
-                {
-                    on_stack_p = true;
-                    break;
-                }
-            }
-            if (!on_stack_p)
-            {
-                if (stackp > 6)
-                {
-                    cerr << "Stack overflow, stackp=" << stackp << "\n";
-                }
-                stack[++stackp] = s_nb;
-            }
-        }
-        else
-        {
-            one_of_neighbours_medium = true;
-        }
-    }
-
-    // number of different neighbours is stackp+1;
-    if (n_borders > 2 && ((stackp + 1) > 2 || one_of_neighbours_medium))
-    {
-        return false;
-    }
-    else
+    // count the sites of a cell bordering medium; border sites are neither
+    unsigned medium = Connectivity::SameSpinMask(sigma, x, y, 0);
+    unsigned border = Connectivity::SameSpinMask(sigma, x, y, -1);
+    unsigned cells = ~(medium | border) & 0xff;
+    auto next = [](unsigned mask) { return ((mask >> 1) | (mask << 7)) & 0xff; };
+    unsigned borders = (cells & next(medium)) | (medium & next(cells));
+    if (std::bitset<8>(borders).count() <= 2)
         return true;
+    return TwoCellInterface(sigma, x, y);
 }
 
 double CellularPotts::CellDensity(void) const
 {
     // return the density of cells
     int sum = 0;
-    for (int i = 0; i < sizex * sizey; i++)
-    {
-        if (sigma[0][i])
+    for (int x = 0; x < sizex; x++)
+        for (int y = 0; y < sizey; y++)
         {
-            sum++;
+            if (sigma(x, y))
+            {
+                sum++;
+            }
         }
-    }
     return (double)sum / (double)(sizex * sizey);
 }
 
@@ -2374,7 +2350,7 @@ double CellularPotts::MeanCellArea(void) const
 {
     int sum_area = 0, n = 0;
     double sum_length = 0.;
-    vector<Cell>::iterator c = cell->begin();
+    CellPool::iterator c = cell->begin();
     ++c;
 
     for (; c != cell->end(); c++)
@@ -2389,7 +2365,7 @@ double CellularPotts::MeanCellArea(void) const
 
 void CellularPotts::ResetTargetLengths(void)
 {
-    vector<Cell>::iterator c = cell->begin();
+    CellPool::iterator c = cell->begin();
     ++c;
     for (; c != cell->end(); c++)
     {
@@ -2400,7 +2376,7 @@ void CellularPotts::ResetTargetLengths(void)
 void CellularPotts::SetRandomTypes(void)
 {
     // each cell gets a random type 1..maxtau
-    vector<Cell>::iterator c = cell->begin();
+    CellPool::iterator c = cell->begin();
     ++c;
     for (; c != cell->end(); c++)
     {
@@ -2411,9 +2387,8 @@ void CellularPotts::SetRandomTypes(void)
 }
 
 void CellularPotts::GrowAndDivideCells(int growth_rate,
-                                       std::vector<Cell> &cells)
+                                       CellPool &cells)
 {
-    vector<Cell>::iterator c = cell->begin();
     vector<bool> which_cells(cell->size());
     for (auto &c : cells)
     {
@@ -2455,7 +2430,7 @@ double CellularPotts::DrawConvexHull(Graphics *g, int color)
     for (int x = 1; x < sizex - 1; x++)
         for (int y = 1; y < sizey - 1; y++)
         {
-            if (sigma[x][y])
+            if (sigma(x, y))
             {
                 np++;
             }
@@ -2467,7 +2442,7 @@ double CellularPotts::DrawConvexHull(Graphics *g, int color)
     {
         for (int y = 1; y < sizey - 1; y++)
         {
-            if (sigma[x][y])
+            if (sigma(x, y))
             {
                 p[pc++] = Point(x, y);
             }
@@ -2499,150 +2474,40 @@ double CellularPotts::DrawConvexHull(Graphics *g, int color)
 
 double CellularPotts::Compactness(void)
 {
-    int bounds[4];
-    bounds[0] = 1;
-    bounds[1] = sizey - 2;
-    bounds[2] = 1;
-    bounds[3] = sizex - 2;
     // Calculate compactness using the convex hull of the cells, including the
     // corner points of pixels We use Andrew's Monotone Chain Algorithm (see
     // hull.cpp)
+    const CellPixels &pixels = GetCellPixels();
 
     // Step 1: calculate total cell area
 
     double cell_area = 0;
-    for (int x = bounds[2]; x < bounds[3] + 1; x++) // count only within the box
-        for (int y = bounds[0]; y < bounds[1] + 1; y++)
-        {
-            if (sigma[x][y]) // Only consider one celltype
-            {
-                cell_area++;
-            }
-        }
+    for (int c = 1; c < pixels.Cells(); c++)
+        cell_area += pixels.Pixels(c).size();
 
-    int np = 0;
     // Step 2. Prepare data for 2D hull code
 
-    // Step 2a. Count number of corner points to determine size of array
-
-    // First consider the left-most column, a corner point if there is a pixel
-    // (or to the bottom of it)
-    if (sigma[bounds[2]][bounds[0]]) // bottom row separately
-        np++;
-    for (int y = bounds[0] + 1; y < bounds[1] + 1; y++)
-        if (sigma[bounds[2]][y] ||
-            sigma[bounds[2]][y - 1]) // Only consider one celltype
-                                     // add corner point only if a pixel is
-                                     // present at this location or below it.
-        {
-            np++;
-        }
-    if (sigma[bounds[2]][bounds[1]]) // add top-left most corner points if there
-                                     // is a pixel there
-        np++;
-
-    // Add all 'inner' corner points
-    for (int x = bounds[2] + 1; x < bounds[3] + 1; x++)
-    {
-        if (sigma[x][bounds[0]] || sigma[x - 1][bounds[0]])
-            np++; // special case for bottom row is required
-        for (int y = bounds[0] + 1; y < bounds[1] + 1;
-             y++) // loop over all other rows
-        {
-            if (sigma[x][y] || sigma[x - 1][y] || sigma[x][y - 1] ||
-                sigma[x - 1][y - 1]) // Only consider one celltype
-            // and add a corner point on the bottom left of the current pixel if
-            // one of the adjacent pixels is present
-            {
-                np++;
-            }
-        }
-        if (sigma[x][bounds[1]] || sigma[x - 1][bounds[1]])
-            np++;
-        // add the top-most corner point only if there is a pixel on the top row
-        // (or to the left of this pixel)
-    }
-
-    // Consider the right-most column separately, only add a corner point if
-    // there is a pixel in this column (or to the bottom of it)
-    if (sigma[bounds[3]][bounds[0]]) // bottom row separately
-        np++;
-    for (int y = bounds[0] + 1; y < bounds[1] + 1; y++)
-        if (sigma[bounds[3]][y] ||
-            sigma[bounds[3]][y - 1]) // Only consider one celltype
-                                     // add corner point only if a pixel is
-                                     // present at this location or below it.
-        {
-            np++;
-        }
-    if (sigma[bounds[3]][bounds[1]])
-        np++;
-
-    // Step 2b. Create array which will contain all corner points
-
-    Point *p = new Point[np];
-
-    // Step 2c. Fill the array with all lattice points ordered, x-first.
-    int pc = 0;
-
-    // First consider the left-most column, a corner point if there is a pixel
-    // (or to the bottom of it)
-    if (sigma[bounds[2]][bounds[0]]) // bottom row separately
-        p[pc++] = Point(bounds[2] - 0.5, bounds[0] - 0.5);
-    for (int y = bounds[0] + 1; y < bounds[1] + 1; y++)
-        if (sigma[bounds[2]][y] ||
-            sigma[bounds[2]][y - 1]) // Only consider one celltype
-                                     // add corner point only if a pixel is
-                                     // present at this location or below it.
-        {
-            p[pc++] = Point(bounds[2] - 0.5, y - 0.5);
-        }
-    if (sigma[bounds[2]][bounds[1]]) // add top-left most corner points if there
-                                     // is a pixel there
-        p[pc++] = Point(bounds[2] - 0.5, bounds[1] + 0.5);
-
-    // Add all 'inner' corner points
-    for (int x = bounds[2] + 1; x < bounds[3] + 1; x++)
-    {
-        if (sigma[x][bounds[0]] || sigma[x - 1][bounds[0]])
-            p[pc++] = Point(x - 0.5,
-                            bounds[0] -
-                                0.5); // special case for bottom row is required
-        for (int y = bounds[0] + 1; y < bounds[1] + 1;
-             y++) // loop over all other rows
-        {
-            if (sigma[x][y] || sigma[x - 1][y] || sigma[x][y - 1] ||
-                sigma[x - 1][y - 1]) // Only consider one celltype
-            // and add a corner point on the bottom left of the current pixel if
-            // one of the adjacent pixels is present
-            {
-                p[pc++] = Point(x - 0.5, y - 0.5);
-            }
-        }
-        if (sigma[x][bounds[1]] || sigma[x - 1][bounds[1]])
-            p[pc++] = Point(x - 0.5, bounds[1] + 0.5);
-        // add the top-most corner point only if there is a pixel on the top row
-        // (or to the left of this pixel)
-    }
-
-    // Consider the right-most column separately, only add a corner point if
-    // there is a pixel in this column (or to the bottom of it)
-    if (sigma[bounds[3]][bounds[0]]) // bottom row separately
-        p[pc++] = Point(bounds[3] + 0.5, bounds[0] - 0.5);
-    for (int y = bounds[0] + 1; y < bounds[1] + 1; y++)
-        if (sigma[bounds[3]][y] ||
-            sigma[bounds[3]][y - 1]) // Only consider one celltype
-                                     // add corner point only if a pixel is
-                                     // present at this location or below it.
-        {
-            p[pc++] = Point(bounds[3] + 0.5, y - 0.5);
-        }
-    if (sigma[bounds[3]][bounds[1]])
-        p[pc++] = Point(bounds[3] + 0.5, bounds[1] + 0.5);
+    // The corners of interior pixels are never on the hull, so collect those
+    // of the boundary pixels. Coordinates are doubled to keep them integer.
+    std::vector<std::array<int, 2>> corners;
+    for (int c = 1; c < pixels.Cells(); c++)
+        for (const auto &pixel : pixels.Boundary(c))
+            for (int dx = -1; dx <= 1; dx += 2)
+                for (int dy = -1; dy <= 1; dy += 2)
+                    corners.push_back(
+                        {2 * pixel[0] + dx, 2 * pixel[1] + dy});
+
+    // the hull code needs the points ordered, x-first
+    std::sort(corners.begin(), corners.end());
+    corners.erase(std::unique(corners.begin(), corners.end()), corners.end());
+    const int np = static_cast<int>(corners.size());
+    std::vector<Point> p(np);
+    for (int i = 0; i < np; i++)
+        p[i] = Point(0.5 * corners[i][0], 0.5 * corners[i][1]);
 
     // Step 3: call 2D Hull code
-    Point *hull = new Point[np];
-    int nph = chainHull_2D(p, np, hull);
+    std::vector<Point> hull(np);
+    int nph = chainHull_2D(p.data(), np, hull.data());
 
     // Step 4: calculate area of convex hull
 
@@ -2653,9 +2518,6 @@ double CellularPotts::Compactness(void)
     }
     hull_area /= 2.;
 
-    delete[] p;
-    delete[] hull;
-
     // return compactness
     // cout << "cell_area = " << cell_area << endl;
     // cout << "hull_area = " << hull_area << endl;
@@ -2666,28 +2528,28 @@ void CellularPotts::FindBoundingBox(void)
 {
     int min_x = sizex + 2, max_x = 0;
     int min_y = sizey + 2, max_y = 0;
-    for (int x = 1; x <= sizex - 2; x++)
+    // the extremes of a cell are on its boundary
+    const CellPixels &pixels = GetCellPixels();
+    for (int c = 1; c < pixels.Cells(); c++)
     {
-        for (int y = 1; y <= sizey - 2; y++)
+        for (const auto &pixel : pixels.Boundary(c))
         {
-            if (sigma[x][y])
+            const int x = pixel[0], y = pixel[1];
+            if (x < min_x)
             {
-                if (x < min_x)
-                {
-                    min_x = x;
-                }
-                if (x > max_x)
-                {
-                    max_x = x;
-                }
-                if (y < min_y)
-                {
-                    min_y = y;
-                }
-                if (y > max_y)
-                {
-                    max_y = y;
-                }
+                min_x = x;
+            }
+            if (x > max_x)
+            {
+                max_x = x;
+            }
+            if (y < min_y)
+            {
+                min_y = y;
+            }
+            if (y > max_y)
+            {
+                max_y = y;
             }
         }
     }
@@ -2696,18 +2558,19 @@ void CellularPotts::FindBoundingBox(void)
 // useful to demonstrate large q-Potts
 void CellularPotts::RandomSigma(int n_cells)
 {
+    InvalidateSpinIndices();
     for (int x = 0; x < sizex; x++)
     {
         for (int y = 0; y < sizey; y++)
         {
-            sigma[x][y] = (int)(n_cells * RANDOM());
+            sigma(x, y) = (int)(n_cells * RANDOM());
         }
     }
 }
 
 bool CellularPotts::plotPos(int x, int y, Graphics *graphics)
 {
-    int self = sigma[x][y];
+    int self = sigma(x, y);
     if (self <= 0)
         return true;
     graphics->Rectangle((*cell)[self].Colour(), x, y);
@@ -2716,16 +2579,16 @@ bool CellularPotts::plotPos(int x, int y, Graphics *graphics)
 
 void CellularPotts::linePlotPos(int x, int y, Graphics *graphics)
 {
-    int self = sigma[x][y];
+    int self = sigma(x, y);
     int a = self, b = self, c = self, d = self;
     if (x != 0)
-        a = sigma[x - 1][y];
+        a = sigma(x - 1, y);
     if (y != 0)
-        b = sigma[x][y - 1];
+        b = sigma(x, y - 1);
     if (x != par.sizex - 1)
-        c = sigma[x + 1][y];
+        c = sigma(x + 1, y);
     if (y != par.sizey - 1)
-        d = sigma[x][y + 1];
+        d = sigma(x, y + 1);
     if (self != a)
         graphics->Line(x, y, x, y + 1, 1);
     if (self != b)
@@ -2742,16 +2605,17 @@ void CellularPotts::anneal(int steps)
         AmoebaeMove(0, true);
 }
 
-int **CellularPotts::get_annealed_sigma(int steps)
+SpinLattice CellularPotts::get_annealed_sigma(int steps)
 {
-    int **tmp_a = sigma;
-    int **tmp_b;
+    SpinLattice original = sigma;
     AllocateSigma(par.sizex, par.sizey);
-    std::copy(*tmp_a, (*tmp_a) + (par.sizex * par.sizey), *sigma);
+    for (int x = 0; x < par.sizex; x++)
+        for (int y = 0; y < par.sizey; y++)
+            sigma(x, y) = original(x, y);
     anneal(steps);
-    tmp_b = sigma;
-    sigma = tmp_a;
-    return tmp_b;
+    std::swap(sigma, original);
+    InvalidateSpinIndices();
+    return original;
 }
 
 void CellularPotts::MoveAdhesions()
@@ -2869,44 +2733,9 @@ int CellularPotts::CounterEdge(int edge) {
   return counteredge;
 }
 
-bool CellularPotts::LocalConnectedness(int x, int y, int s){
-
-  //Algorithm from Durand, M., & Guesnet, E. (2016). An efficient Cellular Potts Model algorithm that forbids cell fragmentation. Computer Physics Communications, 208, 54-63.
-  //Checks if cell sigma is locally connected at lattice point (x,y) if using LocalConnectedness(x,y,sigma[x][y]) and LocalConnectedness(x,y,sigma[xp][yp] both are true
-
-
-   // Use local nx and ny in a cyclic order (starts at upper left corner)
-  const int cyc_nx[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
-  const int cyc_ny[8] = {0, -1, -1, -1, 0, 1, 1, 1};
-  bool connected_component = false; 
-  //Currently in a connected component
-  int nr_connected_components = 0;
-  //Total number of conncected components around x,y
-  for (int i = 0; i <= 7; i++){
-    int s_nb = sigma[x + cyc_nx[i]][y + cyc_ny[i]];
-    if (s_nb == s && !connected_component){
-      //start of a connected component
-      connected_component = true;
-      nr_connected_components++;
-    }
-    else if (s_nb != s && connected_component){
-      //end of a conencted component
-      connected_component = false;
-    }
-  }
-  bool looped = false;
-  if (sigma[x + cyc_nx[0]][y + cyc_ny[0]] == s && sigma[x + cyc_nx[7]][y + cyc_ny[7]] == s)
-    looped = true;
-  //Check if the first and last element are connected
-  if ((nr_connected_components >= 2 && !looped) || nr_connected_components >= 3 && looped)
-  //permit one more component when the first and last element are connected
-    return false;
-  else
-    return true;
-}
-
 void CellularPotts::setGrid(const Grid &grid) {
+    InvalidateSpinIndices();
     for (int x = 0; x < par.sizex; x++)
       for (int y = 0; y < par.sizey; y++) 
-        sigma[x][y] = grid.get({x,y});
+        sigma(x, y) = grid.get({x,y});
 }
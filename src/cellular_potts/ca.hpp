@@ -34,21 +34,36 @@ Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
 #else
 
 #include <array>
+#include <chrono>
+#include <cstdint>
 #include <cstddef>
 #include <functional>
+#include <mutex>
 #include <random>
 #include <stdio.h>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "pde.hpp"
 #include "cell.hpp"
+#include "cell_pool.hpp"
 #include "adhesion_mover.hpp"
 #include "cell_ecm_interactions.hpp"
 #include "extension_history.hpp"
 #include "act.hpp"
+#include "act_pixels.hpp"
+#include "boundary_sites.hpp"
+#include "cell_pixels.hpp"
+#include "contact_graph.hpp"
+#include "energy_terms.hpp"
+#include "hot_cells.hpp"
+#include "nfold_way.hpp"
+#include "counter_rng.hpp"
 #include "grid.hpp"
+#include "spin_lattice.hpp"
+#include "connectivity.hpp"
 
 using namespace std;
 
@@ -114,6 +129,8 @@ class CellularPotts
     friend class Info;
     friend class Plotter;
     friend class Morphometry;
+    // compares the energy functions in tests/test_specialised_deltah.cpp
+    friend class CellularPottsTest;
 
 public:
     inline int getNbhx(int i) { return nx[i]; }
@@ -129,12 +146,12 @@ public:
      * \return Act concentration
      */
     int GetActLevel(int x, int y);
-    std::unordered_set<std::array<int, 2>> alivePixels;
-    std::unordered_map<std::array<int, 2>, int> actPixels;
+    //! Act levels and alive pixels of Act_AmoebaeMove
+    ActPixels act_pixels;
     int **matrix;
 
     //! @brief Constructs a CA field. This should be done in "Dish".
-    CellularPotts(std::vector<Cell> *cells, const int sizex = 200,
+    CellularPotts(CellPool *cells, const int sizex = 200,
                   const int sizey = 200);
     // empty constructor
     // (necessary for derivation)
@@ -144,7 +161,9 @@ public:
 
     * The edgelist keeps track of pairs of lattice points that are eligible to
     change the CPM configuration. This function initialises the edgelist at the
-    start.
+    start. With cpm_update_scheme = boundary, it initialises the index of
+    boundary sites instead, and with nfold, the rates are rebuilt at the
+    next MCS.
     */
     void InitialiseEdgeList(void);
 
@@ -163,21 +182,16 @@ public:
     // destructor must also be virtual
     virtual ~CellularPotts();
 
-    /** @brief Plots the dish to the screen or to a movie and searches the
-     neighbours.
+    /** @brief Plots the dish to the screen or to a movie.
 
-     These distinct tasks have been lumped together in the
-     same method because both for drawing the black lines between the
-     cells and for searching the neighbours the cell borders have to be
-     determined.
-
-     * \return neighbourhood array
+     The neighbours of the cells, which this used to search as well, are
+     kept in the contact graph; see SearchNeighbours().
      */
 
-    int **SearchNandPlot(Graphics *g = 0, bool get_neighbours = true);
+    void SearchNandPlot(Graphics *g = 0);
 
     //! Plot the dish to Graphics window g
-    inline void Plot(Graphics *g) { SearchNandPlot(g, false); }
+    inline void Plot(Graphics *g) { SearchNandPlot(g); }
 
     /**  @brief Special plotting for Ising model
 
@@ -213,18 +227,22 @@ public:
      */
     void SetLambdaPerimeter(int tau, int value);
 
-    //! Searches the cells' neighbours without plotting
-    inline int **SearchNeighbours(void) { return SearchNandPlot(0, true); }
+    //! The cells' neighbours, with the lengths of their interfaces
+    inline const ContactGraph &SearchNeighbours(void)
+    {
+        return GetContactGraph();
+    }
 
     //! Return the total area occupied by the cells
     inline int Mass(void)
     {
         int mass = 0;
-        for (int i = 0; i < sizex * sizey; i++)
-        {
-            if (sigma[0][i] > 0)
-                mass++;
-        }
+        for (int x = 0; x < sizex; x++)
+            for (int y = 0; y < sizey; y++)
+            {
+                if (sigma(x, y) > 0)
+                    mass++;
+            }
         return mass;
     }
 
@@ -242,7 +260,7 @@ public:
 
     /** @brief Divide all cells.
     Divide along cell elongation axis */
-    void DivideCells(vector<Cell> &cells)
+    void DivideCells(CellPool &cells)
     {
         std::vector<bool> which_cells(cells.size());
         for (int i = 1; i < cells.size(); i++)
@@ -257,13 +275,23 @@ public:
 
      If which_cells is empty, this method divides all cells.
     */
-    void DivideCells(std::vector<bool> which_cells, vector<Cell> &cells);
+    void DivideCells(std::vector<bool> which_cells, CellPool &cells);
 
     /** Implements the core CPM algorithm. Carries out one MCS.
+
+    The copy attempts are selected with the scheme given by the
+    cpm_update_scheme parameter.
      * \return Total energy change during MCS.
      */
     int AmoebaeMove(PDE *PDEfield = 0, bool anneal = false);
 
+    /** @brief Choose the SpecialisedAmoebaeMove instantiation for the
+     * current neighbourhood and parameters. Called by the constructors; call
+     * again after changing neighbours, periodic_boundaries,
+     * adhesions_enabled or lambda_Act.
+     */
+    void SelectAmoebaeMove(void);
+
     /** @brief Implements the core CPM algorithm including Act dynamics.
 
       Carries out one
@@ -343,10 +371,40 @@ public:
     //! @brief Return the vertical size of the CA plane.
     inline int SizeY() const { return sizey; }
 
+    /** @brief Return the number of copy attempts in the last MCS of the
+     * edgelist or boundary update scheme.
+     */
+    inline std::int64_t CopyAttempts() const { return copy_attempts; }
+
+    /** @brief Remove the cells that have died and have no pixels left, and
+     * renumber the others densely, in the same order.
+     *
+     * The lattice, the ids and lineage of the cells and the extension history
+     * are renumbered. A removed mother or daughter becomes 0. Models that
+     * keep cell ids themselves must renumber them with CellIdMapping(). The
+     * pixel lists, contact graph and energy totals that are kept up to date
+     * stay so. AmoebaeMove() calls this every cell_compaction_interval MCS.
+     * \return The number of cells removed.
+     */
+    int CompactCells();
+
+    /** @brief For each cell id before the last CompactCells(), the id after
+     * it, or -1 if the cell was removed.
+     */
+    const std::vector<int> &CellIdMapping() const { return cell_id_mapping; }
+
+    /** @brief Throw a std::runtime_error if any cell is in more than one
+     * piece.
+     *
+     * On periodic lattices the halo must be filled, as it is during
+     * AmoebaeMove(), which calls this every connectivity_check_interval MCS.
+     */
+    void CheckConnectivity() const;
+
     /** @brief Return the value of lattice site (x,y).
 
     i.e. This will return the index of the cell which occupies site (x,y). */
-    inline int Sigma(const int x, const int y) const { return sigma[x][y]; }
+    inline int Sigma(const int x, const int y) const { return sigma(x, y); }
 
     /** In this method the principal axes of the cells are computed using
      the method described in "Biometry", box 15.5
@@ -399,8 +457,7 @@ public:
     //! @brief Adds a new Cell and returns a reference to it.
     inline Cell &AddCell(Dish &beast)
     {
-        cell->push_back(Cell(beast));
-        return cell->back();
+        return cell->emplace_back(beast);
     }
     /** @brief Display the division planes returned by FindCellDirections.
 
@@ -435,13 +492,13 @@ public:
     /** Cells grow until twice their original target_length, then
       divide, with rate "growth_rate"
     */
-    void GrowAndDivideCells(int growth_rate, std::vector<Cell> &cells);
+    void GrowAndDivideCells(int growth_rate, CellPool &cells);
 
     /** @brief Returns cell with sigma c.
      */
     inline Cell &getCell(int c) const { return (*cell)[c]; }
 
-    inline vector<Cell> *getCellArray() const { return cell; }
+    inline CellPool *getCellArray() const { return cell; }
 
     /** Draw convex hull around all cells.
      * \return The area of the convex hull in lattice sites.
@@ -481,11 +538,78 @@ public:
     * \param steps: Number of annealing MCS
     * \return sigma-field after annealing
     */
-    int **get_annealed_sigma(int steps);
+    SpinLattice get_annealed_sigma(int steps);
 
     /**  Return Sigma Array
      */
-    inline int **getSigma() const { return sigma; }
+    inline SpinLattice &getSigma() { return sigma; }
+    inline const SpinLattice &getSigma() const { return sigma; }
+
+    /** @brief The pixels and boundary pixels of every cell.
+     *
+     * Built on first use, and kept up to date by ConvertSpin from then on.
+     * Code that writes to the lattice through getSigma() must call
+     * InvalidateSpinIndices() afterwards.
+     */
+    const CellPixels &GetCellPixels() const
+    {
+        if (!cell_pixels.Live())
+            cell_pixels.Build(sigma, sizex, sizey, par.periodic_boundaries);
+        return cell_pixels;
+    }
+
+    /** @brief Which cells and the medium touch, and along how many edges.
+     *
+     * Built on first use, and kept up to date like GetCellPixels().
+     */
+    const ContactGraph &GetContactGraph() const
+    {
+        if (!contact_graph.Live())
+            contact_graph.Build(sigma, sizex, sizey, par.periodic_boundaries);
+        return contact_graph;
+    }
+
+    /** @brief Have the next GetCellPixels() and GetContactGraph() rebuild
+     * from sigma, and the next Energy() measure the lattice again
+     */
+    void InvalidateSpinIndices()
+    {
+        cell_pixels.Stop();
+        contact_graph.Stop();
+        energy_live = false;
+    }
+
+    /** @brief The energy of the lattice, term by term.
+     *
+     * Measured on first use, and from then on kept up to date from the
+     * energy changes of the copies made by AmoebaeMove, so that it can be
+     * logged every MCS at next to no cost. Changes that the models make to
+     * the cells in between MCS, such as new target areas or cell types, are
+     * taken into account at the start of the next AmoebaeMove.
+     * Act_AmoebaeMove does not keep the totals, so the next Energy() after
+     * it measures the lattice again, and its copies are missing from the
+     * chemotaxis, act and ECM terms.
+     */
+    const EnergyTerms &Energy() const;
+
+    /** @brief Measure the adhesion, area, length and spreading terms of the
+     * lattice from scratch. The other terms are left at zero.
+     */
+    EnergyTerms MeasureEnergy() const;
+
+    /** @brief Compare the totals of Energy() with MeasureEnergy(), and carry
+     * on from the measured values.
+     *
+     * AmoebaeMove calls this every energy_check_interval MCS. Prints a
+     * warning to cerr for every term that has drifted.
+     * \return The largest difference found.
+     */
+    double CheckEnergy();
+
+    /** @brief Copy of the lattice as one contiguous array of sizex * sizey
+     * sites, column by column (sigma itself is padded).
+     */
+    std::vector<int> getSigmaArray() const;
 
     /** @brief plot the sigma at (x,y)
 
@@ -498,27 +622,192 @@ public:
 
     inline void fillCellColArr(int *arr)
     {
-        for (int dex = 0; dex < par.sizex * par.sizey; dex++)
-        {
-            int pos = sigma[0][dex];
-            if (pos != 0)
+        for (int x = 0; x < par.sizex; x++)
+            for (int y = 0; y < par.sizey; y++)
             {
-                arr[dex] = (*cell)[pos].Colour();
+                int pos = sigma(x, y);
+                int dex = x * par.sizey + y;
+                if (pos != 0)
+                {
+                    arr[dex] = (*cell)[pos].Colour();
+                }
+                else
+                {
+                    arr[dex] = 0;
+                }
             }
-            else
-            {
-                arr[dex] = 0;
-            }
-        }
     };
 
   vector<AdhesionWithEnvironment> getAdhesions();
 private:
+    /** @brief One MCS of serial Metropolis dynamics over the edge list
+     *
+     * The neighbourhood size, the boundary type and whether the adhesion
+     * and act terms take part are fixed at compile time; SelectAmoebaeMove()
+     * picks the instantiation that matches the parameters.
+     * \return Total energy change during MCS.
+     */
+    template <int NNb, bool Periodic, bool Adhesions, bool Act>
+    int SpecialisedAmoebaeMove(PDE *PDEfield, bool anneal);
+
+    /** @brief One MCS of serial Metropolis dynamics over the boundary sites
+     *
+     * Draws copy attempts with the same probabilities as
+     * SpecialisedAmoebaeMove(), but from the index of boundary sites rather
+     * than from the edge list.
+     * \return Total energy change during MCS.
+     */
+    template <int NNb, bool Periodic, bool Adhesions, bool Act>
+    int BoundaryAmoebaeMove(PDE *PDEfield, bool anneal);
+
+    /** @brief One MCS of n-fold way (rejection-free) dynamics
+     *
+     * Draws only copies that are accepted, each with a probability
+     * proportional to the probability that SpecialisedAmoebaeMove() would
+     * accept it, and advances time by an exponentially distributed waiting
+     * time. Does not support adhesions or act.
+     * \return Total energy change during MCS.
+     */
+    template <int NNb, bool Periodic>
+    int NFoldAmoebaeMove(PDE *PDEfield, bool anneal);
+
+    /** @brief Recompute the rate of the copy of neighbour k of (x,y) into
+     * (x,y)
+     *
+     * If contact_known, reuses the contact energy and connectivity of the
+     * event, which depend only on the spins around (x,y).
+     */
+    template <int NNb, bool Periodic>
+    void NFoldEvent(int x, int y, int k, PDE *PDEfield, bool anneal,
+                    bool contact_known);
+
+    //! @brief Update the sum of the rates of the copies into site
+    template <int NNb> void NFoldSumSite(std::int64_t site);
+
+    //! @brief Recompute the rates of the copies into site
+    template <int NNb, bool Periodic>
+    void NFoldUpdateSite(std::int64_t site, PDE *PDEfield, bool anneal,
+                         bool contact_known);
+
+    //! @brief Recompute the rates of the copies into and out of cell c
+    template <int NNb, bool Periodic>
+    void NFoldUpdateCell(int c, PDE *PDEfield, bool anneal,
+                         bool contact_known);
+
+    /** @brief Update the boundaries and the rates around (x,y) after its
+     * spin changed from old_spin
+     */
+    template <int NNb, bool Periodic>
+    void NFoldSiteChanged(int x, int y, int old_spin, PDE *PDEfield,
+                          bool anneal);
+
+    //! @brief Add or remove (x,y) from the boundary sites of its cell
+    template <int NNb>
+    void NFoldUpdateBoundary(int x, int y, std::int64_t site);
+
+    /** @brief Bring the n-fold way state up to date with the lattice and the
+     * cells, or build it if needed
+     */
+    template <int NNb, bool Periodic>
+    void NFoldSync(PDE *PDEfield, bool anneal);
+
+    /** @brief Copy the spin of (xp,yp) into (x,y), updating the act field
+     * and the extension history
+     */
+    void CommitCopy(int x, int y, int xp, int yp);
+
+    /** @brief Try to copy the spin of (xp,yp) into (x,y), as in
+     * SpecialisedAmoebaeMove
+     *
+     * \return Whether the copy was made; if so, D_H is its energy change.
+     */
+    template <int NNb, bool Periodic, bool Adhesions, bool Act>
+    bool SpecialisedCopyAttempt(int x, int y, int xp, int yp, PDE *PDEfield,
+                                bool anneal, bool philox, bool lazy,
+                                int &D_H);
+
+    /** @brief DeltaH() for the terms and neighbourhood of
+     * SpecialisedAmoebaeMove
+     *
+     * Gives up and returns std::numeric_limits<int>::max() as soon as the
+     * energy change is sure to exceed budget, before evaluating the adhesion
+     * and act terms where possible.
+     */
+    template <int NNb, bool Periodic, bool Adhesions, bool Act>
+    int SpecialisedDeltaH(int x, int y, int xp, int yp, PDE *PDEfield,
+                          AdhesionDisplacements *adh_disp, double budget,
+                          const int *contact = nullptr,
+                          EnergyTerms *terms = nullptr);
+
+    /** @brief Update the edges of site (x,y) after a copy into it, and
+     * adjust the number of attempts left in the MCS
+     */
+    template <int NNb, std::size_t... J>
+    void UpdateEdgesAfterCopy(int x, int y, int targetsite, float &loop,
+                              std::index_sequence<J...>);
+    template <int NNb, int J>
+    void UpdateEdge(int x, int y, int targetsite, float &loop);
+
+    /** @brief Update the boundary sites after a copy into (x,y), which had
+     * spin old_spin
+     */
+    template <int NNb, bool Periodic>
+    void UpdateBoundaryAfterCopy(int x, int y, std::int64_t site,
+                                 int old_spin);
+
+    //! @brief Build the index of boundary sites from sigma
+    void InitialiseBoundarySites(void);
+
+    //! The instantiation of SpecialisedAmoebaeMove used by AmoebaeMove
+    int (CellularPotts::*edge_list_move)(PDE *, bool);
+
+    /** @brief One MCS of tiled, multi-threaded Metropolis dynamics.
+
+    The lattice is cut into tiles of at least par.cpm_tile_size pixels wide,
+    coloured as a 2x2 checkerboard. Tiles of one colour are too far apart to
+    read each other's sites, so they are swept concurrently, one colour after
+    the other. Cell areas and moments are updated under a per-cell lock, the
+    edge list and the extension history are brought up to date serially after
+    each colour. Tiles draw from counter-based substreams of cpm_rng.
+     * \return Total energy change during MCS.
+     */
+    int CheckerboardAmoebaeMove(PDE *PDEfield, bool anneal);
+
+    /** @brief Bring the edges of site (x,y) in the edge list up to date
+     */
+    void UpdateEdgesOfSite(int x, int y);
+
+    /** @brief With periodic boundaries, copy the periodic images of the
+     * lattice into the border ring and the halo around it
+     */
+    void FillHalo(void);
+
+    /** @brief Reset the border ring and the halo to border sites
+     */
+    void ClearHalo(void);
+
+    /** @brief Copy site (x,y) into its periodic images in the halo, if the
+     * halo is filled
+     */
+    void UpdateHaloImages(int x, int y);
+
+    //! Width of the layer around the interior that stencils may read,
+    //! enough for the 20-site neighbourhood
+    static const int halo = 2;
+    bool halo_filled;
+
+    /** @brief Print the MCS/s of AmoebaeMove every mcs_rate_report_interval
+     * MCS
+     */
+    void ReportMCSRate(std::chrono::steady_clock::duration elapsed);
+
     /** @brief Standard deltaH with are constraint, length constraint and
      * chemotaxis
+     *
+     * If terms is given, the change of each term is stored there, unrounded.
      */
     int DeltaH(int x, int y, int xp, int yp, PDE *PDEfield,
-               AdhesionDisplacements *adh_disp);
+               AdhesionDisplacements *adh_disp, EnergyTerms *terms = nullptr);
 
     /** @brief DeltaH, including act dynamics
      */
@@ -544,12 +833,42 @@ private:
      */
     void ExchangeSpin(int x, int y, int xp, int yp);
 
+    /** @brief Update the pixel index and contact graph, if they are kept up
+     * to date, after (x,y) changed from old_spin
+     */
+    void UpdateSpinIndices(int x, int y, int old_spin);
+
+    //! @brief Spin of the i'th neighbour of (x,y), wrapped if periodic
+    int NeighbourSpin(int x, int y, int i) const;
+
+    /** @brief Contact energy between site (x,y), if it had the given spin,
+     * and its neighbours
+     */
+    double SiteContactEnergy(int x, int y, int spin) const;
+
+    /** @brief Set the area, length and spreading terms of Energy() from the
+     * cells, and measure the adhesion term again if a cell changed type
+     */
+    void SyncCellEnergy();
+
+    //! @brief Add the area, length and spreading terms of the cells to e
+    void MeasureCellEnergy(EnergyTerms &e) const;
+
     void SprayMedium(void);
 
     /** @brief Compute if a copy attempt should get accepted
      */
     int CopyvProb(int DH, double stiff, bool anneal);
 
+    /** @brief As above, using the uniform deviate u instead of RANDOM()
+     */
+    int CopyvProb(int DH, double stiff, bool anneal, double u);
+
+    /** @brief The probability that CopyvProb() accepts a copy with energy
+     * change DH, without stiffness
+     */
+    double CopyProbability(int DH, bool anneal) const;
+
     /** @brief Freeze the CPM configuration
      */
     void FreezeAmoebae(void);
@@ -584,7 +903,10 @@ private:
     fragementation, as well as holes within a cell.
     * \return Local connectedness of cell s at site (x,y)
     */
-    bool LocalConnectedness(int x, int y, int s);
+    bool LocalConnectedness(int x, int y, int s) const
+    {
+        return Connectivity::LocallyConnected(sigma, x, y, s);
+    }
 
     /** @brief Checks if connectivity is preserved if (x,y) would be changed
      */
@@ -599,21 +921,26 @@ private:
     inline void PrintSite(int x, int y)
     {
         std::cerr << "--------\n";
-        std::cerr << "[" << sigma[x - 1][y - 1] << " " << sigma[x][y - 1] << " "
-                  << sigma[x + 1][y - 1] << "]\n";
-        std::cerr << "[" << sigma[x - 1][y] << " " << sigma[x][y] << " "
-                  << sigma[x + 1][y] << "]\n";
-        std::cerr << "[" << sigma[x - 1][y + 1] << " " << sigma[x][y + 1] << " "
-                  << sigma[x + 1][y + 1] << "]\n";
+        std::cerr << "[" << sigma(x - 1, y - 1) << " " << sigma(x, y - 1) << " "
+                  << sigma(x + 1, y - 1) << "]\n";
+        std::cerr << "[" << sigma(x - 1, y) << " " << sigma(x, y) << " "
+                  << sigma(x + 1, y) << "]\n";
+        std::cerr << "[" << sigma(x - 1, y + 1) << " " << sigma(x, y + 1) << " "
+                  << sigma(x + 1, y + 1) << "]\n";
     }
 
 protected:
     /** @brief Initialise CPM class
      */
-    void BaseInitialisation(std::vector<Cell> *cell);
+    void BaseInitialisation(CellPool *cell);
 
 protected:
-  int **sigma;
+  /* sigma(x,y) for 0 <= x < sizex, 0 <= y < sizey, where the outer ring is
+     border (-1). It is surrounded by halo - 1 more layers of border sites, so
+     that neighbourhoods of interior sites need no bounds checks. With
+     periodic boundaries, AmoebaeMove fills the ring and the layers beyond it
+     with periodic images of the lattice for the duration of a sweep. */
+  SpinLattice sigma;
   int sizex;
   int sizey;
 public:
@@ -631,13 +958,37 @@ private:
   int *edgelist;
   int *orderedgelist;
   int sizeedgelist;
+  // the sites on a cell boundary, for cpm_update_scheme = boundary
+  BoundarySites boundary_sites;
+  // copy attempts in the last MCS, for the edgelist and boundary schemes
+  std::int64_t copy_attempts = 0;
+  // rates of the copy events, for cpm_update_scheme = nfold
+  NFoldState nfold;
+  // the pixels and the contacts of the cells, once asked for
+  mutable CellPixels cell_pixels;
+  mutable ContactGraph contact_graph;
+  // running totals of the energy terms, once asked for, and the cell types
+  // that the adhesion term was measured with
+  mutable EnergyTerms energy;
+  mutable bool energy_live = false;
+  mutable std::vector<int> energy_tau;
   static int shuffleindex[9];
-  std::vector<Cell> *cell;
+  CellPool *cell;
+  // what the energy terms read of the cells, during a sweep
+  HotCells hot_cells;
+  std::vector<int> cell_id_mapping;
   int zygote_area;
   int thetime;
   int n_nb;
   AdhesionMover adhesion_mover;
   ACT::ActField act_field;
+  // scratch space for Act_DeltaH
+  NeighbourChanges xy_neighbour_changes, xyp_neighbour_changes;
+  CounterRNG cpm_rng;
+  static const int n_cell_locks = 64;
+  std::array<std::mutex, n_cell_locks> cell_locks;
+  std::chrono::steady_clock::duration mcs_rate_elapsed;
+  int mcs_rate_count;
 };
 
 #endif
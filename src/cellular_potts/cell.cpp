@@ -22,6 +22,7 @@ Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
 */
 #include <fstream>
 #include <list>
+#include <stdexcept>
 #include <stdio.h>
 #include <vector>
 #ifndef __APPLE__
@@ -30,6 +31,7 @@ Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
 #include "cell.hpp"
 #include "dish.hpp"
 #include "parameter.hpp"
+#include "spin.hpp"
 #include "sticky.hpp"
 
 #define HASHCOLNUM 255
@@ -113,6 +115,9 @@ void Cell::ConstructorBody(int settau) {
 
     // maxsigma keeps track of the last cell identity number given out to a cell
     sigma = maxsigma++;
+    if (sigma > SPIN_MAX)
+        throw std::runtime_error(
+            "Cell: too many cells for the spin type of the lattice");
 
     if (!J)
     {
@@ -26,13 +26,17 @@ Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
 
 #include "cell_direction.hpp"
 #include "parameter.hpp"
+#include "spin_lattice.hpp"
 // #define EMPTY -1
+#include <functional>
 #include <iostream>
 #include <math.h>
 #include "vec2.hpp"
 
 extern Parameter par;
 class Dish;
+class CellPool;
+class CellPixels;
 
 class Cell
 {
@@ -40,8 +44,11 @@ class Cell
     friend class CellularPotts;
     friend class Info;
     friend class IO;
-    friend void DivideCells(std::vector<bool> which_cells,
-                            std::vector<Cell> &cells, int **sigma);
+    friend class HotCells;
+    friend void DivideCells(
+        std::vector<bool> which_cells, CellPool &cells, SpinLattice &sigma,
+        const CellPixels &pixels,
+        const std::function<void(int, int, int)> &spin_changed);
 
 public:
     Vec2<double> polarity; 
@@ -64,34 +71,18 @@ public:
     Cell(const Cell &src)
     {
         // make an exact copy (for internal use)
-        sigma = src.sigma;
-        amount++;
-        area = src.area;
-        target_area = src.target_area;
-        adhesive_area = src.adhesive_area;
-        ref_adhesive_area = src.ref_adhesive_area;
-        perimeter = src.perimeter;
-        target_perimeter = src.target_perimeter;
-        target_length = src.target_length;
-        growth_threshold = src.growth_threshold;
-        mother = src.mother;
-        daughter = src.daughter;
-        times_divided = src.times_divided;
-        date_of_birth = src.date_of_birth;
-        colour_of_birth = src.colour_of_birth;
-        tau = src.tau;
-        alive = src.alive;
-        v[0] = src.v[0];
-        v[1] = src.v[1];
-        n_copies = src.n_copies;
-        owner = src.owner;
-
+        CopyFields(src);
         chem = new double[par.n_chem];
         for (int ch = 0; ch < par.n_chem; ch++)
             chem[ch] = src.chem[ch];
+    }
 
-        colour = src.colour;
-        fit_ellipse = src.fit_ellipse;
+    //! Move constructor, takes over the chemicals of src.
+    Cell(Cell &&src)
+    {
+        CopyFields(src);
+        chem = src.chem;
+        src.chem = nullptr;
     }
 
     /*! \brief Add a new cell to the dish.
@@ -333,13 +324,13 @@ public:
         target_area = 0;
     }
     // used internally by class CellularPotts
-    inline double AddSiteToMoments(int x, int y)
+    inline void AddSiteToMoments(int x, int y)
     {
         fit_ellipse.add_site({x, y});
     }
 
     // used internally by class CellularPotts
-    inline double RemoveSiteFromMoments(int x, int y)
+    inline void RemoveSiteFromMoments(int x, int y)
     {
         fit_ellipse.remove_site({x, y});
     }
@@ -445,6 +436,37 @@ public:
     }
 
 protected:
+    //! Copy all but the chemicals of src, and count the new instance
+    void CopyFields(const Cell &src)
+    {
+        sigma = src.sigma;
+        amount++;
+        area = src.area;
+        target_area = src.target_area;
+        adhesive_area = src.adhesive_area;
+        ref_adhesive_area = src.ref_adhesive_area;
+        perimeter = src.perimeter;
+        target_perimeter = src.target_perimeter;
+        target_length = src.target_length;
+        growth_threshold = src.growth_threshold;
+        mother = src.mother;
+        daughter = src.daughter;
+        times_divided = src.times_divided;
+        date_of_birth = src.date_of_birth;
+        colour_of_birth = src.colour_of_birth;
+        tau = src.tau;
+        alive = src.alive;
+        v[0] = src.v[0];
+        v[1] = src.v[1];
+        n_copies = src.n_copies;
+        owner = src.owner;
+        colour = src.colour;
+        fit_ellipse = src.fit_ellipse;
+        lambda_act = src.lambda_act;
+        polarity = src.polarity;
+        previous_center_of_mass = src.previous_center_of_mass;
+    }
+
     FitEllipse fit_ellipse;
     int colour;
     bool alive;
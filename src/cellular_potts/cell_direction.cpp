@@ -113,6 +113,10 @@ Vec2<double> FitEllipse::minor_axis() const
 
 double FitEllipse::length() const
 {
+    // a cell that loses its last site has no length, rather than NaN, so
+    // that the copy that makes it disappear has a finite energy change
+    if (area_ == 0)
+        return 0.0;
     InertiaTensor I(sum_x_, sum_y_, sum_xx_, sum_yy_, sum_xy_, area_);
     return std::sqrt(4 * I.largest_eigenvalue() / (1.0 * area_));
 }
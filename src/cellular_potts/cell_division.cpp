@@ -1,76 +1,69 @@
 #include "cell_division.hpp"
 #include "cell.hpp"
+#include "cell_pool.hpp"
 #include "parameter.hpp"
-#include <unordered_map>
+#include <algorithm>
+#include <utility>
 #include <vector>
 
 extern Parameter par;
 namespace
 {
-    Cell *CreateNewCell(std::vector<Cell> &cells, int mother)
+    Cell *CreateNewCell(CellPool &cells, int mother)
     {
-        Cell new_cell;
+        Cell &new_cell = cells.emplace_back();
         new_cell.CellBirth(cells[mother]);
-        cells.push_back(new_cell);
-        return &cells.back();
+        return &new_cell;
     }
-
-    struct CellToDivide
-    {
-        CellToDivide() : divide_axis(), center(), daughter_spin(){};
-        Vec2<double> divide_axis;
-        Vec2<double> center;
-        int daughter_spin;
-    };
 }
 
-void DivideCells(std::vector<bool> which_cells, std::vector<Cell> &cells,
-                 int **sigma)
+void DivideCells(std::vector<bool> which_cells, CellPool &cells,
+                 SpinLattice &sigma, const CellPixels &pixels,
+                 const std::function<void(int, int, int)> &spin_changed)
 {
+    // Daughters are numbered in the order in which a scan of the lattice, x
+    // first, meets their mothers. The first pixel of a cell in that order
+    // has no neighbour of the same cell at x - 1, so it is on the boundary.
+    std::vector<std::pair<CellPixels::Pixel, int>> mothers;
+    const int n_cells = std::min<int>(which_cells.size(), pixels.Cells());
+    for (int spin = 1; spin < n_cells; spin++)
+    {
+        const auto &boundary = pixels.Boundary(spin);
+        if (which_cells[spin] && !boundary.empty())
+            mothers.emplace_back(
+                *std::min_element(boundary.begin(), boundary.end()), spin);
+    }
+    std::sort(mothers.begin(), mothers.end());
 
-    std::vector<CellToDivide> division_flags(cells.size());
+    for (const auto &first_pixel : mothers)
+    {
+        const int spin = first_pixel.second;
+        Cell *mother = &cells[spin];
+        Cell *daughter = CreateNewCell(cells, spin);
+        const Vec2<double> divide_axis = mother->MinorAxisVector();
+        const Vec2<double> center = mother->CenterVector();
 
-    for (int i = 0; i < par.sizex; i++)
-        for (int j = 0; j < par.sizey; j++)
+        // a copy, because moving pixels to the daughter changes the list
+        const std::vector<CellPixels::Pixel> mother_pixels =
+            pixels.Pixels(spin);
+        for (const auto &pixel : mother_pixels)
         {
-            auto spin = sigma[i][j];
-            if (spin <= 0 || !which_cells[spin])
-                continue;
-
-            Cell *daughter = nullptr;
-            Cell *mother = &cells[spin];
+            const int i = pixel[0], j = pixel[1];
+            auto relativecoords = Vec2<double>(1.0 * i, 1.0 * j) - center;
 
-            if (division_flags[spin].daughter_spin == 0)
-            {
-                daughter = CreateNewCell(cells, spin);
-                mother = &cells[spin];
-                division_flags[spin].daughter_spin = daughter->Sigma();
-                division_flags[spin].divide_axis = mother->MinorAxisVector();
-                division_flags[spin].center = mother->CenterVector();
-            }
-            else
-            {
-                int daughter_spin = division_flags[spin].daughter_spin;
-                daughter = &cells[daughter_spin];
-            }
-            // Needs to be put here, CreateNewCell invalidates all pointers
-            // because it might resize the cells vector
-            mother = &cells[spin];
-            auto const &div_flag = division_flags[spin];
-            auto relativecoords =
-                Vec2<double>(1.0 * i, 1.0 * j) - div_flag.center;
-
-            if (div_flag.divide_axis.y * relativecoords.x -
-                    div_flag.divide_axis.x * relativecoords.y >
+            if (divide_axis.y * relativecoords.x -
+                    divide_axis.x * relativecoords.y >
                 0)
             {
                 mother->DecrementArea();
                 mother->DecrementTargetArea();
                 mother->RemoveSiteFromMoments(i, j);
-                sigma[i][j] = daughter->Sigma();
+                sigma(i, j) = daughter->Sigma();
                 daughter->AddSiteToMoments(i, j);
                 daughter->IncrementArea();
                 daughter->IncrementTargetArea();
+                spin_changed(i, j, spin);
             }
         }
-}
\ No newline at end of file
+    }
+}
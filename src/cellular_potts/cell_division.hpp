@@ -1,17 +1,16 @@
 #pragma once
+#include <functional>
 #include <vector>
 #include "parameter.hpp"
 #include "cell.hpp"
-
-void DivideCells(std::vector<bool> which_cells, std::vector<Cell> &cells, int**sigma );
-
-
-
-
-
-
-
-
-
-
-
+#include "cell_pixels.hpp"
+#include "cell_pool.hpp"
+
+/** Divide the cells in which_cells along their minor axes.
+ *
+ * spin_changed(x, y, old_spin) is called after every pixel that moves to a
+ * daughter, and must keep pixels up to date.
+ */
+void DivideCells(std::vector<bool> which_cells, CellPool &cells,
+                 SpinLattice &sigma, const CellPixels &pixels,
+                 const std::function<void(int, int, int)> &spin_changed);
@@ -0,0 +1,137 @@
+#include "cell_pixels.hpp"
+
+namespace
+{
+    const int orthogonal_x[4] = {0, 1, 0, -1};
+    const int orthogonal_y[4] = {-1, 0, 1, 0};
+}
+
+const std::vector<CellPixels::Pixel> CellPixels::none_;
+
+void CellPixels::Build(const SpinLattice &sigma, int sizex, int sizey,
+                       bool periodic)
+{
+    sizex_ = sizex;
+    sizey_ = sizey;
+    periodic_ = periodic;
+    pixels_.clear();
+    boundary_.clear();
+    pixel_position_.assign((sizex - 2) * (sizey - 2), -1);
+    boundary_position_.assign((sizex - 2) * (sizey - 2), -1);
+    for (int x = 1; x < sizex - 1; x++)
+        for (int y = 1; y < sizey - 1; y++)
+        {
+            const int cell = sigma(x, y);
+            if (cell <= 0)
+                continue;
+            Add(pixels_, pixel_position_, cell, x, y);
+            if (OnBoundary(sigma, x, y))
+                Add(boundary_, boundary_position_, cell, x, y);
+        }
+    live_ = true;
+}
+
+void CellPixels::Update(const SpinLattice &sigma, int x, int y, int old_spin)
+{
+    const int spin = sigma(x, y);
+    if (spin == old_spin)
+        return;
+    if (old_spin > 0)
+    {
+        Remove(pixels_, pixel_position_, old_spin, x, y);
+        Remove(boundary_, boundary_position_, old_spin, x, y);
+    }
+    if (spin > 0)
+        Add(pixels_, pixel_position_, spin, x, y);
+
+    // only (x,y) and its orthogonal neighbours can enter or leave the
+    // boundary
+    UpdateBoundary(sigma, x, y);
+    for (int i = 0; i < 4; i++)
+    {
+        int xn = x + orthogonal_x[i];
+        int yn = y + orthogonal_y[i];
+        if (periodic_)
+        {
+            xn = (xn < 1) ? sizex_ - 2 : (xn > sizex_ - 2) ? 1 : xn;
+            yn = (yn < 1) ? sizey_ - 2 : (yn > sizey_ - 2) ? 1 : yn;
+        }
+        else if (xn < 1 || yn < 1 || xn > sizex_ - 2 || yn > sizey_ - 2)
+            continue;
+        // a neighbour of old_spin now touches another spin, one of spin may
+        // have lost its last different neighbour, and any other neighbour
+        // was and stays on the boundary
+        const int neighbour = sigma(xn, yn);
+        if (neighbour <= 0)
+            continue;
+        if (neighbour == old_spin)
+        {
+            if (boundary_position_[Site(xn, yn)] == -1)
+                Add(boundary_, boundary_position_, neighbour, xn, yn);
+        }
+        else if (neighbour == spin)
+            UpdateBoundary(sigma, xn, yn);
+    }
+}
+
+bool CellPixels::OnBoundary(const SpinLattice &sigma, int x, int y) const
+{
+    const int cell = sigma(x, y);
+    for (int i = 0; i < 4; i++)
+    {
+        int xn = x + orthogonal_x[i];
+        int yn = y + orthogonal_y[i];
+        if (periodic_)
+        {
+            xn = (xn < 1) ? sizex_ - 2 : (xn > sizex_ - 2) ? 1 : xn;
+            yn = (yn < 1) ? sizey_ - 2 : (yn > sizey_ - 2) ? 1 : yn;
+        }
+        else if (xn < 1 || yn < 1 || xn > sizex_ - 2 || yn > sizey_ - 2)
+            return true;
+        if (sigma(xn, yn) != cell)
+            return true;
+    }
+    return false;
+}
+
+void CellPixels::UpdateBoundary(const SpinLattice &sigma, int x, int y)
+{
+    const int cell = sigma(x, y);
+    if (cell <= 0)
+        return;
+    const bool listed = boundary_position_[Site(x, y)] != -1;
+    if (OnBoundary(sigma, x, y))
+    {
+        if (!listed)
+            Add(boundary_, boundary_position_, cell, x, y);
+    }
+    else if (listed)
+        Remove(boundary_, boundary_position_, cell, x, y);
+}
+
+void CellPixels::Add(std::vector<std::vector<Pixel>> &lists,
+                     std::vector<int> &position, int cell, int x, int y)
+{
+    if (cell >= Cells())
+    {
+        pixels_.resize(cell + 1);
+        boundary_.resize(cell + 1);
+    }
+    position[Site(x, y)] = static_cast<int>(lists[cell].size());
+    lists[cell].push_back({x, y});
+}
+
+void CellPixels::Remove(std::vector<std::vector<Pixel>> &lists,
+                        std::vector<int> &position, int cell, int x, int y)
+{
+    const int i = position[Site(x, y)];
+    if (i == -1)
+        return;
+    // move the last pixel of the cell into the hole
+    std::vector<Pixel> &list = lists[cell];
+    const Pixel last = list.back();
+    list[i] = last;
+    position[Site(last[0], last[1])] = i;
+    list.pop_back();
+    position[Site(x, y)] = -1;
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <array>
+#include <vector>
+
+#include "spin_lattice.hpp"
+
+/** @brief The pixels and the boundary pixels of every cell.
+ *
+ * Lets passes over the pixels of a cell take time proportional to the size
+ * of the cell rather than the lattice. A pixel is on the boundary if one of
+ * its four orthogonal neighbours has a different spin, or is outside the
+ * lattice. The medium is not indexed.
+ *
+ * Each list comes with a per-site index into it, so that pixels are moved
+ * between cells in O(1) as spins change. The lists are built from sigma by
+ * Build(), and kept up to date by calling Update() after every change of a
+ * spin until Stop().
+ */
+class CellPixels
+{
+public:
+    using Pixel = std::array<int, 2>;
+
+    /** @brief Index the pixels in [1, sizex-1) x [1, sizey-1) of sigma, and
+     * keep the index up to date until Stop()
+     */
+    void Build(const SpinLattice &sigma, int sizex, int sizey, bool periodic);
+
+    //! @brief Stop keeping the index up to date, e.g. after bulk changes
+    void Stop() { live_ = false; }
+
+    //! @brief Whether the index is being kept up to date
+    bool Live() const { return live_; }
+
+    //! @brief Move (x,y) from cell old_spin to its current spin in sigma
+    void Update(const SpinLattice &sigma, int x, int y, int old_spin);
+
+    //! @brief Number of cell ids with a list, including cells without pixels
+    int Cells() const { return static_cast<int>(pixels_.size()); }
+
+    //! @brief The pixels of cell, in no particular order
+    const std::vector<Pixel> &Pixels(int cell) const
+    {
+        return cell < Cells() ? pixels_[cell] : none_;
+    }
+
+    //! @brief The boundary pixels of cell, in no particular order
+    const std::vector<Pixel> &Boundary(int cell) const
+    {
+        return cell < Cells() ? boundary_[cell] : none_;
+    }
+
+private:
+    int Site(int x, int y) const { return (x - 1) * (sizey_ - 2) + (y - 1); }
+    bool OnBoundary(const SpinLattice &sigma, int x, int y) const;
+    void UpdateBoundary(const SpinLattice &sigma, int x, int y);
+    void Add(std::vector<std::vector<Pixel>> &lists,
+             std::vector<int> &position, int cell, int x, int y);
+    void Remove(std::vector<std::vector<Pixel>> &lists,
+                std::vector<int> &position, int cell, int x, int y);
+
+    bool live_ = false;
+    int sizex_ = 0;
+    int sizey_ = 0;
+    bool periodic_ = false;
+    std::vector<std::vector<Pixel>> pixels_;
+    std::vector<std::vector<Pixel>> boundary_;
+    // position of each site in the lists of its cell, or -1
+    std::vector<int> pixel_position_;
+    std::vector<int> boundary_position_;
+    static const std::vector<Pixel> none_;
+};
@@ -0,0 +1,165 @@
+#pragma once
+#include "cell.hpp"
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/** @brief The cells of a Dish, indexed by their sigma.
+ *
+ * Cells are constructed in place in chunks of fixed size, which are never
+ * moved. Unlike with a std::vector<Cell>, adding cells therefore never copies
+ * the existing ones, and pointers and references to cells stay valid until
+ * the pool is cleared or compacted. The index of a cell is a stable handle to
+ * it as well.
+ *
+ * The interface is the part of std::vector that the models use.
+ */
+class CellPool
+{
+    static constexpr std::size_t chunk_bits = 8;
+    static constexpr std::size_t chunk_size = std::size_t(1) << chunk_bits;
+    using Slot = std::aligned_storage_t<sizeof(Cell), alignof(Cell)>;
+
+    template <typename Pool, typename Value> class Iterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = Cell;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Value *;
+        using reference = Value &;
+
+        Iterator() = default;
+        Iterator(Pool *pool, std::size_t i) : pool_(pool), i_(i) {}
+        // an iterator converts to a const_iterator
+        operator Iterator<const Pool, const Value>() const
+        {
+            return {pool_, i_};
+        }
+
+        reference operator*() const { return (*pool_)[i_]; }
+        pointer operator->() const { return &(*pool_)[i_]; }
+        reference operator[](difference_type n) const
+        {
+            return (*pool_)[i_ + n];
+        }
+
+        Iterator &operator++() { ++i_; return *this; }
+        Iterator &operator--() { --i_; return *this; }
+        Iterator operator++(int) { return {pool_, i_++}; }
+        Iterator operator--(int) { return {pool_, i_--}; }
+        Iterator &operator+=(difference_type n) { i_ += n; return *this; }
+        Iterator &operator-=(difference_type n) { i_ -= n; return *this; }
+        Iterator operator+(difference_type n) const { return {pool_, i_ + n}; }
+        Iterator operator-(difference_type n) const { return {pool_, i_ - n}; }
+        difference_type operator-(const Iterator &o) const
+        {
+            return difference_type(i_) - difference_type(o.i_);
+        }
+
+        bool operator==(const Iterator &o) const { return i_ == o.i_; }
+        bool operator!=(const Iterator &o) const { return i_ != o.i_; }
+        bool operator<(const Iterator &o) const { return i_ < o.i_; }
+        bool operator>(const Iterator &o) const { return i_ > o.i_; }
+        bool operator<=(const Iterator &o) const { return i_ <= o.i_; }
+        bool operator>=(const Iterator &o) const { return i_ >= o.i_; }
+
+    private:
+        Pool *pool_ = nullptr;
+        std::size_t i_ = 0;
+    };
+
+public:
+    using value_type = Cell;
+    using size_type = std::size_t;
+    using reference = Cell &;
+    using const_reference = const Cell &;
+    using iterator = Iterator<CellPool, Cell>;
+    using const_iterator = Iterator<const CellPool, const Cell>;
+
+    CellPool() = default;
+    CellPool(const CellPool &) = delete;
+    CellPool &operator=(const CellPool &) = delete;
+    ~CellPool() { clear(); }
+
+    //! @brief Construct a new cell at the end, and return it
+    template <typename... Args> Cell &emplace_back(Args &&...args)
+    {
+        if (size_ == chunks_.size() * chunk_size)
+            chunks_.emplace_back(new Slot[chunk_size]);
+        Cell *cell = new (SlotOf(size_)) Cell(std::forward<Args>(args)...);
+        size_++;
+        return *cell;
+    }
+
+    void push_back(const Cell &cell) { emplace_back(cell); }
+    void push_back(Cell &&cell) { emplace_back(std::move(cell)); }
+
+    //! @brief Destroy all cells, keeping the memory for reuse
+    void clear()
+    {
+        while (size_ > 0)
+            (*this)[--size_].~Cell();
+    }
+
+    /** @brief Keep only the cells i with new_index[i] != -1, and move them
+     * to new_index[i].
+     *
+     * The new indices must increase with i. Pointers and references to the
+     * cells that moved are invalidated.
+     */
+    void Compact(const std::vector<int> &new_index)
+    {
+        size_type n = 0;
+        for (size_type i = 0; i < size_; i++)
+        {
+            if (new_index[i] == -1)
+                continue;
+            const size_type j = new_index[i];
+            if (j != i)
+            {
+                // slot j holds a removed cell, or one that has moved already
+                (*this)[j].~Cell();
+                new (SlotOf(j)) Cell(std::move((*this)[i]));
+            }
+            n = j + 1;
+        }
+        while (size_ > n)
+            (*this)[--size_].~Cell();
+    }
+
+    size_type size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    Cell &operator[](size_type i)
+    {
+        return *std::launder(reinterpret_cast<Cell *>(SlotOf(i)));
+    }
+    const Cell &operator[](size_type i) const
+    {
+        return *std::launder(reinterpret_cast<const Cell *>(SlotOf(i)));
+    }
+
+    Cell &front() { return (*this)[0]; }
+    const Cell &front() const { return (*this)[0]; }
+    Cell &back() { return (*this)[size_ - 1]; }
+    const Cell &back() const { return (*this)[size_ - 1]; }
+
+    iterator begin() { return {this, 0}; }
+    iterator end() { return {this, size_}; }
+    const_iterator begin() const { return {this, 0}; }
+    const_iterator end() const { return {this, size_}; }
+
+private:
+    Slot *SlotOf(size_type i) const
+    {
+        return &chunks_[i >> chunk_bits][i & (chunk_size - 1)];
+    }
+
+    std::vector<std::unique_ptr<Slot[]>> chunks_;
+    size_type size_ = 0;
+};
@@ -0,0 +1,223 @@
+#include "ca.hpp"
+#include "parameter.hpp"
+#include "counter_rng.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+extern Parameter par;
+
+namespace
+{
+    // One row or column of checkerboard tiles, [begin, end) in lattice
+    // coordinates
+    struct TileSpan
+    {
+        int begin, end;
+        int colour;
+    };
+
+    /* Cut [first, first + length) into spans of at least min_width sites and
+       colour them alternately. On a periodic lattice with an odd number of
+       spans the first and last span touch, so the last one gets a third
+       colour. */
+    std::vector<TileSpan> MakeTileSpans(int first, int length, int min_width,
+                                        bool periodic)
+    {
+        int n = std::max(1, length / min_width);
+        std::vector<TileSpan> spans(n);
+        for (int i = 0; i < n; i++)
+        {
+            spans[i].begin = first + static_cast<int>(
+                                         static_cast<long>(i) * length / n);
+            spans[i].end = first + static_cast<int>(
+                                       static_cast<long>(i + 1) * length / n);
+            spans[i].colour = i % 2;
+        }
+        if (periodic && n > 1 && n % 2 == 1)
+            spans[n - 1].colour = 2;
+        return spans;
+    }
+
+    struct Tile
+    {
+        int x0, x1, y0, y1;
+        int index;
+    };
+
+    // An accepted copy of spin into (x,y), to be replayed serially
+    struct CopyRecord
+    {
+        int x, y;
+        int spin;
+    };
+}
+
+int CellularPotts::CheckerboardAmoebaeMove(PDE *PDEfield, bool anneal)
+{
+    thetime++;
+    if (frozen)
+        return 0;
+
+    // Sites of tiles of the same colour are at least one tile width apart,
+    // which must exceed the reach of a copy attempt: the neighbourhood of
+    // the target site plus the source site.
+    const int range = (n_nb > 8) ? 2 : 1;
+    const int min_width = std::max(par.cpm_tile_size, 2 * range);
+    const bool periodic = par.periodic_boundaries;
+
+    auto xspans = MakeTileSpans(1, sizex - 2, min_width, periodic);
+    auto yspans = MakeTileSpans(1, sizey - 2, min_width, periodic);
+
+    // group tiles by colour
+    std::vector<std::vector<Tile>> phases(9);
+    int n_tiles = 0;
+    for (const auto &xs : xspans)
+        for (const auto &ys : yspans)
+            phases[xs.colour * 3 + ys.colour].push_back(
+                {xs.begin, xs.end, ys.begin, ys.end, n_tiles++});
+
+    ThreadPool &pool = WorkerPool();
+    int SumDH = 0;
+    // the pixel index and contact graph are shared between tiles, so
+    // rebuild them afterwards rather than update them from the threads
+    cell_pixels.Stop();
+    contact_graph.Stop();
+
+    for (auto &tiles : phases)
+    {
+        if (tiles.empty())
+            continue;
+
+        std::vector<std::vector<CopyRecord>> copies(tiles.size());
+        std::vector<int> tile_dh(tiles.size(), 0);
+        std::vector<EnergyTerms> tile_energy(tiles.size());
+
+        pool.ParallelFor(static_cast<int>(tiles.size()), [&](int t) {
+            const Tile &tile = tiles[t];
+            const int w = tile.x1 - tile.x0;
+            const int h = tile.y1 - tile.y0;
+            const int attempts = w * h;
+
+            // Each tile draws from its own substream, keyed by MCS and tile
+            // index, so the result doesn't depend on which thread runs it.
+            CounterRNG rng(cpm_rng.Seed(),
+                           (static_cast<std::uint64_t>(thetime) << 32) |
+                               static_cast<std::uint32_t>(tile.index));
+            thread_local std::vector<double> uniforms;
+            uniforms.resize(3 * attempts);
+            rng.Fill(uniforms.data(), uniforms.size());
+
+            for (int a = 0; a < attempts; a++)
+            {
+                const double *u = &uniforms[3 * a];
+                int site = static_cast<int>(u[0] * attempts);
+                int x = tile.x0 + site % w;
+                int y = tile.y0 + site / w;
+                int k = 1 + static_cast<int>(u[1] * n_nb);
+                int xp = x + nx[k];
+                int yp = y + ny[k];
+                if (periodic)
+                {
+                    if (xp <= 0)
+                        xp = sizex - 2 + xp;
+                    if (yp <= 0)
+                        yp = sizey - 2 + yp;
+                    if (xp >= sizex - 1)
+                        xp = xp - sizex + 2;
+                    if (yp >= sizey - 1)
+                        yp = yp - sizey + 2;
+                }
+
+                int sxy = sigma(x, y);
+                int sxyp = sigma(xp, yp);
+                if (sxyp == -1 || sxyp == sxy)
+                    continue;
+
+                if (not(LocalConnectedness(x, y, sxy) &&
+                        LocalConnectedness(x, y, sxyp)))
+                    continue;
+
+                // Cells may extend over several tiles of this colour, so
+                // their areas and moments are shared between threads.
+                int la = (sxy > 0) ? sxy % n_cell_locks : -1;
+                int lb = (sxyp > 0) ? sxyp % n_cell_locks : -1;
+                if (la > lb)
+                    std::swap(la, lb);
+                if (la == lb)
+                    la = -1;
+                std::unique_lock<std::mutex> lock_a, lock_b;
+                if (la >= 0)
+                    lock_a = std::unique_lock<std::mutex>(cell_locks[la]);
+                if (lb >= 0)
+                    lock_b = std::unique_lock<std::mutex>(cell_locks[lb]);
+
+                EnergyTerms dh;
+                int D_H = DeltaH(x, y, xp, yp, PDEfield, nullptr,
+                                 energy_live ? &dh : nullptr);
+                if (CopyvProb(D_H, 0, anneal, u[2]) > 0)
+                {
+                    ConvertSpin(x, y, xp, yp);
+                    copies[t].push_back({x, y, sxyp});
+                    tile_dh[t] += D_H;
+                    tile_energy[t] += dh;
+                }
+            }
+        });
+
+        // replay the accepted copies in a fixed order
+        for (size_t t = 0; t < tiles.size(); t++)
+        {
+            for (const auto &copy : copies[t])
+            {
+                if (copy.spin > 0)
+                {
+                    act_field.SetValue({copy.x, copy.y}, par.max_Act);
+                    history.add_extension({copy.x, copy.y}, copy.spin);
+                }
+                else
+                    act_field.SetValue({copy.x, copy.y}, 0);
+                if (edgelist)
+                    UpdateEdgesOfSite(copy.x, copy.y);
+            }
+            SumDH += tile_dh[t];
+            energy += tile_energy[t];
+        }
+    }
+
+    history.validate(sigma);
+    act_field.Decrease();
+    return SumDH;
+}
+
+void CellularPotts::UpdateEdgesOfSite(int x, int y)
+{
+    int site = (x - 1) + (y - 1) * (sizex - 2);
+    for (int j = 1; j <= n_nb; j++)
+    {
+        // border sites in the halo never have edges
+        int sn = sigma(x + nx[j], y + ny[j]);
+        int edge = site * n_nb + j - 1;
+        bool boundary = sn != sigma(x, y) && sn != -1;
+        if (edgelist[edge] == -1 && boundary)
+            AddEdgeToEdgelist(edge);
+        else if (edgelist[edge] != -1 && !boundary)
+            RemoveEdgeFromEdgelist(edge);
+    }
+}
+
+void CellularPotts::ReportMCSRate(std::chrono::steady_clock::duration elapsed)
+{
+    mcs_rate_elapsed += elapsed;
+    if (++mcs_rate_count < par.mcs_rate_report_interval)
+        return;
+
+    double seconds = std::chrono::duration<double>(mcs_rate_elapsed).count();
+    int threads =
+        (par.cpm_update_scheme == "checkerboard") ? WorkerPool().Size() : 1;
+    std::cerr << "[ " << mcs_rate_count / seconds << " MCS/s, "
+              << par.cpm_update_scheme << ", " << threads << " thread(s) ]\n";
+    mcs_rate_count = 0;
+    mcs_rate_elapsed = std::chrono::steady_clock::duration::zero();
+}
@@ -0,0 +1,141 @@
+#include "contact_graph.hpp"
+
+namespace
+{
+    const int orthogonal_x[4] = {0, 1, 0, -1};
+    const int orthogonal_y[4] = {-1, 0, 1, 0};
+}
+
+const std::vector<ContactGraph::Contact> ContactGraph::none_;
+
+void ContactGraph::Build(const SpinLattice &sigma, int sizex, int sizey,
+                         bool periodic)
+{
+    sizex_ = sizex;
+    sizey_ = sizey;
+    periodic_ = periodic;
+    contacts_.clear();
+    // visit every edge once, from the site below or to the left of it
+    for (int x = 1; x < sizex - 1; x++)
+        for (int y = 1; y < sizey - 1; y++)
+        {
+            const int spin = sigma(x, y);
+            int xn = x + 1, yn = y + 1;
+            if (periodic)
+            {
+                if (xn > sizex - 2)
+                    xn = 1;
+                if (yn > sizey - 2)
+                    yn = 1;
+            }
+            if (xn <= sizex - 2 && sigma(xn, y) != spin)
+                AddToInterface(spin, sigma(xn, y), 1);
+            if (yn <= sizey - 2 && sigma(x, yn) != spin)
+                AddToInterface(spin, sigma(x, yn), 1);
+        }
+    live_ = true;
+}
+
+void ContactGraph::Update(const SpinLattice &sigma, int x, int y, int old_spin)
+{
+    const int spin = sigma(x, y);
+    if (spin == old_spin)
+        return;
+    for (int i = 0; i < 4; i++)
+    {
+        int xn = x + orthogonal_x[i];
+        int yn = y + orthogonal_y[i];
+        if (periodic_)
+        {
+            xn = (xn < 1) ? sizex_ - 2 : (xn > sizex_ - 2) ? 1 : xn;
+            yn = (yn < 1) ? sizey_ - 2 : (yn > sizey_ - 2) ? 1 : yn;
+        }
+        else if (xn < 1 || yn < 1 || xn > sizex_ - 2 || yn > sizey_ - 2)
+            continue;
+        const int neighbour = sigma(xn, yn);
+        if (neighbour != old_spin)
+            AddToInterface(old_spin, neighbour, -1);
+        if (neighbour != spin)
+            AddToInterface(spin, neighbour, 1);
+    }
+}
+
+int ContactGraph::InterfaceLength(int a, int b) const
+{
+    if (a >= Spins() || b >= Spins())
+        return 0;
+    if (contacts_[a].size() <= contacts_[b].size())
+    {
+        const int i = Find(a, b);
+        return i == -1 ? 0 : contacts_[a][i].length;
+    }
+    const int j = Find(b, a);
+    return j == -1 ? 0 : contacts_[b][j].length;
+}
+
+void ContactGraph::Write(std::ostream &os) const
+{
+    for (int a = 0; a < Spins(); a++)
+        for (const Contact &contact : contacts_[a])
+            if (a < contact.spin)
+                os << a << ' ' << contact.spin << ' ' << contact.length
+                   << '\n';
+}
+
+void ContactGraph::AddToInterface(int a, int b, int delta)
+{
+    if (a >= Spins() || b >= Spins())
+        contacts_.resize((a > b ? a : b) + 1);
+    std::vector<Contact> &list_a = contacts_[a];
+    std::vector<Contact> &list_b = contacts_[b];
+
+    // search the shorter list, and follow the twin into the other one
+    int i, j;
+    if (list_a.size() <= list_b.size())
+    {
+        i = Find(a, b);
+        j = (i == -1) ? -1 : list_a[i].twin;
+    }
+    else
+    {
+        j = Find(b, a);
+        i = (j == -1) ? -1 : list_b[j].twin;
+    }
+
+    if (i == -1)
+    {
+        const int n_a = static_cast<int>(list_a.size());
+        const int n_b = static_cast<int>(list_b.size());
+        list_a.push_back({b, delta, n_b});
+        list_b.push_back({a, delta, n_a});
+        return;
+    }
+    list_a[i].length += delta;
+    list_b[j].length += delta;
+    if (list_a[i].length == 0)
+    {
+        Erase(a, i);
+        Erase(b, j);
+    }
+}
+
+int ContactGraph::Find(int a, int b) const
+{
+    const std::vector<Contact> &list = contacts_[a];
+    for (int i = 0; i < static_cast<int>(list.size()); i++)
+        if (list[i].spin == b)
+            return i;
+    return -1;
+}
+
+void ContactGraph::Erase(int a, int i)
+{
+    // move the last contact into the hole, and tell its twin
+    std::vector<Contact> &list = contacts_[a];
+    if (i != static_cast<int>(list.size()) - 1)
+    {
+        list[i] = list.back();
+        contacts_[list[i].spin][list[i].twin].twin = i;
+    }
+    list.pop_back();
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <ostream>
+#include <vector>
+
+#include "spin_lattice.hpp"
+
+/** @brief Which spins touch, and along how many pixel edges.
+ *
+ * Two spins are in contact along an edge if they are on orthogonally
+ * neighbouring sites. For every spin, including the medium but not the
+ * border, the graph stores the spins it touches with the length of each
+ * interface. Listing the contacts of a cell takes O(degree), and memory grows
+ * with the number of contacts rather than with the square of the number of
+ * cells. Each contact knows where its reverse is, so that changing an
+ * interface takes the smaller of the degrees of its two spins; the medium
+ * touches most cells.
+ *
+ * The graph is built from sigma by Build(), and kept up to date by calling
+ * Update() after every change of a spin until Stop().
+ */
+class ContactGraph
+{
+public:
+    //! @brief A neighbouring spin and the length of the interface with it
+    struct Contact
+    {
+        int spin;
+        int length;
+        //! Position of the reverse contact in the list of spin
+        int twin;
+    };
+
+    /** @brief Find the contacts in [1, sizex-1) x [1, sizey-1) of sigma, and
+     * keep them up to date until Stop()
+     */
+    void Build(const SpinLattice &sigma, int sizex, int sizey, bool periodic);
+
+    //! @brief Stop keeping the graph up to date, e.g. after bulk changes
+    void Stop() { live_ = false; }
+
+    //! @brief Whether the graph is being kept up to date
+    bool Live() const { return live_; }
+
+    //! @brief Account for the change of (x,y) from old_spin to its spin
+    void Update(const SpinLattice &sigma, int x, int y, int old_spin);
+
+    //! @brief Number of spins with a list, including spins without contacts
+    int Spins() const { return static_cast<int>(contacts_.size()); }
+
+    //! @brief The contacts of spin, in no particular order
+    const std::vector<Contact> &Contacts(int spin) const
+    {
+        return spin < Spins() ? contacts_[spin] : none_;
+    }
+
+    //! @brief Number of edges between a and b, zero if they do not touch
+    int InterfaceLength(int a, int b) const;
+
+    /** @brief Write one line "a b length" for every pair of spins in
+     * contact, with a < b
+     */
+    void Write(std::ostream &os) const;
+
+private:
+    //! @brief Add delta to the interface between a and b, both ways
+    void AddToInterface(int a, int b, int delta);
+    //! @brief Position of the contact with b in the list of a, or -1
+    int Find(int a, int b) const;
+    //! @brief Remove the i'th contact of a, but not its twin
+    void Erase(int a, int i);
+
+    bool live_ = false;
+    int sizex_ = 0;
+    int sizey_ = 0;
+    bool periodic_ = false;
+    std::vector<std::vector<Contact>> contacts_;
+    static const std::vector<Contact> none_;
+};
@@ -51,7 +51,7 @@ const int ny2[21] = {0, -1, 0,  1,  0, -1, 1, 1, -1, -2, 0,
 
 extern Parameter par;
 
-double DeltaH::linear_area_constraint(std::vector<Cell> *cell, int sxy, int sxyp) {
+double DeltaH::linear_area_constraint(const HotCells &cells, int sxy, int sxyp) {
     double DH;
     // lambda is determined by chemical 0
     // cerr << "[" << lambda << "]";
@@ -72,7 +72,7 @@ double DeltaH::linear_area_constraint(std::vector<Cell> *cell, int sxy, int sxyp
 
 }
 
-double DeltaH::area_constraint(std::vector<Cell> *cell, int sxy, int sxyp)
+double DeltaH::area_constraint(const HotCells &cells, int sxy, int sxyp)
 {
     double DH;
     // lambda is determined by chemical 0
@@ -80,36 +80,35 @@ double DeltaH::area_constraint(std::vector<Cell> *cell, int sxy, int sxyp)
     if (sxyp == MEDIUM)
     {
         DH = (double)(par.lambda *
-                      (1. - 2. * (double)((*cell)[sxy].Area() -
-                                          (*cell)[sxy].TargetArea())));
+                      (1. - 2. * (double)(cells.Area(sxy) -
+                                          cells.TargetArea(sxy))));
     }
     else if (sxy == MEDIUM)
     {
         DH = (double)((par.lambda *
-                       (1. + 2. * (double)((*cell)[sxyp].Area() -
-                                           (*cell)[sxyp].TargetArea()))));
+                       (1. + 2. * (double)(cells.Area(sxyp) -
+                                           cells.TargetArea(sxyp)))));
     }
     else
         DH = (double)((
             par.lambda *
             (2. +
-             2. * (double)((*cell)[sxyp].Area() - (*cell)[sxyp].TargetArea() -
-                           (*cell)[sxy].Area() + (*cell)[sxy].TargetArea()))));
+             2. * (double)(cells.Area(sxyp) - cells.TargetArea(sxyp) -
+                           cells.Area(sxy) + cells.TargetArea(sxy)))));
 
     return DH;
 }
 
-double DeltaH::chemotaxis(int x, int y, int xp, int yp, PDE *PDEfield)
+double DeltaH::chemotaxis(int x, int y, int xp, int yp,
+                          const ChemotaxisPotential &potential, int type)
 {
-    double DDH;
-    DDH = -(double)(par.chemotaxis * (sat2(PDEfield->get_PDEvars(0, x, y)) -
-                                      sat2(PDEfield->get_PDEvars(0, xp, yp))));
-    return DDH;
+    return (double)potential.Value(type, xp, yp) -
+           (double)potential.Value(type, x, y);
 }
 
 double DeltaH::contact_energy(int n_nb, int x, int y, int xp, int yp,
-                              int **sigma, std::vector<Cell> *cell, int sxy,
-                              int sxyp)
+                              const SpinLattice &sigma, const HotCells &cells,
+                              int sxy, int sxyp)
 {
     double DH;
     int i;
@@ -117,31 +116,9 @@ double DeltaH::contact_energy(int n_nb, int x, int y, int xp, int yp,
     DH = 0;
     for (i = 1; i <= n_nb; i++)
     {
-        int xp2, yp2;
-        xp2 = x + nx2[i];
-        yp2 = y + ny2[i];
-        if (par.periodic_boundaries)
-        {
-            // since we are asynchronic, we cannot just copy the borders
-            // once every MCS
-            if (xp2 <= 0)
-                xp2 = par.sizex - 2 + xp2;
-            if (yp2 <= 0)
-                yp2 = par.sizey - 2 + yp2;
-            if (xp2 >= par.sizex - 1)
-                xp2 = xp2 - par.sizex + 2;
-            if (yp2 >= par.sizey - 1)
-                yp2 = yp2 - par.sizey + 2;
-            neighsite = sigma[xp2][yp2];
-        }
-        else
-        {
-            if (xp2 <= 0 || yp2 <= 0 || xp2 >= par.sizex - 1 ||
-                yp2 >= par.sizey - 1)
-                neighsite = -1;
-            else
-                neighsite = sigma[xp2][yp2];
-        }
+        // sigma has a halo of border sites or periodic images, so the
+        // neighbourhood of (x,y) needs no wrapping or bounds checks
+        neighsite = sigma(x + nx2[i], y + ny2[i]);
         if (neighsite == -1)
         {
             // border
@@ -150,8 +127,8 @@ double DeltaH::contact_energy(int n_nb, int x, int y, int xp, int yp,
         }
         else
         {
-            DH += (*cell)[sxyp].EnergyDifference((*cell)[neighsite]) -
-                  (*cell)[sxy].EnergyDifference((*cell)[neighsite]);
+            DH += cells.EnergyDifference(sxyp, neighsite) -
+                  cells.EnergyDifference(sxy, neighsite);
         }
     }
     return DH;
@@ -160,10 +137,9 @@ double DeltaH::contact_energy(int n_nb, int x, int y, int xp, int yp,
 // double DeltaH_LengthConstraint
 // double DeltaH_AreaConstraintRescaled
 
-double DeltaH::sat2(double x) { return x / (par.saturation * x + 1.); }
-
-double DeltaH::classical(int n_nb, int x, int y, int xp, int yp, int **sigma,
-                         std::vector<Cell> *cell, PDE *PDEfield)
+double DeltaH::classical(int n_nb, int x, int y, int xp, int yp,
+                         const SpinLattice &sigma, const HotCells &cells,
+                         PDE *PDEfield)
 {
 
     double DH = 0;
@@ -171,12 +147,12 @@ double DeltaH::classical(int n_nb, int x, int y, int xp, int yp, int **sigma,
     int neighsite;
 
     /* Compute energydifference *IF* the copying were to occur */
-    sxy = sigma[x][y];
-    sxyp = sigma[xp][yp];
+    sxy = sigma(x, y);
+    sxyp = sigma(xp, yp);
 
-    DH += contact_energy(n_nb, x, y, xp, yp, sigma, cell, sxy, sxyp);
+    DH += contact_energy(n_nb, x, y, xp, yp, sigma, cells, sxy, sxyp);
 
-    DH += area_constraint(cell, sxy, sxyp);
+    DH += area_constraint(cells, sxy, sxyp);
 
     if (PDEfield && (par.vecadherinknockout || (sxyp == 0 || sxy == 0)))
     {
@@ -185,7 +161,8 @@ double DeltaH::classical(int n_nb, int x, int y, int xp, int yp, int **sigma,
         // only chemotactic extensions contribute to energy change
         if (!(par.extensiononly && sxyp == 0))
         {
-            DH += chemotaxis(x, y, xp, yp, PDEfield);
+            DH += chemotaxis(x, y, xp, yp, PDEfield->GetChemotaxisPotential(),
+                             cells.Tau(sxyp > 0 ? sxyp : sxy));
         }
     }
 
@@ -193,60 +170,63 @@ double DeltaH::classical(int n_nb, int x, int y, int xp, int yp, int **sigma,
 }
 
 double DeltaH::length_constraint(int n_nb, int x, int y, int xp, int yp,
-                                 int **sigma, vector<Cell> *cell, int sxy,
-                                 int sxyp)
+                                 const SpinLattice &sigma,
+                                 const HotCells &cells, int sxy, int sxyp)
+{
+    // the copy attempts have always seen this term rounded towards zero
+    return -(int)(-length_change(x, y, cells, sxy, sxyp));
+}
+
+double DeltaH::length_change(int x, int y, const HotCells &cells, int sxy,
+                             int sxyp)
 {
-    int DH = 0;
     const double lambda2 = par.lambda2;
     /* Length constraint */
     // sp is expanding cell, s is retracting cell
     if (sxyp == MEDIUM)
     {
-        DH -= (int)(lambda2 *
-                    (DSQR((*cell)[sxy].Length() - (*cell)[sxy].TargetLength()) -
-                     DSQR((*cell)[sxy].GetNewLengthIfXYWereRemoved(x, y) -
-                          (*cell)[sxy].TargetLength())));
+        return -(lambda2 *
+                 (DSQR(cells.Length(sxy) - cells.TargetLength(sxy)) -
+                  DSQR(cells.LengthIfRemoved(sxy, x, y) -
+                       cells.TargetLength(sxy))));
     }
     else if (sxy == MEDIUM)
     {
-        DH -=
-            (int)(lambda2 *
-                  (DSQR((*cell)[sxyp].Length() - (*cell)[sxyp].TargetLength()) -
-                   DSQR((*cell)[sxyp].GetNewLengthIfXYWereAdded(x, y) -
-                        (*cell)[sxyp].TargetLength())));
+        return -(lambda2 *
+                 (DSQR(cells.Length(sxyp) - cells.TargetLength(sxyp)) -
+                  DSQR(cells.LengthIfAdded(sxyp, x, y) -
+                       cells.TargetLength(sxyp))));
     }
     else
     {
-        DH -=
-            (int)(lambda2 *
-                  ((DSQR((*cell)[sxyp].Length() -
-                         (*cell)[sxyp].TargetLength()) -
-                    DSQR((*cell)[sxyp].GetNewLengthIfXYWereAdded(x, y) -
-                         (*cell)[sxyp].TargetLength())) +
-                   (DSQR((*cell)[sxy].Length() - (*cell)[sxy].TargetLength()) -
-                    DSQR((*cell)[sxy].GetNewLengthIfXYWereRemoved(x, y) -
-                         (*cell)[sxy].TargetLength()))));
+        return -(lambda2 *
+                 ((DSQR(cells.Length(sxyp) -
+                        cells.TargetLength(sxyp)) -
+                   DSQR(cells.LengthIfAdded(sxyp, x, y) -
+                        cells.TargetLength(sxyp))) +
+                  (DSQR(cells.Length(sxy) - cells.TargetLength(sxy)) -
+                   DSQR(cells.LengthIfRemoved(sxy, x, y) -
+                        cells.TargetLength(sxy)))));
     }
-    return DH;
 }
 
-double DeltaH::spreading_constraint(std::vector<Cell> *cell, int sxy, int sxyp)
+double DeltaH::spreading_constraint(const HotCells &cells, int sxy, int sxyp)
 {
     const double Ah = par.non_intergrin_binding_area;
     if (sxy == MEDIUM)
     {
-        const double A = (*cell)[sxyp].Area();
+        const double A = cells.Area(sxyp);
         return par.lambda_spread * ((A + 1.0) / (A + 1.0 + Ah) - A / (A + Ah));
     }
     else if (sxyp == MEDIUM)
     {
-        const double A = (*cell)[sxy].Area();
+        const double A = cells.Area(sxy);
         return par.lambda_spread * ((A - 1.0) / (A - 1.0 + Ah) - A / (A + Ah));
     }
     else
     { // Cell cell interaction
-        const double A_extension = (*cell)[sxyp].Area();
-        const double A_retraction = (*cell)[sxy].Area();
+        const double A_extension = cells.Area(sxyp);
+        const double A_retraction = cells.Area(sxy);
         return par.lambda_spread* ( (A_extension + 1.0) / (A_extension + 1.0 + Ah) +
                (A_retraction - 1.0) / (A_retraction - 1.0 + Ah) -
                A_extension / (A_extension + Ah) -
@@ -33,10 +33,12 @@ Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
 #include <stdio.h>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "adhesion_mover.hpp"
 #include "cell.hpp"
+#include "hot_cells.hpp"
 #include "cell_ecm_interactions.hpp"
 #include "pde.hpp"
 
@@ -48,18 +50,53 @@ Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
 
 struct DeltaH
 {
-    static double sat2(double x);
-    static double area_constraint(std::vector<Cell> *cell, int sxy, int sxyp);
-    static double linear_area_constraint(std::vector<Cell> *cell, int sxy, int sxyp);
-    static double chemotaxis(int x, int y, int xp, int yp, PDE *PDEfield);
+    //! Neighbourhood offsets, in the same order as CellularPotts::nx, ny
+    static constexpr int nb_x[21] = {0, 0,  1, 0, -1, 1, 1,  -1, -1, 0, 2,
+                                     0, -2, 1, 2, 2,  1, -1, -2, -2, -1};
+    static constexpr int nb_y[21] = {0, -1, 0,  1,  0, -1, 1, 1, -1, -2, 0,
+                                     2, 0,  -2, -1, 1, 2,  2, 1, -1, -2};
+
+    static double area_constraint(const HotCells &cells, int sxy, int sxyp);
+    static double linear_area_constraint(const HotCells &cells, int sxy, int sxyp);
+    //! @brief Chemotaxis term for a cell of the given type moving from
+    //! (xp,yp) into (x,y)
+    static double chemotaxis(int x, int y, int xp, int yp,
+                             const ChemotaxisPotential &potential, int type);
     static double contact_energy(int n_nb, int x, int y, int xp, int yp,
-                                 int **sigma, std::vector<Cell> *cell, int sxy,
-                                 int sxyp);
+                                 const SpinLattice &sigma,
+                                 const HotCells &cells, int sxy, int sxyp);
+
+    /** @brief contact_energy with the neighbourhood size fixed at compile
+     * time.
+     *
+     * The neighbour loop is unrolled into loads at constant offsets. Gives
+     * the same result as the run-time version.
+     */
+    template <int NNb>
+    static double contact_energy(int x, int y, const SpinLattice &sigma,
+                                 const HotCells &cells, int sxy, int sxyp);
     static double length_constraint(int n_nb, int x, int y, int xp, int yp,
-                                    int **sigma, std::vector<Cell> *cell, int sxy,
-                                    int sxyp);
-    static double spreading_constraint(std::vector<Cell> *cell, int sxy, int sxyp);
+                                    const SpinLattice &sigma,
+                                    const HotCells &cells, int sxy, int sxyp);
+    //! @brief The change of the length term, before length_constraint()
+    //! rounds it towards zero
+    static double length_change(int x, int y, const HotCells &cells, int sxy,
+                                int sxyp);
+    static double spreading_constraint(const HotCells &cells, int sxy, int sxyp);
+
+    static double classical(int n_nb, int x, int y, int xp, int yp,
+                            const SpinLattice &sigma, const HotCells &cells,
+                            PDE *PDEfield);
+
+private:
+    template <std::size_t... I>
+    static double contact_energy(int x, int y, const SpinLattice &sigma,
+                                 const HotCells &cells, int sxy, int sxyp,
+                                 std::index_sequence<I...>);
+
+    template <int I>
+    static double contact_term(int x, int y, const SpinLattice &sigma,
+                               const HotCells &cells, int sxy, int sxyp);
+};
 
-    static double classical(int n_nb, int x, int y, int xp, int yp, int **sigma,
-                            std::vector<Cell> *cell, PDE *PDEfield);
-};
\ No newline at end of file
+#include "deltah.tpp"
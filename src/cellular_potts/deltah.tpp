@@ -0,0 +1,38 @@
+extern Parameter par;
+
+template <int NNb>
+double DeltaH::contact_energy(int x, int y, const SpinLattice &sigma,
+                              const HotCells &cells, int sxy, int sxyp)
+{
+    static_assert(NNb == 4 || NNb == 8 || NNb == 20,
+                  "Neighbourhood must have 4, 8 or 20 sites");
+    return contact_energy(x, y, sigma, cells, sxy, sxyp,
+                          std::make_index_sequence<NNb>());
+}
+
+template <std::size_t... I>
+double DeltaH::contact_energy(int x, int y, const SpinLattice &sigma,
+                              const HotCells &cells, int sxy, int sxyp,
+                              std::index_sequence<I...>)
+{
+    double DH = 0;
+    // neighbours are summed in order, as in the run-time version
+    ((DH += contact_term<I + 1>(x, y, sigma, cells, sxy, sxyp)), ...);
+    return DH;
+}
+
+template <int I>
+double DeltaH::contact_term(int x, int y, const SpinLattice &sigma,
+                            const HotCells &cells, int sxy, int sxyp)
+{
+    // the halo of sigma holds border sites or periodic images
+    int neighsite = sigma(x + nb_x[I], y + nb_y[I]);
+    if (neighsite == -1)
+    {
+        // border
+        return (sxyp == 0 ? 0 : par.border_energy) -
+               (sxy == 0 ? 0 : par.border_energy);
+    }
+    return cells.EnergyDifference(sxyp, neighsite) -
+           cells.EnergyDifference(sxy, neighsite);
+}
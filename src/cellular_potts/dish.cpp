@@ -59,19 +59,19 @@ Dish::Dish() {
       PDEfield = new PDE(par.n_chem, par.sizex, par.sizey);
     Init();
     if (par.target_area > 0) {
-      for (std::vector<Cell>::iterator c = cell.begin(); c != cell.end(); c++) {
+      for (CellPool::iterator c = cell.begin(); c != cell.end(); c++) {
         c->SetTargetArea(par.target_area);
       }
     }
   }
   if (par.target_area > 0)
-    for (std::vector<Cell>::iterator c = cell.begin(); c != cell.end(); c++) {
+    for (CellPool::iterator c = cell.begin(); c != cell.end(); c++) {
       c->SetTargetArea(par.target_area);
       c->SetTargetPerimeter(par.target_perimeter);
     }
 
   if (par.ref_adhesive_area > 0)
-    for (std::vector<Cell>::iterator c = cell.begin(); c != cell.end(); c++) {
+    for (CellPool::iterator c = cell.begin(); c != cell.end(); c++) {
       c->SetReferenceAdhesiveArea(par.ref_adhesive_area);
     }
 }
@@ -95,7 +95,7 @@ void Dish::ConstructorBody() {
   Cell::maxsigma = 0;
 
   // Allocate the first "cell": this is the medium (tau=0)
-  cell.push_back(Cell(*this, 0));
+  cell.emplace_back(*this, 0);
 
   // indicate that the first cell is the medium
   cell.front().sigma = 0;
@@ -105,14 +105,11 @@ void Dish::ConstructorBody() {
   PDEfield = 0;
 }
 
-bool Dish::CellIsolated(const Cell &c, int **neighbours) const {
-  int i;
-  for (i = 0; i < (int)cell.size(); i++) {
-    if (neighbours[c.sigma][i] == EMPTY)
-      break;
-    else if (neighbours[c.sigma][i] > 0)
+bool Dish::CellIsolated(const Cell &c,
+                        const ContactGraph &contacts) const {
+  for (const auto &contact : contacts.Contacts(c.sigma))
+    if (contact.spin > 0)
       return false;
-  }
   return true;
 }
 
@@ -128,7 +125,7 @@ void Dish::CellGrowthAndDivision(void) {
   }
   int cell_division = 0;
 
-  vector<Cell>::iterator c;
+  CellPool::iterator c;
   for ((c = cell.begin(), c++); c != cell.end(); c++) {
 
     if ((c->Area() - c->TargetArea()) > c->GrowthThreshold()) {
@@ -148,7 +145,7 @@ void Dish::CellGrowthAndDivision(void) {
 
 int Dish::CountCells(void) const {
   int amount = 0;
-  vector<Cell>::const_iterator i;
+  CellPool::const_iterator i;
   for ((i = cell.begin(), i++); i != cell.end(); i++) {
     if (i->AliveP()) {
       amount++;
@@ -161,7 +158,7 @@ int Dish::CountCells(void) const {
 
 int Dish::Area(void) const {
   int total_area = 0;
-  vector<Cell>::const_iterator i;
+  CellPool::const_iterator i;
   for ((i = cell.begin(), i++); i != cell.end(); ++i) {
     total_area += i->Area();
   }
@@ -170,7 +167,7 @@ int Dish::Area(void) const {
 
 int Dish::TargetArea(void) const {
   int total_area = 0;
-  vector<Cell>::const_iterator i;
+  CellPool::const_iterator i;
   for ((i = cell.begin(), i++); i != cell.end(); ++i) {
     if (i->AliveP())
       total_area += i->TargetArea();
@@ -181,7 +178,7 @@ int Dish::TargetArea(void) const {
 void Dish::SetCellOwner(Cell &which_cell) { which_cell.owner = this; }
 
 void Dish::ClearGrads(void) {
-  vector<Cell>::iterator i;
+  CellPool::iterator i;
   for ((i = cell.begin(), i++); i != cell.end(); i++) {
     i->ClearGrad();
   }
@@ -192,7 +189,7 @@ int Dish::Time(void) const { return CPM->Time(); }
 
 void Dish::MeasureChemConcentrations(void) {
   // clear chemical concentrations
-  for (vector<Cell>::iterator c = cell.begin(); c != cell.end(); c++) {
+  for (CellPool::iterator c = cell.begin(); c != cell.end(); c++) {
     for (int ch = 0; ch < par.n_chem; ch++)
       c->chem[ch] = 0.;
   }
@@ -206,7 +203,7 @@ void Dish::MeasureChemConcentrations(void) {
     }
   }
 
-  for (vector<Cell>::iterator c = cell.begin(); c != cell.end(); c++) {
+  for (CellPool::iterator c = cell.begin(); c != cell.end(); c++) {
     for (int ch = 0; ch < par.n_chem; ch++)
       c->chem[ch] /= (double)c->Area();
   }
@@ -128,9 +128,9 @@ private:
   /**
    * @brief Returns wheter or not a cell is isolated,
    * @param c Cell object.
-   * @param neighbours Neighbours of the cell.
+   * @param contacts Contacts of the cells, see CPM->GetContactGraph().
    */
-  bool CellIsolated(const Cell &c, int **neighbours) const;
+  bool CellIsolated(const Cell &c, const ContactGraph &contacts) const;
   /**
    * @brief Import a cell annoted in .xml format annoted by
    * MulticellDS
@@ -148,7 +148,7 @@ private:
 
 public:
   //! The cells in the Petri dish; accessible to derived classes
-  std::vector<Cell> cell;
+  CellPool cell;
 };
 
 #define INIT void Dish::Init(void)
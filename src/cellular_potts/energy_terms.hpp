@@ -0,0 +1,36 @@
+#pragma once
+
+/** @brief The energy of the lattice, term by term.
+ *
+ * adhesion, area, length and spreading are functions of the lattice and the
+ * cells. The chemotaxis, act and ECM adhesion terms are not: their changes
+ * depend on the copies that were made and on fields that change in between,
+ * so for those the sum of the changes of all accepted copies is kept instead.
+ */
+struct EnergyTerms
+{
+    double adhesion = 0.0;
+    double area = 0.0;
+    double length = 0.0;
+    double spreading = 0.0;
+    double chemotaxis = 0.0;
+    double act = 0.0;
+    double ecm = 0.0;
+
+    double Total() const
+    {
+        return adhesion + area + length + spreading + chemotaxis + act + ecm;
+    }
+
+    EnergyTerms &operator+=(const EnergyTerms &other)
+    {
+        adhesion += other.adhesion;
+        area += other.area;
+        length += other.length;
+        spreading += other.spreading;
+        chemotaxis += other.chemotaxis;
+        act += other.act;
+        ecm += other.ecm;
+        return *this;
+    }
+};
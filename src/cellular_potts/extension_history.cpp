@@ -6,20 +6,27 @@ void ExtensionHistory::add_extension(PixelPos pixel, int spin)
     extensions_.push_back({pixel, spin});
 }
 
-void ExtensionHistory::validate(int** sigma)
+void ExtensionHistory::validate(const SpinLattice &sigma)
 {
     extensions_.erase(
         std::remove_if(
             extensions_.begin(),
             extensions_.end(),
-            [sigma](const auto& element) {
+            [&sigma](const auto& element) {
                  auto pixel = element.first; 
                  auto spin = element.second;
-                 return sigma[pixel.x][pixel.y] != spin; 
+                 return sigma(pixel.x, pixel.y) != spin; 
             }),
         extensions_.end());
 }
 
+void ExtensionHistory::remap(const std::vector<int> &new_spin)
+{
+    for (auto &element : extensions_)
+        if (element.second > 0)
+            element.second = new_spin[element.second];
+}
+
 std::vector<PixelPos> ExtensionHistory::get_positions() {
     std::vector<PixelPos> output;
     for (auto element : extensions_)
@@ -1,4 +1,5 @@
 #pragma once
+#include "spin_lattice.hpp"
 #include "vec2.hpp"
 #include <vector>
 
@@ -6,7 +7,9 @@
 class ExtensionHistory {
     public:
         void add_extension(PixelPos, int);
-        void validate(int**);
+        void validate(const SpinLattice &sigma);
+        // renumber the spins, see CellularPotts::CompactCells()
+        void remap(const std::vector<int> &new_spin);
         
         size_t size();
         std::vector<PixelPos> get_positions(); 
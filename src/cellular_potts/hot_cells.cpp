@@ -0,0 +1,22 @@
+#include "hot_cells.hpp"
+
+void HotCells::Refresh(const CellPool &cells)
+{
+    const std::size_t n = cells.size();
+    area_.resize(n);
+    target_area_.resize(n);
+    tau_.resize(n);
+    target_length_.resize(n);
+    lambda_act_.resize(n);
+    shape_.resize(n);
+    for (std::size_t c = 0; c < n; c++)
+    {
+        area_[c] = cells[c].Area();
+        target_area_[c] = cells[c].target_area;
+        tau_[c] = cells[c].tau;
+        target_length_[c] = cells[c].target_length;
+        lambda_act_[c] = cells[c].lambda_act;
+        shape_[c] = cells[c].fit_ellipse;
+    }
+    live_ = true;
+}
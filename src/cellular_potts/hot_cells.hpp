@@ -0,0 +1,84 @@
+#pragma once
+#include "cell.hpp"
+#include "cell_pool.hpp"
+#include "cell_direction.hpp"
+#include <vector>
+
+/** @brief The state of the cells that the energy terms read on every copy
+ * attempt, as a structure of arrays indexed by cell id.
+ *
+ * A Cell is large, and the energy terms use only a few of its fields, so
+ * reading them through the CellPool wastes most of every cache line.
+ * CellularPotts copies those fields in here with Refresh() at the start of a
+ * sweep, and keeps the areas and moments up to date as it copies spins. In
+ * between sweeps, the models may change the cells as they like.
+ */
+class HotCells
+{
+public:
+    //! @brief Copy the state of cells, and keep it up to date until Stop()
+    void Refresh(const CellPool &cells);
+
+    //! @brief Stop keeping the state up to date, e.g. at the end of a sweep
+    void Stop() { live_ = false; }
+
+    //! @brief Whether the state is being kept up to date
+    bool Live() const { return live_; }
+
+    int Area(int c) const { return area_[c]; }
+    int TargetArea(int c) const { return target_area_[c]; }
+    double TargetLength(int c) const { return target_length_[c]; }
+    double LambdaAct(int c) const { return lambda_act_[c]; }
+    int Tau(int c) const { return tau_[c]; }
+
+    //! @brief Same as Cell::EnergyDifference() for cells c1 and c2
+    int EnergyDifference(int c1, int c2) const
+    {
+        if (c1 == c2)
+            return 0;
+        return Cell::J[tau_[c1]][tau_[c2]];
+    }
+
+    //! @brief Same as Cell::Length()
+    double Length(int c) const { return shape_[c].length(); }
+
+    //! @brief Same as Cell::GetNewLengthIfXYWereAdded()
+    double LengthIfAdded(int c, int x, int y) const
+    {
+        FitEllipse shape = shape_[c];
+        shape.add_site({x, y});
+        return shape.length();
+    }
+
+    //! @brief Same as Cell::GetNewLengthIfXYWereRemoved()
+    double LengthIfRemoved(int c, int x, int y) const
+    {
+        FitEllipse shape = shape_[c];
+        shape.remove_site({x, y});
+        return shape.length();
+    }
+
+    //! @brief Add site (x,y) to cell c
+    void AddSite(int c, int x, int y)
+    {
+        area_[c]++;
+        shape_[c].add_site({x, y});
+    }
+
+    //! @brief Remove site (x,y) from cell c
+    void RemoveSite(int c, int x, int y)
+    {
+        area_[c]--;
+        shape_[c].remove_site({x, y});
+    }
+
+private:
+    bool live_ = false;
+    std::vector<int> area_;
+    std::vector<int> target_area_;
+    std::vector<int> tau_;
+    std::vector<double> target_length_;
+    std::vector<double> lambda_act_;
+    // moments of the pixels of each cell, for the length constraint
+    std::vector<FitEllipse> shape_;
+};
@@ -0,0 +1,34 @@
+#include "nfold_way.hpp"
+
+void RateTree::Reset(std::int64_t n)
+{
+    leaves_ = 1;
+    while (leaves_ < n)
+        leaves_ *= 2;
+    sums_.assign(2 * leaves_, 0.0);
+}
+
+std::int64_t RateTree::Find(double &target) const
+{
+    // a node with a positive sum always has a child with a positive sum
+    std::int64_t node = 1;
+    while (node < leaves_)
+    {
+        const std::int64_t left = 2 * node;
+        if (target < sums_[left] || sums_[left + 1] <= 0.0)
+            node = left;
+        else
+        {
+            target -= sums_[left];
+            node = left + 1;
+        }
+    }
+    return node - leaves_;
+}
+
+void CellBoundaries::Reset(std::int64_t n_sites)
+{
+    position_.assign(n_sites, -1);
+    owner_.assign(n_sites, -1);
+    sites_.clear();
+}
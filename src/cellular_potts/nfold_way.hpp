@@ -0,0 +1,147 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/** @brief Non-negative weights with their partial sums in a binary tree.
+ *
+ * Setting a weight and drawing an index with probability proportional to its
+ * weight both take O(log n).
+ */
+class RateTree
+{
+public:
+    //! @brief Make room for n weights, all zero
+    void Reset(std::int64_t n);
+
+    //! @brief Set weight i to rate
+    void Set(std::int64_t i, double rate)
+    {
+        i += leaves_;
+        sums_[i] = rate;
+        // recompute rather than add the difference, so that rounding errors
+        // do not build up
+        for (i /= 2; i > 0; i /= 2)
+            sums_[i] = sums_[2 * i] + sums_[2 * i + 1];
+    }
+
+    double Get(std::int64_t i) const { return sums_[leaves_ + i]; }
+
+    double Total() const { return sums_[1]; }
+
+    /** @brief The index i at which the running sum of the weights passes
+     * target, for target in [0, Total())
+     *
+     * On return, target is reduced by the weights before i. Indices with
+     * weight zero are never returned, even if rounding puts target at or
+     * beyond Total().
+     */
+    std::int64_t Find(double &target) const;
+
+private:
+    std::int64_t leaves_ = 1;
+    // sums_[1] is the root, and node i has children 2i and 2i+1
+    std::vector<double> sums_ = std::vector<double>(2, 0.0);
+};
+
+/** @brief For every cell, the list of its sites on a cell boundary.
+ *
+ * A site can be removed from the list of its cell in O(1), so the lists can be
+ * kept up to date as spins are copied.
+ */
+class CellBoundaries
+{
+public:
+    //! @brief Make room for n_sites sites, none of which is listed
+    void Reset(std::int64_t n_sites);
+
+    bool Contains(std::int64_t site) const { return position_[site] != -1; }
+
+    //! @brief Add site to the list of cell, taking it off any other list
+    void Add(int cell, std::int64_t site)
+    {
+        if (Contains(site))
+        {
+            if (owner_[site] == cell)
+                return;
+            Remove(owner_[site], site);
+        }
+        if (cell >= static_cast<int>(sites_.size()))
+            sites_.resize(cell + 1);
+        position_[site] = static_cast<std::int64_t>(sites_[cell].size());
+        owner_[site] = cell;
+        sites_[cell].push_back(site);
+    }
+
+    //! @brief Remove site from the list of cell, if it is there
+    void Remove(int cell, std::int64_t site)
+    {
+        // a site listed under another cell stays where it is
+        if (!Contains(site) || owner_[site] != cell ||
+            cell >= static_cast<int>(sites_.size()))
+            return;
+        // move the last site of the cell into the hole
+        std::vector<std::int64_t> &list = sites_[cell];
+        const std::int64_t pos = position_[site];
+        list[pos] = list.back();
+        position_[list[pos]] = pos;
+        list.pop_back();
+        position_[site] = -1;
+        owner_[site] = -1;
+    }
+
+    //! @brief The boundary sites of cell, in no particular order
+    const std::vector<std::int64_t> &Sites(int cell) const
+    {
+        static const std::vector<std::int64_t> none;
+        return cell < static_cast<int>(sites_.size()) ? sites_[cell] : none;
+    }
+
+private:
+    // position of each site in the list of its cell, or -1
+    std::vector<std::int64_t> position_;
+    // cell whose list each site is in, or -1
+    std::vector<int> owner_;
+    std::vector<std::vector<std::int64_t>> sites_;
+};
+
+/** @brief State of the n-fold way (rejection-free) update scheme.
+ *
+ * The rate of a copy event, the copy of the spin of a neighbour into a site,
+ * is the probability that Metropolis accepts it. Rates are stored per event,
+ * and summed per site in a RateTree, so that events are drawn in proportion
+ * to their rates without drawing the ones that would be rejected.
+ */
+struct NFoldState
+{
+    //! The terms of the energy of a cell other than its spins
+    struct CellTerms
+    {
+        int target_area;
+        int tau;
+        double target_length;
+
+        bool operator!=(const CellTerms &o) const
+        {
+            return target_area != o.target_area || tau != o.tau ||
+                   target_length != o.target_length;
+        }
+    };
+
+    //! Whether the rates match the lattice, the cells and anneal
+    bool built = false;
+    bool anneal = false;
+    //! Sum of the rates of the events into each site
+    RateTree tree;
+    //! Rate of the event from neighbour k into site s, at s * n_nb + k - 1
+    std::vector<float> rates;
+    //! Contact energy of each event, or no_event if it cannot happen
+    std::vector<int> contact;
+    static constexpr int no_event = std::numeric_limits<int>::min();
+    //! Boundary sites of the cells, not the medium
+    CellBoundaries boundaries;
+    //! The spins the rates were computed for
+    std::vector<int> spins;
+    //! The cell terms the rates were computed for
+    std::vector<CellTerms> cells;
+};
@@ -0,0 +1,743 @@
+#include "ca.hpp"
+#include "deltah.hpp"
+#include "parameter.hpp"
+#include "random.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+extern Parameter par;
+
+namespace
+{
+    // Returned by SpecialisedDeltaH() for a copy that is sure to be rejected
+    constexpr int rejected_dh = std::numeric_limits<int>::max();
+}
+
+template <int NNb, bool Periodic, bool Adhesions, bool Act>
+int CellularPotts::SpecialisedDeltaH(int x, int y, int xp, int yp,
+                                     PDE *PDEfield,
+                                     AdhesionDisplacements *adh_disp,
+                                     double budget, const int *contact,
+                                     EnergyTerms *terms)
+{
+    // Same terms, in the same order, as DeltaH(), so that both give the same
+    // result. The cheap terms go first, so that the expensive ones can be
+    // skipped if they cannot bring the total back within budget. The bounds
+    // have a margin of one for rounding.
+    int DH = 0;
+    int sxy = sigma(x, y);
+    int sxyp = sigma(xp, yp);
+
+    const double area = DeltaH::area_constraint(hot_cells, sxy, sxyp);
+    DH += area;
+    const double length = DeltaH::length_change(x, y, hot_cells, sxy, sxyp);
+    DH += -(int)(-length);
+    const double adhesion =
+        contact ? *contact
+                : DeltaH::contact_energy<NNb>(x, y, sigma, hot_cells, sxy, sxyp);
+    DH += adhesion;
+    const double spreading = DeltaH::spreading_constraint(hot_cells, sxy, sxyp);
+    DH -= spreading;
+    double chemotaxis = 0.0;
+    if (PDEfield && (par.vecadherinknockout || (sxyp == 0 || sxy == 0)))
+    {
+        if (!(par.extensiononly && sxyp == 0))
+        {
+            chemotaxis = DeltaH::chemotaxis(
+                x, y, xp, yp, PDEfield->GetChemotaxisPotential(),
+                hot_cells.Tau(sxyp > 0 ? sxyp : sxy));
+            DH += chemotaxis;
+        }
+    }
+    if (terms)
+    {
+        *terms = EnergyTerms();
+        terms->adhesion = adhesion;
+        terms->area = area;
+        terms->length = length;
+        terms->spreading = -spreading;
+        terms->chemotaxis = chemotaxis;
+    }
+
+    // The act term is at most lambda_act in size, as both geometric means
+    // lie in [0, max_Act]
+    double act_bound = 0.0;
+    if constexpr (Act)
+        act_bound = -std::abs(hot_cells.LambdaAct(sxyp > 0 ? sxyp : sxy)) - 1.0;
+
+    if constexpr (Adhesions)
+    {
+        double adh_bound =
+            adhesion_mover.move_dh_lower_bound({xp, yp}, {x, y}) - 1.0;
+        if (DH + adh_bound + act_bound > budget + 1.0)
+            return rejected_dh;
+
+        double adh_dh = adhesion_mover.move_dh({xp, yp}, {x, y}, *adh_disp);
+        DH += static_cast<int>(round(adh_dh));
+        if (terms)
+            terms->ecm = adh_dh;
+    }
+
+    if constexpr (Act)
+    {
+        if (DH + act_bound > budget + 1.0)
+            return rejected_dh;
+        const double act =
+            ACT::DeltaH(act_field, sigma, {xp, yp}, {x, y},
+                        hot_cells.LambdaAct(sxyp > 0 ? sxyp : sxy),
+                        par.max_Act);
+        DH -= act;
+        if (terms)
+            terms->act = -act;
+    }
+    return DH;
+}
+
+template <int NNb, bool Periodic, bool Adhesions, bool Act>
+bool CellularPotts::SpecialisedCopyAttempt(int x, int y, int xp, int yp,
+                                           PDE *PDEfield, bool anneal,
+                                           bool philox, bool lazy, int &D_H)
+{
+    if (not(LocalConnectedness(x, y, sigma(x, y)) &&
+            LocalConnectedness(x, y, sigma(xp, yp))))
+        return false;
+
+    AdhesionDisplacements adh_disp;
+    EnergyTerms dh;
+    EnergyTerms *terms = energy_live ? &dh : nullptr;
+    int p;
+    if (lazy)
+    {
+        // Draw the Metropolis number first: with it, the copy is
+        // accepted if and only if D_H < -T log(u), or D_H <= 0.
+        double u = philox ? cpm_rng.Uniform() : RANDOM();
+        double budget = anneal ? 0.0 : -par.T * log(u);
+        D_H = SpecialisedDeltaH<NNb, Periodic, Adhesions, Act>(
+            x, y, xp, yp, PDEfield, &adh_disp, std::max(budget, 0.0),
+            nullptr, terms);
+        if (D_H == rejected_dh)
+            return false;
+        p = CopyvProb(D_H, 0, anneal, u);
+    }
+    else
+    {
+        D_H = SpecialisedDeltaH<NNb, Periodic, Adhesions, Act>(
+            x, y, xp, yp, PDEfield, &adh_disp, HUGE_VAL, nullptr, terms);
+        if (philox)
+            p = CopyvProb(D_H, 0, anneal, cpm_rng.Uniform());
+        else
+            p = CopyvProb(D_H, 0, anneal);
+    }
+    if (p <= 0)
+        return false;
+
+    if constexpr (Adhesions)
+        adhesion_mover.commit_move({xp, yp}, {x, y}, adh_disp);
+    CommitCopy(x, y, xp, yp);
+    if (terms)
+        energy += dh;
+    return true;
+}
+
+void CellularPotts::CommitCopy(int x, int y, int xp, int yp)
+{
+    ACT::commit_move(act_field, sigma, {xp, yp}, {x, y});
+    if (sigma(xp, yp) != 0)
+        history.add_extension({x, y}, sigma(xp, yp));
+    // sigma(x,y) will get the same value as sigma(xp,yp)
+    ConvertSpin(x, y, xp, yp);
+}
+
+template <int NNb, bool Periodic, bool Adhesions, bool Act>
+int CellularPotts::SpecialisedAmoebaeMove(PDE *PDEfield, bool anneal)
+{
+    thetime++;
+    if (frozen)
+        return 0;
+
+    int SumDH = 0;
+    const bool philox = (par.random_generator == "philox");
+    const bool lazy = par.lazy_deltah;
+
+    float loop = static_cast<float>(sizeedgelist) / static_cast<float>(NNb);
+    int i = 0;
+    for (; i < loop; i++)
+    {
+        // take a random entry of the edgelist
+        int positionedge =
+            (int)((philox ? cpm_rng.Uniform() : RANDOM()) * sizeedgelist);
+        int targetedge = orderedgelist[positionedge];
+        int targetsite = targetedge / NNb;
+        int targetneighbour = (targetedge % NNb) + 1;
+
+        int x = targetsite % (sizex - 2) + 1;
+        int y = targetsite / (sizex - 2) + 1;
+        int xp = nx[targetneighbour] + x;
+        int yp = ny[targetneighbour] + y;
+        // (xp,yp) also indexes the act field, the PDE and the adhesions,
+        // which have no halo
+        if constexpr (Periodic)
+        {
+            if (xp <= 0)
+                xp = sizex - 2 + xp;
+            if (yp <= 0)
+                yp = sizey - 2 + yp;
+            if (xp >= sizex - 1)
+                xp = xp - sizex + 2;
+            if (yp >= sizey - 1)
+                yp = yp - sizey + 2;
+        }
+        int D_H;
+        if (SpecialisedCopyAttempt<NNb, Periodic, Adhesions, Act>(
+                x, y, xp, yp, PDEfield, anneal, philox, lazy, D_H))
+        {
+            UpdateEdgesAfterCopy<NNb>(x, y, targetsite, loop,
+                                      std::make_index_sequence<NNb>());
+            SumDH += D_H;
+        }
+    }
+    copy_attempts = i;
+    history.validate(sigma);
+    act_field.Decrease();
+    return SumDH;
+}
+
+template <int NNb, bool Periodic, bool Adhesions, bool Act>
+int CellularPotts::BoundaryAmoebaeMove(PDE *PDEfield, bool anneal)
+{
+    thetime++;
+    if (frozen)
+        return 0;
+
+    int SumDH = 0;
+    const bool philox = (par.random_generator == "philox");
+    const bool lazy = par.lazy_deltah;
+    const std::int64_t width = sizex - 2;
+
+    // As many attempts as there are edges over NNb, also as copies change
+    // that number. A float count of the attempts left would drift on large
+    // lattices, so compare the exact edge count instead.
+    std::int64_t i = 0;
+    for (; i * NNb < boundary_sites.TotalEdges(); i++)
+    {
+        // Take a random edge, like SpecialisedAmoebaeMove() does: draw a
+        // listed site and one of its neighbours until the neighbour has a
+        // different spin. Every edge is drawn with the same probability, and
+        // listed sites without edges are never accepted.
+        std::int64_t site;
+        int x, y, xp, yp;
+        do
+        {
+            site = boundary_sites.Site(static_cast<std::int64_t>(
+                (philox ? cpm_rng.Uniform() : RANDOM()) *
+                boundary_sites.Size()));
+            int k = 1 + static_cast<int>(
+                            (philox ? cpm_rng.Uniform() : RANDOM()) * NNb);
+            x = site % width + 1;
+            y = site / width + 1;
+            xp = nx[k] + x;
+            yp = ny[k] + y;
+        } while (sigma(xp, yp) == sigma(x, y) || sigma(xp, yp) == -1);
+
+        if constexpr (Periodic)
+        {
+            if (xp <= 0)
+                xp = sizex - 2 + xp;
+            if (yp <= 0)
+                yp = sizey - 2 + yp;
+            if (xp >= sizex - 1)
+                xp = xp - sizex + 2;
+            if (yp >= sizey - 1)
+                yp = yp - sizey + 2;
+        }
+        const int old_spin = sigma(x, y);
+        int D_H;
+        if (SpecialisedCopyAttempt<NNb, Periodic, Adhesions, Act>(
+                x, y, xp, yp, PDEfield, anneal, philox, lazy, D_H))
+        {
+            UpdateBoundaryAfterCopy<NNb, Periodic>(x, y, site, old_spin);
+            SumDH += D_H;
+        }
+    }
+    copy_attempts = i;
+    history.validate(sigma);
+    act_field.Decrease();
+    return SumDH;
+}
+
+template <int NNb, std::size_t... J>
+void CellularPotts::UpdateEdgesAfterCopy(int x, int y, int targetsite,
+                                         float &loop,
+                                         std::index_sequence<J...>)
+{
+    (UpdateEdge<NNb, J + 1>(x, y, targetsite, loop), ...);
+}
+
+template <int NNb, int J>
+void CellularPotts::UpdateEdge(int x, int y, int targetsite, float &loop)
+{
+    // Border sites in the halo never have edges, so they need no check
+    const int sn = sigma(x + DeltaH::nb_x[J], y + DeltaH::nb_y[J]);
+    const int edge = targetsite * NNb + J - 1;
+
+    if (edgelist[edge] == -1 && sn != sigma(x, y) && sn != -1)
+    {
+        AddEdgeToEdgelist(edge);
+        // adjust loop because two edges were added
+        loop += 2.0 / NNb;
+    }
+    if (edgelist[edge] != -1 && (sn == sigma(x, y) || sn == -1))
+    {
+        RemoveEdgeFromEdgelist(edge);
+        // adjust loop because two edges were removed
+        loop -= 2.0 / NNb;
+    }
+}
+
+template <int NNb, bool Periodic>
+void CellularPotts::UpdateBoundaryAfterCopy(int x, int y, std::int64_t site,
+                                            int old_spin)
+{
+    const std::int64_t width = sizex - 2;
+    const int new_spin = sigma(x, y);
+    for (int j = 1; j <= NNb; j++)
+    {
+        int xn = x + DeltaH::nb_x[j];
+        int yn = y + DeltaH::nb_y[j];
+        const int sn = sigma(xn, yn);
+        if (sn == -1)
+            continue;
+        // the edge from (x,y) to its neighbour and the one back change
+        // together
+        const int delta = (sn != new_spin) - (sn != old_spin);
+        if (delta == 0)
+            continue;
+        if constexpr (Periodic)
+        {
+            if (xn <= 0)
+                xn += width;
+            if (yn <= 0)
+                yn += sizey - 2;
+            if (xn >= sizex - 1)
+                xn -= width;
+            if (yn >= sizey - 1)
+                yn -= sizey - 2;
+        }
+        boundary_sites.AddEdges(site, delta);
+        boundary_sites.AddEdges((xn - 1) + (yn - 1) * width, delta);
+    }
+}
+
+void CellularPotts::InitialiseBoundarySites(void)
+{
+    const std::int64_t width = sizex - 2;
+    boundary_sites.Reset(width * (sizey - 2));
+    for (int y = 1; y < sizey - 1; y++)
+        for (int x = 1; x < sizex - 1; x++)
+        {
+            int edges = 0;
+            for (int k = 1; k <= n_nb; k++)
+            {
+                int xp = nx[k] + x;
+                int yp = ny[k] + y;
+                if (par.periodic_boundaries)
+                {
+                    if (xp <= 0)
+                        xp = sizex - 2 + xp;
+                    if (yp <= 0)
+                        yp = sizey - 2 + yp;
+                    if (xp >= sizex - 1)
+                        xp = xp - sizex + 2;
+                    if (yp >= sizey - 1)
+                        yp = yp - sizey + 2;
+                }
+                else if (xp <= 0 || yp <= 0 || xp >= sizex - 1 ||
+                         yp >= sizey - 1)
+                    continue;
+                if (sigma(xp, yp) != sigma(x, y))
+                    edges++;
+            }
+            boundary_sites.AddEdges((x - 1) + (y - 1) * width, edges);
+        }
+}
+
+namespace
+{
+    // The index of the neighbour opposite to neighbour k
+    constexpr int opposite(int k)
+    {
+        for (int j = 1; j < 21; j++)
+            if (DeltaH::nb_x[j] == -DeltaH::nb_x[k] &&
+                DeltaH::nb_y[j] == -DeltaH::nb_y[k])
+                return j;
+        return 0;
+    }
+} // namespace
+
+template <int NNb, bool Periodic>
+int CellularPotts::NFoldAmoebaeMove(PDE *PDEfield, bool anneal)
+{
+    thetime++;
+    if (frozen)
+        return 0;
+
+    const bool philox = (par.random_generator == "philox");
+    auto uniform = [&]() { return philox ? cpm_rng.Uniform() : RANDOM(); };
+    const std::int64_t width = sizex - 2;
+
+    NFoldSync<NNb, Periodic>(PDEfield, anneal);
+
+    // Events happen at a rate of their acceptance probability over NNb per
+    // MCS, as in SpecialisedAmoebaeMove(). The waiting times are
+    // exponential, so the one that crosses the end of the MCS can be cut off.
+    int SumDH = 0;
+    double t = 0.0;
+    while (nfold.tree.Total() > 0.0)
+    {
+        t += -log(1.0 - uniform()) * NNb / nfold.tree.Total();
+        if (t >= 1.0)
+            break;
+
+        double target = uniform() * nfold.tree.Total();
+        const std::int64_t site = nfold.tree.Find(target);
+        const float *rates = &nfold.rates[site * NNb];
+        int k = 0;
+        for (int j = 1; j <= NNb; j++)
+        {
+            if (rates[j - 1] <= 0.0f)
+                continue;
+            k = j;
+            if (target < rates[j - 1])
+                break;
+            target -= rates[j - 1];
+        }
+
+        const int x = site % width + 1;
+        const int y = site / width + 1;
+        int xp = nx[k] + x;
+        int yp = ny[k] + y;
+        if constexpr (Periodic)
+        {
+            if (xp <= 0)
+                xp = sizex - 2 + xp;
+            if (yp <= 0)
+                yp = sizey - 2 + yp;
+            if (xp >= sizex - 1)
+                xp = xp - sizex + 2;
+            if (yp >= sizey - 1)
+                yp = yp - sizey + 2;
+        }
+        EnergyTerms dh;
+        SumDH += SpecialisedDeltaH<NNb, Periodic, false, false>(
+            x, y, xp, yp, PDEfield, nullptr, HUGE_VAL,
+            &nfold.contact[site * NNb + k - 1], energy_live ? &dh : nullptr);
+        const int old_spin = sigma(x, y);
+        CommitCopy(x, y, xp, yp);
+        if (energy_live)
+            energy += dh;
+        NFoldSiteChanged<NNb, Periodic>(x, y, old_spin, PDEfield, anneal);
+        NFoldUpdateCell<NNb, Periodic>(old_spin, PDEfield, anneal, true);
+        NFoldUpdateCell<NNb, Periodic>(sigma(x, y), PDEfield, anneal, true);
+    }
+    history.validate(sigma);
+    act_field.Decrease();
+    return SumDH;
+}
+
+template <int NNb, bool Periodic>
+void CellularPotts::NFoldEvent(int x, int y, int k, PDE *PDEfield,
+                               bool anneal, bool contact_known)
+{
+    const std::int64_t width = sizex - 2;
+    const std::int64_t event = ((x - 1) + (y - 1) * width) * NNb + k - 1;
+    int &contact = nfold.contact[event];
+    int xp = nx[k] + x;
+    int yp = ny[k] + y;
+    if (!contact_known)
+    {
+        const int sxy = sigma(x, y);
+        const int sxyp = sigma(xp, yp);
+        if (sxyp == sxy || sxyp == -1 ||
+            not(LocalConnectedness(x, y, sxy) &&
+                LocalConnectedness(x, y, sxyp)))
+            contact = NFoldState::no_event;
+        else
+            contact = DeltaH::contact_energy<NNb>(x, y, sigma, hot_cells, sxy,
+                                                 sxyp);
+    }
+    if (contact == NFoldState::no_event)
+    {
+        nfold.rates[event] = 0.0f;
+        return;
+    }
+    if constexpr (Periodic)
+    {
+        if (xp <= 0)
+            xp = sizex - 2 + xp;
+        if (yp <= 0)
+            yp = sizey - 2 + yp;
+        if (xp >= sizex - 1)
+            xp = xp - sizex + 2;
+        if (yp >= sizey - 1)
+            yp = yp - sizey + 2;
+    }
+    const int D_H = SpecialisedDeltaH<NNb, Periodic, false, false>(
+        x, y, xp, yp, PDEfield, nullptr, HUGE_VAL, &contact);
+    nfold.rates[event] = CopyProbability(D_H, anneal);
+}
+
+template <int NNb>
+void CellularPotts::NFoldSumSite(std::int64_t site)
+{
+    const float *rates = &nfold.rates[site * NNb];
+    double sum = 0.0;
+    for (int k = 0; k < NNb; k++)
+        sum += rates[k];
+    nfold.tree.Set(site, sum);
+}
+
+template <int NNb, bool Periodic>
+void CellularPotts::NFoldUpdateSite(std::int64_t site, PDE *PDEfield,
+                                    bool anneal, bool contact_known)
+{
+    const std::int64_t width = sizex - 2;
+    const int x = site % width + 1;
+    const int y = site / width + 1;
+    for (int k = 1; k <= NNb; k++)
+        NFoldEvent<NNb, Periodic>(x, y, k, PDEfield, anneal, contact_known);
+    NFoldSumSite<NNb>(site);
+}
+
+template <int NNb, bool Periodic>
+void CellularPotts::NFoldUpdateCell(int c, PDE *PDEfield, bool anneal,
+                                    bool contact_known)
+{
+    // The area, length and spreading terms of every event into or out of
+    // cell c depend on its area and shape. Those events all touch one of its
+    // boundary sites.
+    if (c <= 0)
+        return;
+    const std::int64_t width = sizex - 2;
+    for (const std::int64_t site : nfold.boundaries.Sites(c))
+    {
+        NFoldUpdateSite<NNb, Periodic>(site, PDEfield, anneal, contact_known);
+        const int x = site % width + 1;
+        const int y = site / width + 1;
+        for (int k = 1; k <= NNb; k++)
+        {
+            int xn = nx[k] + x;
+            int yn = ny[k] + y;
+            const int sn = sigma(xn, yn);
+            if (sn == c || sn == -1)
+                continue;
+            if constexpr (Periodic)
+            {
+                if (xn <= 0)
+                    xn += width;
+                if (yn <= 0)
+                    yn += sizey - 2;
+                if (xn >= sizex - 1)
+                    xn -= width;
+                if (yn >= sizey - 1)
+                    yn -= sizey - 2;
+            }
+            // the event from (x,y) into its neighbour
+            NFoldEvent<NNb, Periodic>(xn, yn, opposite(k), PDEfield, anneal,
+                                      contact_known);
+            NFoldSumSite<NNb>((xn - 1) + (yn - 1) * width);
+        }
+    }
+}
+
+template <int NNb, bool Periodic>
+void CellularPotts::NFoldSiteChanged(int x, int y, int old_spin,
+                                     PDE *PDEfield, bool anneal)
+{
+    const std::int64_t width = sizex - 2;
+    const std::int64_t site = (x - 1) + (y - 1) * width;
+    if (old_spin > 0)
+        nfold.boundaries.Remove(old_spin, site);
+    nfold.spins[site] = sigma(x, y);
+
+    // The contact energy of an event reaches NNb neighbours from its target
+    // site, and the connectivity check its 8 neighbours, so the rates of the
+    // events into all of those may change. Whether a site is on a cell
+    // boundary depends on its NNb neighbours only.
+    constexpr int reach = NNb > 8 ? NNb : 8;
+    for (int k = 0; k <= reach; k++)
+    {
+        int xn = nx[k] + x;
+        int yn = ny[k] + y;
+        if constexpr (Periodic)
+        {
+            if (xn <= 0)
+                xn += width;
+            if (yn <= 0)
+                yn += sizey - 2;
+            if (xn >= sizex - 1)
+                xn -= width;
+            if (yn >= sizey - 1)
+                yn -= sizey - 2;
+        }
+        else if (xn <= 0 || yn <= 0 || xn >= sizex - 1 || yn >= sizey - 1)
+            continue;
+        const std::int64_t nsite = (xn - 1) + (yn - 1) * width;
+        if (k <= NNb)
+            NFoldUpdateBoundary<NNb>(xn, yn, nsite);
+        NFoldUpdateSite<NNb, Periodic>(nsite, PDEfield, anneal, false);
+    }
+}
+
+template <int NNb>
+void CellularPotts::NFoldUpdateBoundary(int x, int y, std::int64_t site)
+{
+    const int c = sigma(x, y);
+    if (c <= 0)
+        return;
+    bool boundary = false;
+    for (int k = 1; k <= NNb; k++)
+    {
+        const int sn = sigma(x + DeltaH::nb_x[k], y + DeltaH::nb_y[k]);
+        boundary |= (sn != c && sn != -1);
+    }
+    if (boundary)
+        nfold.boundaries.Add(c, site);
+    else
+        nfold.boundaries.Remove(c, site);
+}
+
+template <int NNb, bool Periodic>
+void CellularPotts::NFoldSync(PDE *PDEfield, bool anneal)
+{
+    const std::int64_t width = sizex - 2;
+    const std::int64_t n_sites = width * (sizey - 2);
+    const int n_cells = static_cast<int>(cell->size());
+    auto terms = [this](int c) {
+        return NFoldState::CellTerms{hot_cells.TargetArea(c),
+                                     hot_cells.Tau(c),
+                                     hot_cells.TargetLength(c)};
+    };
+
+    // The chemotaxis term changes with the PDE, which the models update in
+    // between MCS
+    const bool chemotaxis = PDEfield && par.chemotaxis != 0.0;
+    if (nfold.built && nfold.anneal == anneal && !chemotaxis &&
+        static_cast<std::int64_t>(nfold.spins.size()) == n_sites)
+    {
+        // Bring the rates up to date with the spins and cells that the
+        // models changed since the last MCS. If that is most of the lattice,
+        // starting over is faster.
+        std::vector<std::int64_t> changed;
+        for (std::int64_t site = 0; site < n_sites; site++)
+            if (nfold.spins[site] !=
+                sigma(site % width + 1, site / width + 1))
+                changed.push_back(site);
+
+        if (static_cast<std::int64_t>(changed.size()) * 8 < n_sites)
+        {
+            std::vector<bool> dirty(n_cells, false);
+            for (const std::int64_t site : changed)
+            {
+                const int x = site % width + 1;
+                const int y = site / width + 1;
+                const int old_spin = nfold.spins[site];
+                NFoldSiteChanged<NNb, Periodic>(x, y, old_spin, PDEfield,
+                                                anneal);
+                if (old_spin < n_cells)
+                    dirty[old_spin] = true;
+                dirty[sigma(x, y)] = true;
+            }
+            nfold.cells.resize(n_cells, NFoldState::CellTerms{-1, -1, -1.0});
+            for (int c = 1; c < n_cells; c++)
+            {
+                if (nfold.cells[c] != terms(c))
+                {
+                    nfold.cells[c] = terms(c);
+                    dirty[c] = true;
+                }
+                if (dirty[c])
+                    NFoldUpdateCell<NNb, Periodic>(c, PDEfield, anneal,
+                                                   false);
+            }
+            return;
+        }
+    }
+
+    nfold.built = true;
+    nfold.anneal = anneal;
+    nfold.tree.Reset(n_sites);
+    nfold.rates.assign(n_sites * NNb, 0.0f);
+    nfold.contact.assign(n_sites * NNb, NFoldState::no_event);
+    nfold.boundaries.Reset(n_sites);
+    nfold.spins.resize(n_sites);
+    for (std::int64_t site = 0; site < n_sites; site++)
+    {
+        const int x = site % width + 1;
+        const int y = site / width + 1;
+        nfold.spins[site] = sigma(x, y);
+        NFoldUpdateBoundary<NNb>(x, y, site);
+    }
+    for (std::int64_t site = 0; site < n_sites; site++)
+        NFoldUpdateSite<NNb, Periodic>(site, PDEfield, anneal, false);
+    nfold.cells.resize(n_cells);
+    for (int c = 0; c < n_cells; c++)
+        nfold.cells[c] = terms(c);
+}
+
+void CellularPotts::SelectAmoebaeMove(void)
+{
+    using MoveFunction = int (CellularPotts::*)(PDE *, bool);
+    const bool periodic = par.periodic_boundaries;
+    const bool adhesions = par.adhesions_enabled;
+    const bool act = par.lambda_Act > 0;
+
+    const bool boundary = (par.cpm_update_scheme == "boundary");
+    const bool nfold_way = (par.cpm_update_scheme == "nfold");
+
+    auto move = [&](auto nnb, auto per, auto adh, auto with_act) -> MoveFunction {
+        constexpr int N = decltype(nnb)::value;
+        constexpr bool P = decltype(per)::value;
+        constexpr bool A = decltype(adh)::value;
+        constexpr bool C = decltype(with_act)::value;
+        if (nfold_way)
+            return &CellularPotts::NFoldAmoebaeMove<N, P>;
+        if (boundary)
+            return &CellularPotts::BoundaryAmoebaeMove<N, P, A, C>;
+        return &CellularPotts::SpecialisedAmoebaeMove<N, P, A, C>;
+    };
+    auto select = [&](auto nnb) -> MoveFunction {
+        using T = std::true_type;
+        using F = std::false_type;
+        if (periodic)
+        {
+            if (adhesions)
+                return act ? move(nnb, T(), T(), T()) : move(nnb, T(), T(), F());
+            return act ? move(nnb, T(), F(), T()) : move(nnb, T(), F(), F());
+        }
+        if (adhesions)
+            return act ? move(nnb, F(), T(), T()) : move(nnb, F(), T(), F());
+        return act ? move(nnb, F(), F(), T()) : move(nnb, F(), F(), F());
+    };
+
+    switch (n_nb)
+    {
+    case 4:
+        edge_list_move = select(std::integral_constant<int, 4>());
+        break;
+    case 8:
+        edge_list_move = select(std::integral_constant<int, 8>());
+        break;
+    case 20:
+        edge_list_move = select(std::integral_constant<int, 20>());
+        break;
+    default:
+        throw std::runtime_error(
+            "CellularPotts::SelectAmoebaeMove(): no specialised AmoebaeMove "
+            "for this neighbourhood");
+    }
+}
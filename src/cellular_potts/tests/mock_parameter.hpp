@@ -3,6 +3,9 @@ class MockParameter {
     public:
         double lambda_Act;
         double max_Act;
+        bool periodic_boundaries = false;
+        int sizex = 0;
+        int sizey = 0;
     
 };
 
@@ -0,0 +1,65 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "act_pixels.cpp"
+
+#include <algorithm>
+
+TEST_CASE("Alive pixels are added and removed", "[act_pixels]")
+{
+    ActPixels act(10, 8);
+    REQUIRE(act.AlivePixels().empty());
+    REQUIRE(act.Level(3, 4) == 0);
+
+    act.SetAlive(3, 4, 20);
+    act.SetAlive(5, 6, 20);
+    act.SetAlive(7, 1, 20);
+    act.SetAlive(5, 6, 15);
+    REQUIRE(act.AlivePixels().size() == 3);
+    REQUIRE(act.Level(5, 6) == 15);
+
+    // removing from the middle of the list keeps the others findable
+    act.Kill(3, 4);
+    act.Kill(3, 4);
+    REQUIRE(!act.Alive(3, 4));
+    REQUIRE(act.Level(3, 4) == 0);
+    REQUIRE(act.AlivePixels().size() == 2);
+
+    act.Kill(7, 1);
+    REQUIRE(act.AlivePixels().size() == 1);
+    REQUIRE(act.Alive(5, 6));
+    REQUIRE(act.AlivePixels()[0] == std::array<int, 2>{5, 6});
+}
+
+TEST_CASE("Ageing lowers positive levels only", "[act_pixels]")
+{
+    ActPixels act(4, 4);
+    act.SetAlive(1, 1, 3);
+    act.SetAlive(2, 2, 0);
+
+    act.Age(1.5);
+    REQUIRE(act.Level(1, 1) == 1);
+    REQUIRE(act.Level(2, 2) == 0);
+
+    act.Age(1.5);
+    REQUIRE(act.Level(1, 1) == 0);
+    act.Age(1.5);
+    REQUIRE(act.Level(1, 1) == 0);
+}
+
+TEST_CASE("Neighbour changes are reset between attempts", "[act_pixels]")
+{
+    NeighbourChanges changes;
+    changes.Reset(5);
+    changes.Add(2, 1);
+    changes.Add(4, -1);
+    changes.Add(2, -1);
+    changes.Add(2, 1);
+    REQUIRE(changes[2] == 1);
+    REQUIRE(changes[4] == -1);
+    REQUIRE(changes.Touched().size() == 2);
+
+    changes.Reset(8);
+    REQUIRE(changes.Touched().empty());
+    for (int c = 0; c < 8; c++)
+        REQUIRE(changes[c] == 0);
+}
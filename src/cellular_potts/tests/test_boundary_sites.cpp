@@ -0,0 +1,74 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "boundary_sites.cpp"
+
+#include <set>
+
+namespace
+{
+// The sites on the list that still have edges
+std::set<std::int64_t> Boundary(const BoundarySites &sites)
+{
+    std::set<std::int64_t> boundary;
+    for (std::int64_t i = 0; i < sites.Size(); i++)
+        if (sites.Edges(sites.Site(i)) > 0)
+            boundary.insert(sites.Site(i));
+    return boundary;
+}
+} // namespace
+
+TEST_CASE("Boundary sites are added and removed", "[boundary_sites]")
+{
+    BoundarySites sites;
+    sites.Reset(100);
+    REQUIRE(sites.Size() == 0);
+    REQUIRE(sites.TotalEdges() == 0);
+
+    sites.AddEdges(3, 2);
+    sites.AddEdges(50, 1);
+    sites.AddEdges(3, 20);
+    sites.AddEdges(99, 0);
+    REQUIRE(sites.Edges(3) == 22);
+    REQUIRE(sites.TotalEdges() == 23);
+    REQUIRE(sites.Size() == 2);
+    REQUIRE(Boundary(sites) == std::set<std::int64_t>{3, 50});
+
+    // a site that loses its edges is skipped, and not listed twice if it
+    // gets them back
+    sites.AddEdges(3, -22);
+    REQUIRE(sites.Edges(3) == 0);
+    REQUIRE(Boundary(sites) == std::set<std::int64_t>{50});
+    sites.AddEdges(3, 1);
+    REQUIRE(Boundary(sites) == std::set<std::int64_t>{3, 50});
+    REQUIRE(sites.Size() == 2);
+    REQUIRE(sites.TotalEdges() == 2);
+}
+
+TEST_CASE("Sites without edges are pruned from the list", "[boundary_sites]")
+{
+    BoundarySites sites;
+    sites.Reset(1000);
+    for (std::int64_t s = 0; s < 1000; s++)
+        sites.AddEdges(s, 1 + s % 8);
+    REQUIRE(sites.Size() == 1000);
+
+    for (std::int64_t s = 0; s < 1000; s += 2)
+        sites.AddEdges(s, -(1 + s % 8));
+    REQUIRE(sites.Size() <= 1000);
+    REQUIRE(Boundary(sites).size() == 500);
+
+    // removing a majority shrinks the list
+    for (std::int64_t s = 1; s < 1000; s += 4)
+        sites.AddEdges(s, -(1 + s % 8));
+    REQUIRE(Boundary(sites).size() == 250);
+    REQUIRE(sites.Size() < 500);
+
+    std::int64_t total = 0;
+    for (std::int64_t s = 0; s < 1000; s++)
+        total += sites.Edges(s);
+    REQUIRE(sites.TotalEdges() == total);
+
+    // pruned sites can come back
+    sites.AddEdges(0, 5);
+    REQUIRE(Boundary(sites).count(0) == 1);
+}
@@ -0,0 +1,99 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "cell_pixels.cpp"
+#include "spin_lattice.cpp"
+
+#include <random>
+#include <set>
+#include <vector>
+
+namespace
+{
+// A lattice of sizex x sizey sites with a border of -1
+SpinLattice MakeLattice(int sizex, int sizey)
+{
+    SpinLattice lattice(sizex, sizey, 0, 0);
+    for (int x = 0; x < sizex; x++)
+        lattice(x, 0) = lattice(x, sizey - 1) = -1;
+    for (int y = 0; y < sizey; y++)
+        lattice(0, y) = lattice(sizex - 1, y) = -1;
+    return lattice;
+}
+
+std::set<CellPixels::Pixel> AsSet(const std::vector<CellPixels::Pixel> &v)
+{
+    return std::set<CellPixels::Pixel>(v.begin(), v.end());
+}
+} // namespace
+
+TEST_CASE("Pixels and boundary pixels of a cell", "[cell_pixels]")
+{
+    // a 3x3 block of cell 1 in a 7x7 lattice, with cell 2 next to it
+    SpinLattice lattice = MakeLattice(7, 7);
+    for (int x = 1; x <= 3; x++)
+        for (int y = 1; y <= 3; y++)
+            lattice(x, y) = 1;
+    lattice(4, 2) = 2;
+
+    CellPixels pixels;
+    pixels.Build(lattice, 7, 7, false);
+    REQUIRE(pixels.Live());
+    REQUIRE(pixels.Cells() == 3);
+    REQUIRE(pixels.Pixels(1).size() == 9);
+    REQUIRE(pixels.Pixels(0).empty());
+    REQUIRE(pixels.Pixels(10).empty());
+
+    // all but the centre touch the medium or the edge of the lattice
+    std::set<CellPixels::Pixel> boundary = AsSet(pixels.Boundary(1));
+    REQUIRE(boundary.size() == 8);
+    REQUIRE(boundary.count({2, 2}) == 0);
+    REQUIRE(AsSet(pixels.Boundary(2)) ==
+            std::set<CellPixels::Pixel>{{4, 2}});
+
+    // with periodic boundaries, the far side is medium too
+    pixels.Build(lattice, 7, 7, true);
+    REQUIRE(AsSet(pixels.Boundary(1)).size() == 8);
+
+    // copying cell 2 into the centre puts it on the boundary
+    lattice(2, 2) = 2;
+    pixels.Update(lattice, 2, 2, 1);
+    REQUIRE(pixels.Pixels(1).size() == 8);
+    REQUIRE(AsSet(pixels.Boundary(1)).size() == 8);
+    REQUIRE(AsSet(pixels.Boundary(2)) ==
+            std::set<CellPixels::Pixel>{{2, 2}, {4, 2}});
+}
+
+TEST_CASE("Updated index matches a rebuilt one", "[cell_pixels]")
+{
+    const int sizex = 14, sizey = 11;
+    for (bool periodic : {false, true})
+    {
+        SpinLattice lattice = MakeLattice(sizex, sizey);
+        std::mt19937 rng(7);
+        std::uniform_int_distribution<int> spin(0, 5);
+        std::uniform_int_distribution<int> xs(1, sizex - 2);
+        std::uniform_int_distribution<int> ys(1, sizey - 2);
+        for (int x = 1; x < sizex - 1; x++)
+            for (int y = 1; y < sizey - 1; y++)
+                lattice(x, y) = spin(rng) % 3;
+
+        CellPixels pixels;
+        pixels.Build(lattice, sizex, sizey, periodic);
+        for (int i = 0; i < 2000; i++)
+        {
+            const int x = xs(rng), y = ys(rng);
+            const int old_spin = lattice(x, y);
+            lattice(x, y) = spin(rng);
+            pixels.Update(lattice, x, y, old_spin);
+        }
+
+        CellPixels rebuilt;
+        rebuilt.Build(lattice, sizex, sizey, periodic);
+        for (int c = 0; c < 6; c++)
+        {
+            REQUIRE(AsSet(pixels.Pixels(c)) == AsSet(rebuilt.Pixels(c)));
+            REQUIRE(AsSet(pixels.Boundary(c)) == AsSet(rebuilt.Boundary(c)));
+            REQUIRE(pixels.Pixels(c).size() == AsSet(pixels.Pixels(c)).size());
+        }
+    }
+}
@@ -0,0 +1,151 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "mock_model.cpp"
+#include "tissue.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+namespace
+{
+/* A tissue of square cells in medium. Cells grown by Eden growth may be
+ * tangled up in ways that the connectivity constraint does not allow to
+ * undo, and then they cannot shrink to nothing. */
+std::unique_ptr<Dish> Tissue(bool periodic)
+{
+    SetTissue(80, 60, periodic, 20, 5);
+    par.target_area = 60;
+    par.lambda2 = 0;
+    par.n_chem = 0;
+    par.cell_compaction_interval = 0;
+    par.energy_check_interval = 0;
+    auto dish = MakeDish(5);
+
+    CellularPotts &cpm = *dish->CPM;
+    for (int x = 1; x < par.sizex - 1; x++)
+        for (int y = 1; y < par.sizey - 1; y++)
+            cpm.getSigma()(x, y) = 0;
+    const int n_cells = static_cast<int>(cpm.getCellArray()->size());
+    for (int c = 1; c < n_cells; c++)
+        cpm.SquareCell(c, 8 + 14 * ((c - 1) % 5), 8 + 14 * ((c - 1) / 5), 7);
+    cpm.MeasureCellSizes();
+    for (Cell &cell : *cpm.getCellArray())
+        cell.SetTargetArea(par.target_area);
+    cpm.InitialiseEdgeList();
+    return dish;
+}
+
+// Sorted pixels of a cell, to compare lists kept in different orders
+std::vector<CellPixels::Pixel> Sorted(const std::vector<CellPixels::Pixel> &p)
+{
+    std::vector<CellPixels::Pixel> sorted(p);
+    std::sort(sorted.begin(), sorted.end());
+    return sorted;
+}
+
+// The sites of each cell, gathered from the lattice
+std::vector<std::vector<CellPixels::Pixel>> LatticePixels(
+    const CellularPotts &cpm, int n_cells)
+{
+    std::vector<std::vector<CellPixels::Pixel>> pixels(n_cells);
+    for (int x = 1; x < cpm.SizeX() - 1; x++)
+        for (int y = 1; y < cpm.SizeY() - 1; y++)
+        {
+            const int spin = cpm.Sigma(x, y);
+            REQUIRE(spin >= 0);
+            REQUIRE(spin < n_cells);
+            if (spin > 0)
+                pixels[spin].push_back({x, y});
+        }
+    return pixels;
+}
+
+void RequireConsistent(CellularPotts &cpm)
+{
+    const CellPool &cells = *cpm.getCellArray();
+    const int n_cells = static_cast<int>(cells.size());
+    const auto lattice = LatticePixels(cpm, n_cells);
+
+    // the kept pixel lists follow sigma, as does a fresh build
+    const CellPixels &kept = cpm.GetCellPixels();
+    CellPixels fresh;
+    fresh.Build(cpm.getSigma(), cpm.SizeX(), cpm.SizeY(),
+                par.periodic_boundaries);
+    for (int c = 1; c < n_cells; c++)
+    {
+        INFO("cell " << c);
+        REQUIRE(cells[c].Sigma() == c);
+        REQUIRE(cells[c].Area() == static_cast<int>(lattice[c].size()));
+        REQUIRE(Sorted(kept.Pixels(c)) == Sorted(lattice[c]));
+        REQUIRE(Sorted(kept.Boundary(c)) == Sorted(fresh.Boundary(c)));
+    }
+
+    // and so does the contact graph
+    const ContactGraph &graph = cpm.GetContactGraph();
+    ContactGraph rebuilt;
+    rebuilt.Build(cpm.getSigma(), cpm.SizeX(), cpm.SizeY(),
+                  par.periodic_boundaries);
+    for (int a = 0; a < n_cells; a++)
+        for (int b = 0; b < n_cells; b++)
+        {
+            INFO("cells " << a << " and " << b);
+            REQUIRE(graph.InterfaceLength(a, b) ==
+                    rebuilt.InterfaceLength(a, b));
+        }
+
+    // the running energy totals still match the lattice
+    const double total = cpm.MeasureEnergy().Total();
+    REQUIRE(cpm.CheckEnergy() <= 1e-6 * std::max(1.0, std::abs(total)));
+}
+
+void KillAndCompact(bool periodic)
+{
+    auto dish = Tissue(periodic);
+    CellularPotts &cpm = *dish->CPM;
+    // keep the pixel lists, the contact graph and the energy up to date
+    cpm.GetCellPixels();
+    cpm.GetContactGraph();
+    cpm.Energy();
+    for (int mcs = 0; mcs < 20; mcs++)
+        cpm.AmoebaeMove(dish->PDEfield);
+
+    // Cells that shrink to nothing die. They shrink slowly, as those that
+    // are squeezed hard may close up into rings, which the connectivity
+    // constraint does not let shrink any further.
+    CellPool &cells = *cpm.getCellArray();
+    const int n_cells = static_cast<int>(cells.size());
+    int killed = 0;
+    for (int c = 1; c < n_cells; c += 3)
+        killed++;
+    auto dead = [&]() {
+        int n = 0;
+        for (int c = 1; c < n_cells; c++)
+            n += !cells[c].AliveP();
+        return n;
+    };
+    for (int mcs = 0; mcs < 200 && dead() < killed; mcs++)
+    {
+        for (int c = 1; c < n_cells; c += 3)
+            cells[c].SetTargetArea(std::max(0, cells[c].Area() - 2));
+        cpm.AmoebaeMove(dish->PDEfield);
+    }
+    REQUIRE(dead() == killed);
+
+    REQUIRE(cpm.CompactCells() == killed);
+    REQUIRE(static_cast<int>(cells.size()) == n_cells - killed);
+    RequireConsistent(cpm);
+
+    // and they are kept up to date from the new numbers on
+    for (int mcs = 0; mcs < 5; mcs++)
+        cpm.AmoebaeMove(dish->PDEfield);
+    RequireConsistent(cpm);
+}
+} // namespace
+
+TEST_CASE("Compacting cells keeps the CPM consistent", "[compact_cells]")
+{
+    KillAndCompact(false);
+    KillAndCompact(true);
+}
@@ -0,0 +1,104 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "contact_graph.cpp"
+#include "spin_lattice.cpp"
+
+#include <map>
+#include <random>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+namespace
+{
+// A lattice of sizex x sizey sites with a border of -1
+SpinLattice MakeLattice(int sizex, int sizey)
+{
+    SpinLattice lattice(sizex, sizey, 0, 0);
+    for (int x = 0; x < sizex; x++)
+        lattice(x, 0) = lattice(x, sizey - 1) = -1;
+    for (int y = 0; y < sizey; y++)
+        lattice(0, y) = lattice(sizex - 1, y) = -1;
+    return lattice;
+}
+
+std::map<std::pair<int, int>, int> Interfaces(const ContactGraph &graph)
+{
+    std::map<std::pair<int, int>, int> interfaces;
+    for (int a = 0; a < graph.Spins(); a++)
+        for (const auto &contact : graph.Contacts(a))
+            interfaces[{a, contact.spin}] = contact.length;
+    return interfaces;
+}
+} // namespace
+
+TEST_CASE("Interfaces between cells", "[contact_graph]")
+{
+    // cells 1 and 2 side by side in a 6x5 lattice, in medium
+    SpinLattice lattice = MakeLattice(6, 5);
+    for (int y = 1; y <= 2; y++)
+    {
+        lattice(1, y) = 1;
+        lattice(2, y) = 2;
+    }
+
+    ContactGraph graph;
+    graph.Build(lattice, 6, 5, false);
+    REQUIRE(graph.Live());
+    REQUIRE(graph.InterfaceLength(1, 2) == 2);
+    REQUIRE(graph.InterfaceLength(2, 1) == 2);
+    REQUIRE(graph.InterfaceLength(1, 0) == 1);
+    REQUIRE(graph.InterfaceLength(2, 0) == 3);
+    REQUIRE(graph.InterfaceLength(1, 3) == 0);
+    REQUIRE(graph.Contacts(7).empty());
+
+    std::ostringstream os;
+    graph.Write(os);
+    REQUIRE(os.str() == "0 1 1\n0 2 3\n1 2 2\n");
+
+    // with periodic boundaries, cell 1 also touches the medium on its left
+    // and below
+    graph.Build(lattice, 6, 5, true);
+    REQUIRE(graph.InterfaceLength(1, 0) == 4);
+
+    // a contact disappears when its interface does
+    graph.Build(lattice, 6, 5, false);
+    for (int y = 1; y <= 2; y++)
+    {
+        lattice(2, y) = 0;
+        graph.Update(lattice, 2, y, 2);
+    }
+    REQUIRE(graph.InterfaceLength(1, 2) == 0);
+    REQUIRE(graph.Contacts(2).empty());
+    REQUIRE(graph.InterfaceLength(1, 0) == 3);
+}
+
+TEST_CASE("Updated graph matches a rebuilt one", "[contact_graph]")
+{
+    const int sizex = 14, sizey = 11;
+    for (bool periodic : {false, true})
+    {
+        SpinLattice lattice = MakeLattice(sizex, sizey);
+        std::mt19937 rng(11);
+        std::uniform_int_distribution<int> spin(0, 5);
+        std::uniform_int_distribution<int> xs(1, sizex - 2);
+        std::uniform_int_distribution<int> ys(1, sizey - 2);
+        for (int x = 1; x < sizex - 1; x++)
+            for (int y = 1; y < sizey - 1; y++)
+                lattice(x, y) = spin(rng) % 3;
+
+        ContactGraph graph;
+        graph.Build(lattice, sizex, sizey, periodic);
+        for (int i = 0; i < 2000; i++)
+        {
+            const int x = xs(rng), y = ys(rng);
+            const int old_spin = lattice(x, y);
+            lattice(x, y) = spin(rng);
+            graph.Update(lattice, x, y, old_spin);
+        }
+
+        ContactGraph rebuilt;
+        rebuilt.Build(lattice, sizex, sizey, periodic);
+        REQUIRE(Interfaces(graph) == Interfaces(rebuilt));
+    }
+}
@@ -0,0 +1,61 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "mock_model.cpp"
+#include "tissue.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+
+// Reads the edge count of the boundary scheme, which tests may do as friends
+class CellularPottsTest
+{
+public:
+    static std::int64_t TotalEdges(const CellularPotts &cpm)
+    {
+        return cpm.boundary_sites.TotalEdges();
+    }
+};
+
+namespace
+{
+/* A lattice of 800 by 800 sites in diagonal stripes of seven cells, so that
+ * 18 of the 20 neighbours of every site are in another cell. */
+std::unique_ptr<Dish> Stripes()
+{
+    SetTissue(802, 802, false, 7, 5);
+    par.neighbours = 3;
+    par.lambda2 = 0;
+    par.n_chem = 0;
+    par.cpm_update_scheme = "boundary";
+    auto dish = MakeDish(3);
+
+    CellularPotts &cpm = *dish->CPM;
+    for (int x = 1; x < par.sizex - 1; x++)
+        for (int y = 1; y < par.sizey - 1; y++)
+            cpm.getSigma()(x, y) = (x + 3 * y) % 7 + 1;
+    cpm.MeasureCellSizes();
+    for (Cell &cell : *cpm.getCellArray())
+        cell.SetTargetArea(cell.Area());
+    cpm.InitialiseEdgeList();
+    return dish;
+}
+} // namespace
+
+TEST_CASE("The boundary scheme makes one attempt per NNb edges",
+          "[boundary_scheme]")
+{
+    auto dish = Stripes();
+    CellularPotts &cpm = *dish->CPM;
+    REQUIRE(CellularPottsTest::TotalEdges(cpm) > 10000000);
+    for (int mcs = 0; mcs < 2; mcs++)
+    {
+        cpm.AmoebaeMove(dish->PDEfield);
+        // the MCS ends as soon as the attempts reach the edges over NNb,
+        // which the copies change as it goes
+        const std::int64_t edges = CellularPottsTest::TotalEdges(cpm);
+        INFO("MCS " << mcs << ", " << edges << " edges, "
+                    << cpm.CopyAttempts() << " attempts");
+        REQUIRE(std::abs(cpm.CopyAttempts() - edges / 20) <= 2);
+    }
+}
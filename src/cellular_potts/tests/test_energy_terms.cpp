@@ -0,0 +1,75 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "mock_model.cpp"
+#include "tissue.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+
+namespace
+{
+std::unique_ptr<Dish> Tissue(const std::string &scheme, bool periodic)
+{
+    SetTissue(80, 60, periodic, 20, 8);
+    par.target_area = 60;
+    par.lambda2 = 5.0;
+    par.n_chem = 0;
+    par.cpm_update_scheme = scheme;
+    par.cell_compaction_interval = 0;
+    par.energy_check_interval = 0;
+    auto dish = MakeDish(11);
+    for (Cell &cell : *dish->CPM->getCellArray())
+        cell.SetTargetLength(10);
+    return dish;
+}
+
+// The running totals of the terms that MeasureEnergy() measures
+void RequireMeasured(const CellularPotts &cpm)
+{
+    const EnergyTerms &kept = cpm.Energy();
+    const EnergyTerms measured = cpm.MeasureEnergy();
+    const auto tolerance = [](double e) {
+        return 1e-9 * std::max(1.0, std::abs(e));
+    };
+    REQUIRE(std::abs(kept.adhesion - measured.adhesion) <=
+            tolerance(measured.adhesion));
+    REQUIRE(std::abs(kept.area - measured.area) <= tolerance(measured.area));
+    REQUIRE(std::abs(kept.length - measured.length) <=
+            tolerance(measured.length));
+    REQUIRE(std::abs(kept.spreading - measured.spreading) <=
+            tolerance(measured.spreading));
+}
+
+void Check(const std::string &scheme, bool periodic)
+{
+    INFO(scheme << " scheme, periodic " << periodic);
+    auto dish = Tissue(scheme, periodic);
+    CellularPotts &cpm = *dish->CPM;
+    REQUIRE(cpm.MeasureEnergy().length > 0);
+    RequireMeasured(cpm);
+    for (int mcs = 0; mcs < 10; mcs++)
+    {
+        cpm.AmoebaeMove(dish->PDEfield);
+        INFO("MCS " << mcs);
+        RequireMeasured(cpm);
+
+        // changes that a model makes in between MCS
+        Cell &cell = cpm.getCell(1 + mcs % 20);
+        cell.SetTargetArea(cell.TargetArea() + 10);
+        if (mcs == 5)
+            cell.setTau(cell.getTau() == 1 ? 2 : 1);
+    }
+}
+} // namespace
+
+TEST_CASE("The running energy totals follow the accepted copies",
+          "[energy_terms]")
+{
+    for (std::string scheme : {"edgelist", "boundary", "nfold", "checkerboard"})
+    {
+        Check(scheme, false);
+        Check(scheme, true);
+    }
+}
@@ -0,0 +1,109 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "ecm_boundary_state.hpp"
+#include "mock_model.cpp"
+#include "tissue.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+struct Options
+{
+    std::string scheme = "edgelist";
+    bool adhesions = false;
+    bool act = false;
+    bool anneal = false;
+};
+
+/* A network of ECM particles, one every four sites, bonded to their
+ * neighbours. Those that lie in a cell are adhesions. */
+ECMBoundaryState Network(const CellularPotts &cpm)
+{
+    ECMBoundaryState ecm;
+    ecm.bond_types[0] = BondType(4.0, 20.0);
+    const int columns = (cpm.SizeX() - 2) / 4;
+    const int rows = (cpm.SizeY() - 2) / 4;
+    for (int i = 0; i < columns; i++)
+        for (int j = 0; j < rows; j++)
+        {
+            const int x = 4 * i + 2, y = 4 * j + 2;
+            const ParId id = i * rows + j;
+            const ParticleType type = cpm.Sigma(x, y) > 0
+                                          ? ParticleType::adhesion
+                                          : ParticleType::free;
+            ecm.particles[id] = Particle(id, ParPos(x + 0.5, y + 0.5), type);
+            if (i > 0)
+                ecm.bonds[2 * id] = Bond(id - rows, id, 0);
+            if (j > 0)
+                ecm.bonds[2 * id + 1] = Bond(id - 1, id, 0);
+        }
+    return ecm;
+}
+
+/* The lattice after a few MCS from a fixed seed. The Metropolis numbers come
+ * from the CPM's own Philox substreams, which lazy and eager evaluation draw
+ * from equally often. */
+std::vector<int> Simulate(const Options &options, bool lazy)
+{
+    SetTissue(80, 60, false, 20, 8);
+    par.target_area = 60;
+    par.n_chem = 1;
+    par.chemotaxis = 1000;
+    par.cpm_update_scheme = options.scheme;
+    par.random_generator = "philox";
+    par.lazy_deltah = lazy;
+    par.adhesions_enabled = options.adhesions;
+    par.lambda_Act = options.act ? 200 : 0;
+    par.max_Act = options.act ? 20 : 0;
+    auto dish = MakeDish(17);
+    for (int x = 0; x < par.sizex; x++)
+        for (int y = 0; y < par.sizey; y++)
+            dish->PDEfield->setValue(0, x, y, 0.01 * y);
+    if (options.adhesions)
+        dish->CPM->SetECMBoundaryState(Network(*dish->CPM));
+    for (int mcs = 0; mcs < 10; mcs++)
+        dish->CPM->AmoebaeMove(dish->PDEfield, options.anneal && mcs >= 5);
+    return dish->CPM->getSigmaArray();
+}
+
+void Check(const Options &options)
+{
+    INFO(options.scheme << " scheme, adhesions " << options.adhesions
+                        << ", act " << options.act << ", anneal "
+                        << options.anneal);
+    const auto eager = Simulate(options, false);
+    const auto lazy = Simulate(options, true);
+    REQUIRE(eager.size() == lazy.size());
+    int different = 0;
+    for (std::size_t i = 0; i < eager.size(); i++)
+        different += (eager[i] != lazy[i]);
+    REQUIRE(different == 0);
+}
+} // namespace
+
+TEST_CASE("Lazy and eager DeltaH give the same lattice", "[lazy_deltah]")
+{
+    for (std::string scheme : {"edgelist", "boundary"})
+    {
+        Options options;
+        options.scheme = scheme;
+        Check(options);
+
+        options.adhesions = true;
+        Check(options);
+
+        options.adhesions = false;
+        options.act = true;
+        Check(options);
+
+        options.adhesions = true;
+        Check(options);
+
+        options.anneal = true;
+        Check(options);
+    }
+}
@@ -0,0 +1,109 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "mock_model.cpp"
+#include "specialised_move.cpp"
+#include "tissue.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Brings the n-fold way up to date, which tests may do as friends
+class CellularPottsTest
+{
+public:
+    // as AmoebaeMove() does before an MCS
+    static void NFoldSync(CellularPotts &cpm, PDE *pde)
+    {
+        cpm.FillHalo();
+        cpm.hot_cells.Refresh(*cpm.cell);
+        cpm.NFoldSync<8, false>(pde, false);
+    }
+
+    static const CellBoundaries &Boundaries(const CellularPotts &cpm)
+    {
+        return cpm.nfold.boundaries;
+    }
+};
+
+namespace
+{
+/* Two square cells side by side, with cell 1 reaching two sites into cell 2
+ * at y = 20. */
+std::unique_ptr<Dish> Squares()
+{
+    SetTissue(50, 40, false, 2, 5);
+    par.target_area = 200;
+    par.n_chem = 0;
+    par.cpm_update_scheme = "nfold";
+    par.cell_compaction_interval = 0;
+    par.energy_check_interval = 0;
+    auto dish = MakeDish(13);
+
+    CellularPotts &cpm = *dish->CPM;
+    for (int x = 1; x < par.sizex - 1; x++)
+        for (int y = 1; y < par.sizey - 1; y++)
+            cpm.getSigma()(x, y) =
+                y < 10 || y >= 30 || x < 10 || x >= 40 ? 0 : x < 30 ? 1 : 2;
+    cpm.getSigma()(30, 20) = 1;
+    cpm.getSigma()(31, 20) = 1;
+    cpm.MeasureCellSizes();
+    cpm.InitialiseEdgeList();
+    return dish;
+}
+
+// The boundary sites of every cell match the lattice
+void RequireBoundaries(const CellularPotts &cpm)
+{
+    const CellBoundaries &boundaries = CellularPottsTest::Boundaries(cpm);
+    const std::int64_t width = par.sizex - 2;
+    const int n_cells = static_cast<int>(cpm.getCellArray()->size());
+    std::vector<std::vector<std::int64_t>> expected(n_cells);
+    for (int y = 1; y < par.sizey - 1; y++)
+        for (int x = 1; x < par.sizex - 1; x++)
+        {
+            const int c = cpm.Sigma(x, y);
+            bool boundary = false;
+            for (int dx = -1; dx <= 1; dx++)
+                for (int dy = -1; dy <= 1; dy++)
+                {
+                    const int sn = cpm.Sigma(x + dx, y + dy);
+                    boundary |= (sn != c && sn != -1);
+                }
+            if (c > 0 && boundary)
+                expected[c].push_back((x - 1) + (y - 1) * width);
+        }
+    for (int c = 1; c < n_cells; c++)
+    {
+        INFO("cell " << c);
+        auto sites = boundaries.Sites(c);
+        std::sort(sites.begin(), sites.end());
+        REQUIRE(sites == expected[c]);
+    }
+}
+} // namespace
+
+TEST_CASE("Repainted sites keep the n-fold boundaries",
+          "[nfold_boundaries]")
+{
+    auto dish = Squares();
+    CellularPotts &cpm = *dish->CPM;
+    CellularPottsTest::NFoldSync(cpm, dish->PDEfield);
+    RequireBoundaries(cpm);
+
+    /* Hand both sites back to cell 2, as a model would in between MCS. The
+     * first one makes the second an interior site of cell 2 while it is
+     * still listed as a boundary site of cell 1. */
+    cpm.getSigma()(30, 20) = 2;
+    cpm.getSigma()(31, 20) = 2;
+    cpm.MeasureCellSizes();
+    CellularPottsTest::NFoldSync(cpm, dish->PDEfield);
+    RequireBoundaries(cpm);
+
+    for (int mcs = 0; mcs < 5; mcs++)
+    {
+        INFO("MCS " << mcs);
+        cpm.AmoebaeMove(dish->PDEfield);
+        RequireBoundaries(cpm);
+    }
+}
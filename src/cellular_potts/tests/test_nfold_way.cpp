@@ -0,0 +1,91 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "nfold_way.cpp"
+
+#include <algorithm>
+
+using Catch::Matchers::WithinAbs;
+
+TEST_CASE("Rates are summed and found", "[nfold_way]")
+{
+    RateTree tree;
+    tree.Reset(5);
+    REQUIRE(tree.Total() == 0.0);
+
+    tree.Set(0, 1.0);
+    tree.Set(2, 0.5);
+    tree.Set(4, 0.25);
+    REQUIRE_THAT(tree.Total(), WithinAbs(1.75, 1e-12));
+    REQUIRE(tree.Get(2) == 0.5);
+
+    double target = 0.3;
+    REQUIRE(tree.Find(target) == 0);
+    REQUIRE_THAT(target, WithinAbs(0.3, 1e-12));
+
+    target = 1.2;
+    REQUIRE(tree.Find(target) == 2);
+    REQUIRE_THAT(target, WithinAbs(0.2, 1e-12));
+
+    target = 1.6;
+    REQUIRE(tree.Find(target) == 4);
+
+    // rounding past the total still gives an index with a positive weight
+    target = 1.75;
+    REQUIRE(tree.Find(target) == 4);
+
+    tree.Set(4, 0.0);
+    target = 1.7;
+    REQUIRE(tree.Find(target) == 2);
+    REQUIRE_THAT(tree.Total(), WithinAbs(1.5, 1e-12));
+}
+
+TEST_CASE("Cell boundaries are added and removed", "[nfold_way]")
+{
+    CellBoundaries boundaries;
+    boundaries.Reset(20);
+    REQUIRE(boundaries.Sites(3).empty());
+
+    boundaries.Add(3, 4);
+    boundaries.Add(3, 7);
+    boundaries.Add(3, 9);
+    boundaries.Add(1, 10);
+    boundaries.Add(3, 7);
+    REQUIRE(boundaries.Sites(3).size() == 3);
+    REQUIRE(boundaries.Contains(10));
+    REQUIRE(!boundaries.Contains(5));
+
+    // removing from the middle keeps the others findable
+    boundaries.Remove(3, 4);
+    boundaries.Remove(3, 4);
+    auto sites = boundaries.Sites(3);
+    std::sort(sites.begin(), sites.end());
+    REQUIRE(sites == std::vector<std::int64_t>{7, 9});
+    boundaries.Remove(3, 9);
+    REQUIRE(boundaries.Sites(3) == std::vector<std::int64_t>{7});
+    REQUIRE(boundaries.Sites(1) == std::vector<std::int64_t>{10});
+}
+
+TEST_CASE("Cell boundaries belong to one cell at a time", "[nfold_way]")
+{
+    CellBoundaries boundaries;
+    boundaries.Reset(20);
+    boundaries.Add(3, 4);
+    boundaries.Add(3, 5);
+    boundaries.Add(1, 6);
+
+    // a site that changes cells moves to the list of its new cell
+    boundaries.Add(1, 4);
+    REQUIRE(boundaries.Sites(3) == std::vector<std::int64_t>{5});
+    auto sites = boundaries.Sites(1);
+    std::sort(sites.begin(), sites.end());
+    REQUIRE(sites == std::vector<std::int64_t>{4, 6});
+
+    // and cannot be removed from the list of another cell
+    boundaries.Remove(3, 4);
+    boundaries.Remove(7, 6);
+    REQUIRE(boundaries.Contains(4));
+    REQUIRE(boundaries.Contains(6));
+    REQUIRE(boundaries.Sites(3) == std::vector<std::int64_t>{5});
+    REQUIRE(boundaries.Sites(1).size() == 2);
+}
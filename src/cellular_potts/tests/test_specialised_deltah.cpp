@@ -0,0 +1,118 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "mock_model.cpp"
+#include "specialised_move.cpp"
+#include "tissue.hpp"
+
+#include <cmath>
+#include <memory>
+
+// Compares SpecialisedDeltaH() with DeltaH(), which tests may do as friends
+class CellularPottsTest
+{
+public:
+    /* The number of copies between neighbouring sites of different spins
+     * for which both give the same energy change, out of all of them in
+     * total. */
+    template <int NNb, bool Periodic, bool Act>
+    static void CompareDeltaH(CellularPotts &cpm, PDE *pde, int &total,
+                              int &same)
+    {
+        // as AmoebaeMove() sets up a sweep
+        cpm.FillHalo();
+        cpm.hot_cells.Refresh(*cpm.cell);
+        total = same = 0;
+        for (int x = 1; x < cpm.sizex - 1; x++)
+            for (int y = 1; y < cpm.sizey - 1; y++)
+                for (int k = 1; k <= NNb; k++)
+                {
+                    int xp = x + CellularPotts::nx[k];
+                    int yp = y + CellularPotts::ny[k];
+                    if (cpm.sigma(xp, yp) == cpm.sigma(x, y) ||
+                        cpm.sigma(xp, yp) == -1)
+                        continue;
+                    if (Periodic)
+                    {
+                        xp = (xp + cpm.sizex - 3) % (cpm.sizex - 2) + 1;
+                        yp = (yp + cpm.sizey - 3) % (cpm.sizey - 2) + 1;
+                    }
+                    AdhesionDisplacements generic_disp, specialised_disp;
+                    const int generic =
+                        cpm.DeltaH(x, y, xp, yp, pde, &generic_disp);
+                    const int specialised =
+                        cpm.SpecialisedDeltaH<NNb, Periodic, false, Act>(
+                            x, y, xp, yp, pde, &specialised_disp, HUGE_VAL,
+                            nullptr, nullptr);
+                    total++;
+                    same += (generic == specialised);
+                }
+        cpm.hot_cells.Stop();
+        cpm.ClearHalo();
+    }
+};
+
+namespace
+{
+// A dish of cells of random types, roughened by a few MCS, with a
+// chemical gradient and, if act, an act field
+std::unique_ptr<Dish> RandomDish(int neighbours, bool periodic, bool act,
+                                 long seed)
+{
+    SetTissue(60, 50, periodic, 20, 8);
+    par.neighbours = neighbours;
+    par.target_area = 40;
+    par.n_chem = 1;
+    par.chemotaxis = 1000;
+    par.lambda_Act = act ? 200 : 0;
+    par.max_Act = act ? 20 : 0;
+    par.cpm_update_scheme = "edgelist";
+    auto dish = MakeDish(seed);
+    for (int x = 0; x < par.sizex; x++)
+        for (int y = 0; y < par.sizey; y++)
+            dish->PDEfield->setValue(0, x, y, 0.01 * x + 0.002 * ((x * y) % 7));
+    for (int i = 0; i < 5; i++)
+        dish->CPM->AmoebaeMove(dish->PDEfield);
+    return dish;
+}
+
+template <int NNb, bool Periodic, bool Act>
+void Check(int neighbours, long seed)
+{
+    auto dish = RandomDish(neighbours, Periodic, Act, seed);
+    int total, same;
+    CellularPottsTest::CompareDeltaH<NNb, Periodic, Act>(
+        *dish->CPM, dish->PDEfield, total, same);
+    INFO("neighbours " << neighbours << ", periodic " << Periodic
+                       << ", act " << Act);
+    REQUIRE(total > 1000);
+    REQUIRE(same == total);
+}
+} // namespace
+
+// parameter.hpp takes the name SECTION, so one test case per neighbourhood
+TEST_CASE("Specialised DeltaH agrees on a von Neumann neighbourhood",
+          "[specialised_move]")
+{
+    Check<4, false, false>(1, 1);
+    Check<4, true, false>(1, 2);
+    Check<4, false, true>(1, 3);
+    Check<4, true, true>(1, 4);
+}
+
+TEST_CASE("Specialised DeltaH agrees on a Moore neighbourhood",
+          "[specialised_move]")
+{
+    Check<8, false, false>(2, 5);
+    Check<8, true, false>(2, 6);
+    Check<8, false, true>(2, 7);
+    Check<8, true, true>(2, 8);
+}
+
+TEST_CASE("Specialised DeltaH agrees on a third order neighbourhood",
+          "[specialised_move]")
+{
+    Check<20, false, false>(3, 9);
+    Check<20, true, false>(3, 10);
+    Check<20, false, true>(3, 11);
+    Check<20, true, true>(3, 12);
+}
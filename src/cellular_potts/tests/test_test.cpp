@@ -97,9 +97,8 @@ TEST_CASE("Novikova Storm")
     }
 }
 #include "act.cpp"
-std::unordered_map<PixelPos, double> ACT::getValue(ACT::ActField act_field) {
-    return act_field.value_;
-}
+#include "array2d.cpp"
+#include "spin_lattice.cpp"
 TEST_CASE("Act Model")
 {
     SECTION("Setting and Getting values")
@@ -122,15 +121,11 @@ TEST_CASE("Act Model")
     {
         ACT::ActField act_field;
         
-        int** sigma = new int*[4];
-        sigma[0] = new int[4]; 
-        sigma[1] = new int[4]; 
-        sigma[2] = new int[4]; 
-        sigma[3] = new int[4]; 
+        SpinLattice sigma(4, 4, 0, 0);
         
         for (int i=0; i<4; i++)
         for (int j=0; j<4; j++)
-            sigma[i][j]=0;
+            sigma(i, j)=0;
 
         act_field.SetValue({1+0,  1+0}, 1.0);
         act_field.SetValue({1+1,  1+0}, 1.0);
@@ -174,25 +169,21 @@ TEST_CASE("Act Model")
 //            {2,2,2,0},
 //        };
 
-        int** sigma = new int*[4];
-        sigma[0] = new int[4]; 
-        sigma[1] = new int[4]; 
-        sigma[2] = new int[4]; 
-        sigma[3] = new int[4]; 
+        SpinLattice sigma(4, 4, 0, 0);
         
         for (int i=0; i<4; i++)
         for (int j=0; j<4; j++)
-            sigma[i][j]=0;
+            sigma(i, j)=0;
         
-        sigma[2][0] = 1;
-        sigma[3][0] = 1;
-        sigma[2][1] = 1;
-        sigma[3][1] = 1;
-        sigma[0][2] = 2;
-        sigma[1][2] = 2;
-        sigma[0][3] = 2;
-        sigma[1][3] = 2;
-        sigma[2][3] = 2;
+        sigma(2, 0) = 1;
+        sigma(3, 0) = 1;
+        sigma(2, 1) = 1;
+        sigma(3, 1) = 1;
+        sigma(0, 2) = 2;
+        sigma(1, 2) = 2;
+        sigma(0, 3) = 2;
+        sigma(1, 3) = 2;
+        sigma(2, 3) = 2;
 
         act_field.SetValue({2,0}, 19);
         act_field.SetValue({3,0}, 11);
@@ -210,6 +201,9 @@ TEST_CASE("Act Model")
         auto dh = ACT::DeltaH(act_field, sigma, {1,2}, {2,1}, par.lambda_Act, par.max_Act); 
 
         REQUIRE_THAT(dh * par.max_Act, WithinAbs(1.46 , 0.01));
+
+        // cells without act skip the geometric means
+        REQUIRE(ACT::DeltaH(act_field, sigma, {1,2}, {2,1}, 0.0, par.max_Act) == 0.0);
     }
     SECTION ("Test decreasing and deleting of positions") {
         ACT::ActField actin_field;
@@ -246,4 +240,21 @@ TEST_CASE("Act Model")
         value = act_field.Value({5,5});
         REQUIRE( value == 123);
     }
+    SECTION ("Field grows and keeps live pixels") {
+        ACT::ActField act_field(4, 4);
+
+        act_field.SetValue({1,1}, 1);
+        act_field.SetValue({2,3}, 3);
+        act_field.SetValue({30,12}, 2);
+        REQUIRE( act_field.Value({30,12}) == 2 );
+        REQUIRE( act_field.Value({2,3}) == 3 );
+        REQUIRE( act_field.Value({100,100}) == 0.0 );
+
+        act_field.Decrease();
+        auto values = getValue(act_field);
+        REQUIRE( values.size() == 2 );
+        REQUIRE( values[{2,3}] == 2 );
+        REQUIRE( values[{30,12}] == 1 );
+        REQUIRE( act_field.Value({1,1}) == 0.0 );
+    }
 }
\ No newline at end of file
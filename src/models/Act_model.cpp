@@ -104,19 +104,15 @@ void PDE::InitialiseAgeLayer(int l, double value, CellularPotts *cpm) {
       }
     }
   }
+  chemotaxis_potential.Stop();
 }
 
 void PDE::AgeLayer(int l, double value, CellularPotts *cpm, Dish *dish) {
-  for (const auto elem : cpm->actPixels) {
-    /* ... process elem ... */
-    if (elem.second > 0.) {
-      cpm->actPixels[elem.first] -= value;
-    }
-  }
+  cpm->act_pixels.Age(value);
 }
 
 void PDE::MILayerCA(int l, double value, CellularPotts *cpm, Dish *dish) {
-  for (const auto &elem : cpm->alivePixels) {
+  for (const auto &elem : cpm->act_pixels.AlivePixels()) {
     int x = elem[0];
     int y = elem[1];
     int sigma_c = cpm->Sigma(x, y);
@@ -27,6 +27,7 @@ Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
 #include <malloc.h>
 #endif
 #include <algorithm>
+#include <array>
 #include <cstdint>
 #include <cstdlib>
 #include <fstream>
@@ -70,10 +71,6 @@ extern Parameter par;
 
 std::unique_ptr<Instance> instance;
 #include "act.hpp"
-std::unordered_map<PixelPos, double> ACT::getValue(ACT::ActField act_field)
-{
-    return act_field.value_;
-}
 
 INIT
 {
@@ -192,43 +189,43 @@ void PDE::InitialisePDEvars(CellularPotts *cpm, int *celltypes)
             PDEvars[0][x][y] = value;
         }
     }
+    chemotaxis_potential.Stop();
 }
 
 void add_bias_to_act(const std::vector<Vec2<double>> biasdirections,
                      ACT::ActField &act_field,
-                     const vector<Cell> &cells,
-                     int **sigma)
+                     const CellPool &cells,
+                     const CellPixels &pixels)
 {
-    // Used to compute the max length of every cell
-    // i.e. the denominator in Figure 5.2 blz 126 thesis of Daipeng
-    std::vector<double> max_length(cells.size());
-    std::unordered_map<PixelPos, double> values_to_increase;
-    for (int i = 0; i<par.sizex; i++){
-        for (int j = 0; j < par.sizey; j++){
-            const int spin = sigma[i][j];
-            auto biasdirection = biasdirections[spin];
-            if (spin <= 0 ) continue;
-            const Vec2<double> pixel = {1.0*i,1.0*j};
-            const auto center = cells[spin].CenterVector();
-            const auto relative_position = pixel - center;
-            const auto length = relative_position.length();
-            if (length > max_length[spin])
-                max_length[spin] = length;
-
-            values_to_increase[{i,j}] = biasdirection.dot(relative_position);
+    const int n_cells = std::min<int>(cells.size(), pixels.Cells());
+    for (int spin = 1; spin < n_cells; spin++)
+    {
+        const auto biasdirection = biasdirections[spin];
+        const auto center = cells[spin].CenterVector();
+
+        // Used to compute the max length of every cell
+        // i.e. the denominator in Figure 5.2 blz 126 thesis of Daipeng
+        double max_length = 0.0;
+        for (const auto &p : pixels.Pixels(spin))
+        {
+            const Vec2<double> pixel = {1.0 * p[0], 1.0 * p[1]};
+            const auto length = (pixel - center).length();
+            if (length > max_length)
+                max_length = length;
         }
-    }
 
-    /* We can delay dividing out the factor max_i=1^n |x_i - x_0| 
-     * because the innerproduct is a linear operation.
-    */ 
-    for (const auto & pixelvalue : values_to_increase) {
-        const auto pixel = pixelvalue.first;
-        const auto scale = max_length[sigma[pixel.x][pixel.y]];
-        const auto value = values_to_increase[pixel] / scale;
-        if (value > act_field.Value(pixel)) {
-            // act_field.IncreaseValue(pixel, value);
-            act_field.SetValue(pixel, value);
+        /* We can delay dividing out the factor max_i=1^n |x_i - x_0|
+         * because the innerproduct is a linear operation.
+        */
+        for (const auto &p : pixels.Pixels(spin))
+        {
+            const Vec2<double> pixel = {1.0 * p[0], 1.0 * p[1]};
+            const auto value =
+                biasdirection.dot(pixel - center) / max_length;
+            if (value > act_field.Value({p[0], p[1]})) {
+                // act_field.IncreaseValue(pixel, value);
+                act_field.SetValue({p[0], p[1]}, value);
+            }
         }
     }
 }
@@ -239,15 +236,15 @@ void add_bias_to_act(const std::vector<Vec2<double>> biasdirections,
  * 
 */
 void add_vegf_bias_in_act(const Vec2<double> biasdirection,
-                          ACT::ActField &act_field, const vector<Cell> &cells,
-                          int** sigma)
+                          ACT::ActField &act_field, const CellPool &cells,
+                          const CellPixels &pixels)
 {
     std::vector<Vec2<double>> biasdirections(cells.size(), biasdirection);
     add_bias_to_act(
         biasdirections,
         act_field,
         cells,
-        sigma
+        pixels
     );
 }
 
@@ -311,20 +308,24 @@ TIMESTEP
             dish->CPM->DivideCells(which_cells, dish->cell);
         }
 
+        // the tip cell owns the first pixel of a scan of the lattice, rows
+        // first, and that pixel is on the boundary of its cell
         int tipcell = -1;
-        for (int j = 0; j < par.sizey; j++)
         {
-            for (int i = 0; i < par.sizex; i++)
+            const CellPixels &pixels = dish->CPM->GetCellPixels();
+            std::array<int, 2> first{par.sizey, par.sizex};
+            for (int c = 1; c < pixels.Cells(); c++)
             {
-                auto spin = dish->CPM->Sigma(i, j);
-                if (spin > 0 && tipcell == -1)
+                for (const auto &pixel : pixels.Boundary(c))
                 {
-                    tipcell = spin;
-                    break;
+                    const std::array<int, 2> yx{pixel[1], pixel[0]};
+                    if (yx < first)
+                    {
+                        first = yx;
+                        tipcell = c;
+                    }
                 }
             }
-            if (tipcell != -1)
-                break;
         }
         for (auto &c : dish->cell)
         {
@@ -343,7 +344,7 @@ TIMESTEP
                 {0.0, -1.0},
                 dish->CPM->getActField(),
                 dish->cell,
-                dish->CPM->getSigma()
+                dish->CPM->GetCellPixels()
             );
         }
 
@@ -368,7 +369,7 @@ TIMESTEP
                 directions,
                 dish->CPM->getActField(),
                 dish->cell,
-                dish->CPM->getSigma()
+                dish->CPM->GetCellPixels()
             );
         }
 
@@ -385,9 +386,9 @@ TIMESTEP
             {
                 std::cerr << "i = " << i << ", sending on state_out"
                           << std::endl;
-                auto *cpm_sigma = dish->CPM->getSigma()[0];
+                auto cpm_sigma = dish->CPM->getSigmaArray();
                 Data cpm_state =
-                    Data::grid(cpm_sigma,
+                    Data::grid(cpm_sigma.data(),
                                {static_cast<std::size_t>(dish->CPM->SizeX()),
                                 static_cast<std::size_t>(dish->CPM->SizeY())},
                                {"x", "y"}, StorageOrder::last_adjacent);
@@ -84,6 +84,12 @@ INIT {
     }
 
     CPM->InitialiseEdgeList();
+
+    // SecreteAndDiffuse() steps the secretion and decay of Secrete(), which
+    // only plane 0 has
+    for (int l = 0; l < par.n_chem; l++)
+      PDEfield->SetSecretion(l, l == 0 ? par.secr_rate[0] : 0,
+                             l == 0 ? par.decay_rate[0] : 0);
   } catch (const char *error) {
     cerr << "Caught exception\n";
     std::cerr << error << "\n";
@@ -123,10 +129,8 @@ TIMESTEP {
         PROFILE(opencl_diff,
                 dish->PDEfield->SecreteAndDiffuseCL(dish->CPM, par.pde_its);)
       } else {
-        for (int r = 0; r < par.pde_its; r++) {
-          dish->PDEfield->Secrete(dish->CPM);
-          dish->PDEfield->Diffuse(1);
-        }
+        // with the rates declared in INIT
+        dish->PDEfield->SecreteAndDiffuse(dish->CPM, par.pde_its);
       }
     }
 
@@ -140,9 +144,9 @@ TIMESTEP {
     if (instance->is_connected("state_out")) {
       if (i % instance->get_setting_as<int64_t>("state_output_interval") == 0) {
         std::cerr << "i = " << i << ", sending on state_out" << std::endl;
-        auto *cpm_sigma = dish->CPM->getSigma()[0];
+        auto cpm_sigma = dish->CPM->getSigmaArray();
         Data cpm_state =
-            Data::grid(cpm_sigma,
+            Data::grid(cpm_sigma.data(),
                        {static_cast<std::size_t>(dish->CPM->SizeX()),
                         static_cast<std::size_t>(dish->CPM->SizeY())},
                        {"x", "y"}, StorageOrder::last_adjacent);
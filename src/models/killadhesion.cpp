@@ -203,9 +203,9 @@ TIMESTEP {
         if (instance->is_connected("state_out")) {
             if (i % instance->get_setting_as<int64_t>("state_output_interval") == 0) {
                 std::cerr << "i = " << i << ", sending on state_out" << std::endl;
-                auto *cpm_sigma = dish->CPM->getSigma()[0];
+                auto cpm_sigma = dish->CPM->getSigmaArray();
                 Data cpm_state = Data::grid(
-                    cpm_sigma,
+                    cpm_sigma.data(),
                     {static_cast<std::size_t>(dish->CPM->SizeX()),
                      static_cast<std::size_t>(dish->CPM->SizeY())},
                     {"x", "y"},
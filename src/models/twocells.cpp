@@ -70,10 +70,6 @@ extern Parameter par;
 
 std::unique_ptr<Instance> instance;
 #include "act.hpp"
-std::unordered_map<PixelPos, double> ACT::getValue(ACT::ActField act_field)
-{
-    return act_field.value_;
-}
 
 INIT
 {
@@ -134,8 +130,8 @@ void PDE::InitialisePDEvars(CellularPotts *cpm, int *celltypes)
 
 void add_bias_to_act(const std::vector<Vec2<double>> biasdirections,
                      ACT::ActField &act_field,
-                     const vector<Cell> &cells,
-                     int **sigma)
+                     const CellPool &cells,
+                     const SpinLattice &sigma)
 {
     // Used to compute the max length of every cell
     // i.e. the denominator in Figure 5.2 blz 126 thesis of Daipeng
@@ -143,7 +139,7 @@ void add_bias_to_act(const std::vector<Vec2<double>> biasdirections,
     std::unordered_map<PixelPos, double> values_to_increase;
     for (int i = 0; i<par.sizex; i++){
         for (int j = 0; j < par.sizey; j++){
-            const int spin = sigma[i][j];
+            const int spin = sigma(i, j);
             auto biasdirection = biasdirections[spin];
             if (spin <= 0 ) continue;
             const Vec2<double> pixel = {1.0*i,1.0*j};
@@ -162,7 +158,7 @@ void add_bias_to_act(const std::vector<Vec2<double>> biasdirections,
     */ 
     for (const auto & pixelvalue : values_to_increase) {
         const auto pixel = pixelvalue.first;
-        const auto scale = max_length[sigma[pixel.x][pixel.y]];
+        const auto scale = max_length[sigma(pixel.x, pixel.y)];
         const auto value = values_to_increase[pixel] / scale;
         if (value > act_field.Value(pixel)) {
             // act_field.IncreaseValue(pixel, value);
@@ -177,8 +173,8 @@ void add_bias_to_act(const std::vector<Vec2<double>> biasdirections,
  * 
 */
 void add_vegf_bias_in_act(const Vec2<double> biasdirection,
-                          ACT::ActField &act_field, const vector<Cell> &cells,
-                          int** sigma)
+                          ACT::ActField &act_field, const CellPool &cells,
+                          const SpinLattice &sigma)
 {
     std::vector<Vec2<double>> biasdirections(cells.size(), biasdirection);
     add_bias_to_act(
@@ -244,9 +240,9 @@ TIMESTEP
             {
                 std::cerr << "i = " << i << ", sending on state_out"
                           << std::endl;
-                auto *cpm_sigma = dish->CPM->getSigma()[0];
+                auto cpm_sigma = dish->CPM->getSigmaArray();
                 Data cpm_state =
-                    Data::grid(cpm_sigma,
+                    Data::grid(cpm_sigma.data(),
                                {static_cast<std::size_t>(dish->CPM->SizeX()),
                                 static_cast<std::size_t>(dish->CPM->SizeY())},
                                {"x", "y"}, StorageOrder::last_adjacent);
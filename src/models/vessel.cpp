@@ -57,6 +57,11 @@ INIT {
 
     CPM->InitialiseEdgeList();
 
+    // SecreteAndDiffuse() steps the secretion and decay of DerivativesPDE(),
+    // which only plane 0 has
+    for (int l = 0; l < par.n_chem; l++)
+      PDEfield->SetSecretion(l, l == 0 ? par.secr_rate[0] : 0,
+                             l == 0 ? par.decay_rate[0] : 0);
   } catch (const char *error) {
     cerr << "Caught exception\n";
     std::cerr << error << "\n";
@@ -76,11 +81,18 @@ TIMESTEP {
                 dish->PDEfield->SecreteAndDiffuseCL(dish->CPM, par.pde_its);)
       } else if (i == par.relaxation) {
         dish->PDEfield->InitialisePDE(dish->CPM);
+        // the potential of the relaxation MCS is of the planes from before
+        dish->PDEfield->InvalidateChemotaxisPotential();
         dish->PDEfield->InitialiseDiffusionCoefficients(dish->CPM);
 #ifdef CUDA_ENABLED
         if (par.usecuda)
           dish->PDEfield->InitialiseCuda();
 #endif
+      } else if (!par.usecuda && (!par.multigrid_layers.empty() ||
+                                  par.pde_solver != "euler")) {
+        // with the rates declared in INIT, and the pde_its steps taken as
+        // one with adi or spectral
+        dish->PDEfield->SecreteAndDiffuse(dish->CPM, par.pde_its);
       } else {
         for (int r = 0; r < par.pde_its; r++) {
           if (!par.usecuda) {
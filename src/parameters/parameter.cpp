@@ -1,6 +1,7 @@
 #include "parameter.hpp"
 #include "parameter_file.hpp"
 
+#include <algorithm>
 #include <iomanip>
 #include <vector>
 
@@ -105,6 +105,10 @@ ParameterFile::get<std::vector<double>>(std::string const &name) const {
   std::size_t idx = 0u;
   std::vector<double> result;
 
+  // an empty list, as written for an empty vector
+  if (svalue.empty())
+    return result;
+
   try {
     result.emplace_back(std::stod(svalue, &idx));
   } catch (std::invalid_argument const &e) {
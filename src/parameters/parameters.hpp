@@ -43,6 +43,21 @@ PARAMETER(
 
 PARAMETER(int, rseed, -1, "Random seed for the simulation")
 
+PARAMETER(std::string, random_generator, "knuth",
+          "Random number generator for the CPM copy attempts\n"
+          "\n"
+          "knuth: the global RANDOM() stream\n"
+          "philox: counter-based Philox4x32 substreams derived from rseed.\n"
+          "    Results are reproducible for a given seed and thread count.\n"
+          "    The checkerboard update scheme always uses philox.\n")
+CONSTRAINT(random_generator == "knuth" || random_generator == "philox",
+           "random_generator must be one of knuth, philox")
+
+PARAMETER(int, threads, 1,
+          "Number of threads used by the multi-threaded CPM and PDE code")
+
+CONSTRAINT(threads >= 1, "threads must be at least 1")
+
 PARAMETER(bool, usecuda, false, "Whether to use CUDA for PDE calculations")
 PARAMETER(int, number_of_cores, 1,
           "Number of cores used in CUDA kernels, check for your device!")
@@ -115,6 +130,72 @@ PARAMETER(int, neighbours, 2,
           " energy. 0: no neighbours, 1: 4 orthogonal neighbours (von Neumann),"
           "  2: 8 direct neighbours (Moore), 3: 5x5 block minus the corners.")
 
+PARAMETER(std::string, cpm_update_scheme, "edgelist",
+          "How AmoebaeMove selects copy attempts\n"
+          "\n"
+          "edgelist: serial Metropolis over the list of cell boundary edges\n"
+          "boundary: like edgelist, but keeps a list of the sites on a cell\n"
+          "    boundary, using a byte per site and 8 per boundary site\n"
+          "    rather than 8 per neighbour of every site. Copy attempts are\n"
+          "    drawn with the same probabilities, from a different random\n"
+          "    sequence.\n"
+          "nfold: rejection-free n-fold way. Draws only accepted copies,\n"
+          "    with the same relative probabilities as edgelist, and\n"
+          "    advances time by exponential waiting times. Pays off at low\n"
+          "    T, where most copy attempts are rejected.\n"
+          "checkerboard: tiles of the lattice are updated in parallel, using\n"
+          "    'threads' threads. Tiles of the same colour in a 2x2\n"
+          "    checkerboard do not interact and are swept concurrently.\n")
+CONSTRAINT(cpm_update_scheme == "edgelist" ||
+               cpm_update_scheme == "boundary" ||
+               cpm_update_scheme == "nfold" ||
+               cpm_update_scheme == "checkerboard",
+           "cpm_update_scheme must be one of edgelist, boundary, nfold,"
+           " checkerboard")
+CONSTRAINT(cpm_update_scheme != "checkerboard" ||
+               (!adhesions_enabled && lambda_Act == 0.0),
+           "The checkerboard update scheme does not support adhesions or"
+           " lambda_Act > 0")
+CONSTRAINT(cpm_update_scheme != "nfold" ||
+               (!adhesions_enabled && lambda_Act == 0.0),
+           "The nfold update scheme does not support adhesions or"
+           " lambda_Act > 0")
+
+PARAMETER(int, cpm_tile_size, 32,
+          "Minimum width of a checkerboard tile, in pixels. Runs are only"
+          " reproducible for a given seed if no cell spans a whole tile.")
+CONSTRAINT(cpm_tile_size >= 4, "cpm_tile_size must be at least 4")
+
+PARAMETER(bool, lazy_deltah, false,
+          "In the edgelist and boundary schemes, draw the Metropolis random"
+          " number before computing the energy change of a copy attempt, and"
+          " skip the adhesion and act terms when the attempt is certain to be"
+          " rejected without them. Moves are accepted with the same"
+          " probabilities, but the random numbers are drawn in a different"
+          " order.")
+
+PARAMETER(int, cell_compaction_interval, 0,
+          "Every this many MCS, remove the cells that have died from the"
+          " cell table and renumber the others, so that memory use follows"
+          " the number of live cells. Models that keep cell ids across MCS"
+          " must renumber them with CellularPotts::CellIdMapping(). Set to 0"
+          " to disable.")
+
+PARAMETER(int, connectivity_check_interval, 0,
+          "Check every this many MCS that no cell is in more than one piece,"
+          " and stop with an error if one is. This takes a pass over the"
+          " whole lattice, so it is meant for debugging. Set to 0 to disable.")
+
+PARAMETER(int, energy_check_interval, 100,
+          "Once CellularPotts::Energy() has been asked for, measure the"
+          " energy of the lattice from scratch every this many MCS, warn if"
+          " the running totals have drifted from it, and carry on from the"
+          " measured values. Set to 0 to disable.")
+
+PARAMETER(int, mcs_rate_report_interval, 0,
+          "Print the number of MCS per second achieved by AmoebaeMove every"
+          " this many MCS. Set to 0 to disable.")
+
 SECTION("Actin model")
 
 PARAMETER(int, ref_adhesive_area, 100,
@@ -154,6 +235,29 @@ PARAMETER(int, relaxation, 0,
 
 PARAMETER(int, pde_its, 15, "Number of PDE timesteps per CPM MCS")
 
+PARAMETER(std::string, pde_solver, "euler",
+          "How PDE::Diffuse solves the diffusion on the CPU\n"
+          "\n"
+          "euler: explicit forward Euler, stable only for small dt\n"
+          "adi: alternating directions implicit, as in the CUDA solver.\n"
+          "    Unconditionally stable, so a single step with a large dt\n"
+          "    can replace many euler steps. Diffuse(n) takes one step of\n"
+          "    n * dt, using 'threads' threads.\n"
+          "spectral: with periodic_boundaries, chemicals with a single\n"
+          "    diffusion coefficient take an exact step of n * dt by FFT.\n"
+          "    Other chemicals use adi.\n"
+          "With adi and spectral, PDE::SecreteAndDiffuse(n) also takes a\n"
+          "single step of n * dt, with secretion and decay split around it.\n")
+CONSTRAINT(pde_solver == "euler" || pde_solver == "adi" ||
+               pde_solver == "spectral",
+           "pde_solver must be one of euler, adi, spectral")
+
+PARAMETER(std::string, pde_boundaries, "absorbing",
+          "Boundaries of the PDE planes if periodic_boundaries is false:"
+          " absorbing (the edges are kept at 0) or noflux")
+CONSTRAINT(pde_boundaries == "absorbing" || pde_boundaries == "noflux",
+           "pde_boundaries must be one of absorbing, noflux")
+
 PARAMETER(int, n_chem, 1,
           "Number of chemicals in the reaction-diffusion (PDE) model")
 
@@ -175,11 +279,42 @@ PARAMETER(std::vector<double>, secr_rate, {1.8e-4},
 CONSTRAINT(secr_rate.size() == n_chem,
            "Number of secr_rate values does not match n_chem")
 
+PARAMETER(std::vector<double>, multigrid_layers, {},
+          "Chemicals, by number, that PDE::SecreteAndDiffuse solves with"
+          " multigrid instead of stepping, starting from their previous"
+          " values. See multigrid_mode.")
+CONSTRAINT(std::all_of(multigrid_layers.begin(), multigrid_layers.end(),
+                       [this](double l) {
+                         return l >= 0 && l < n_chem && l == int(l);
+                       }),
+           "multigrid_layers must be chemicals 0 up to n_chem - 1")
+
+PARAMETER(std::string, multigrid_mode, "steady",
+          "What the multigrid solver solves for multigrid_layers\n"
+          "\n"
+          "steady: the steady state of secretion, decay and diffusion, for\n"
+          "    chemicals that settle fast compared to cell motion. Needs\n"
+          "    decay or absorbing edges to have a solution.\n"
+          "implicit: a single backward Euler step of pde_its * dt\n")
+CONSTRAINT(multigrid_mode == "steady" || multigrid_mode == "implicit",
+           "multigrid_mode must be one of steady, implicit")
+
+PARAMETER(double, multigrid_tolerance, 1e-3,
+          "Multigrid stops once the largest residual is at most this"
+          " fraction of the largest right-hand side")
+PARAMETER(int, multigrid_cycles, 10,
+          "Maximum number of multigrid V-cycles per solve")
+
 SECTION("Chemotaxis - cell response to chemicals")
 
 PARAMETER(
     int, chemotaxis, 1000,
     "Multiplication factor from difference in effective concentration to DH")
+PARAMETER(
+    std::vector<double>, chemotaxis_strengths, {},
+    "Chemotaxis strength of each cell type for each chemical, as one row of"
+    " n_chem values per cell type, starting at type 0 (medium). If empty,"
+    " all cell types follow chemical 0 with strength chemotaxis.")
 PARAMETER(
     double, saturation, 0.0,
     "Concentration saturation value. The maximum effective concentration is"
@@ -193,6 +328,10 @@ PARAMETER(bool, extensiononly, false,
           "Make only chemotactic extensions contribute to energy change"
           " (CompuCell's method)")
 
+CONSTRAINT(chemotaxis_strengths.empty() ||
+               (n_chem > 0 && chemotaxis_strengths.size() % n_chem == 0),
+           "Number of chemotaxis_strengths values is not a multiple of n_chem")
+
 SECTION("Adhesions")
 
     PARAMETER(bool, adhesions_enabled, false, \
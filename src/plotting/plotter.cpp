@@ -28,8 +28,8 @@ void Plotter::plotPDEDensity() {
 }
 
 void Plotter::plotCPMLines() {
-  glgraphics->cpmLinePlot(dish->CPM->getSigma()[0], par.sizex, par.sizey, 0, 0,
-                          0);
+  auto sigma = dish->CPM->getSigmaArray();
+  glgraphics->cpmLinePlot(sigma.data(), par.sizex, par.sizey, 0, 0, 0);
 }
 
 void Plotter::plotPDEContourLines() {
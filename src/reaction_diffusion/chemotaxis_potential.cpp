@@ -0,0 +1,34 @@
+#include "chemotaxis_potential.hpp"
+
+void ChemotaxisPotential::Build(PDEFIELD_TYPE ***PDEvars, int layers,
+                                int sizex, int sizey,
+                                const std::vector<double> &strengths,
+                                double saturation) {
+  const int types = static_cast<int>(strengths.size()) / layers;
+  sizey_ = sizey;
+  type_stride_ = (types > 1) ? sizex : 0;
+  potential_.assign(static_cast<std::size_t>(types) * sizex * sizey, 0.0f);
+
+  std::vector<double> saturated(sizey);
+  for (int l = 0; l < layers; l++) {
+    bool used = false;
+    for (int t = 0; t < types; t++)
+      used = used || strengths[t * layers + l] != 0.0;
+    if (!used)
+      continue;
+    for (int x = 0; x < sizex; x++) {
+      for (int y = 0; y < sizey; y++) {
+        const double c = PDEvars[l][x][y];
+        saturated[y] = c / (saturation * c + 1.);
+      }
+      for (int t = 0; t < types; t++) {
+        const double strength = strengths[t * layers + l];
+        float *column = &potential_[(static_cast<std::size_t>(t) * sizex + x) *
+                                    sizey];
+        for (int y = 0; y < sizey; y++)
+          column[y] += static_cast<float>(strength * saturated[y]);
+      }
+    }
+  }
+  live_ = true;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "pdetype.h"
+#include <cstddef>
+#include <vector>
+
+/** @brief The chemotactic potential of every site, per cell type.
+ *
+ * For a cell of a given type, the potential of a site is the sum over the
+ * PDE layers of the strength of that type for the layer times the saturated
+ * concentration c / (saturation * c + 1). The chemotaxis term of a copy from
+ * (xp,yp) into (x,y) is then Value(type, xp, yp) - Value(type, x, y), two
+ * loads instead of two divisions per copy attempt.
+ *
+ * The strengths are given as rows of one value per layer, one row per cell
+ * type starting at type 0. If there is only one row, all types share it and
+ * only one potential is stored. The potential is computed by Build(), and
+ * stays valid until Stop(), which the PDE calls whenever its layers change.
+ */
+class ChemotaxisPotential {
+public:
+  /** @brief Compute the potential from the layers x sizex x sizey
+   * concentrations in PDEvars
+   */
+  void Build(PDEFIELD_TYPE ***PDEvars, int layers, int sizex, int sizey,
+             const std::vector<double> &strengths, double saturation);
+
+  //! @brief Mark the potential out of date, e.g. after the PDE has changed
+  void Stop() { live_ = false; }
+
+  //! @brief Whether the potential matches the PDE
+  bool Live() const { return live_; }
+
+  //! @brief The potential of site (x,y) for cells of the given type
+  float Value(int type, int x, int y) const {
+    return potential_[(type_stride_ * type + x) * sizey_ + y];
+  }
+
+private:
+  bool live_ = false;
+  int sizey_ = 0;
+  // sizex if there is one potential per type, 0 if they share one
+  int type_stride_ = 0;
+  std::vector<float> potential_;
+};
@@ -0,0 +1,226 @@
+#include "fft.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace {
+const double pi = 3.14159265358979323846;
+}
+
+void FFT::Resize(int n) {
+  if (n == n_)
+    return;
+  n_ = n;
+  factors_.clear();
+  twiddles_.clear();
+  chirp_.clear();
+  filter_.clear();
+  inner_.reset();
+
+  int rest = n;
+  bool too_large = false;
+  for (int p : {4, 2})
+    while (rest % p == 0 && rest > 1) {
+      rest /= p;
+      factors_.push_back(p);
+      factors_.push_back(rest);
+    }
+  for (int p = 3; rest > 1; p += 2) {
+    if (p * p > rest)
+      p = rest;
+    while (rest % p == 0) {
+      too_large = too_large || p > max_radix;
+      rest /= p;
+      factors_.push_back(p);
+      factors_.push_back(rest);
+    }
+  }
+  if (n == 1)
+    factors_ = {1, 1};
+
+  if (!too_large) {
+    twiddles_.resize(n);
+    for (int k = 0; k < n; k++)
+      twiddles_[k] = std::polar(1.0, -2 * pi * k / n);
+    return;
+  }
+
+  // X_k = c_k sum_j (x_j c_j) conj(c_(k - j)), with c_j = exp(-pi i j^2 / n),
+  // a cyclic convolution once it is padded to a length of at least 2n - 1
+  factors_.clear();
+  int length = 1;
+  while (length < 2 * n - 1)
+    length *= 2;
+  inner_ = std::make_shared<FFT>();
+  inner_->Resize(length);
+  chirp_.resize(n);
+  for (int j = 0; j < n; j++) {
+    const long long square = 1LL * j * j % (2LL * n);
+    chirp_[j] = std::polar(1.0, -pi * square / n);
+  }
+  filter_.assign(length, 0);
+  filter_[0] = std::conj(chirp_[0]);
+  for (int j = 1; j < n; j++)
+    filter_[j] = filter_[length - j] = std::conj(chirp_[j]);
+  std::vector<Complex> work(inner_->WorkSize());
+  inner_->Forward(filter_.data(), work.data());
+  for (Complex &v : filter_)
+    v /= length;
+}
+
+std::size_t FFT::WorkSize() const {
+  return inner_ ? inner_->Size() + inner_->WorkSize() : n_;
+}
+
+void FFT::Forward(Complex *x, Complex *work) const {
+  if (inner_) {
+    Bluestein(x, work);
+    return;
+  }
+  std::copy(x, x + n_, work);
+  Work(x, work, 1, factors_.data());
+}
+
+void FFT::Inverse(Complex *x, Complex *work) const {
+  for (int k = 0; k < n_; k++)
+    x[k] = std::conj(x[k]);
+  Forward(x, work);
+  for (int k = 0; k < n_; k++)
+    x[k] = std::conj(x[k]);
+}
+
+void FFT::Work(Complex *out, const Complex *in, int stride,
+               const int *factors) const {
+  // The p interleaved parts of the input, each of length m, are
+  // transformed into consecutive parts of the output, which the butterfly
+  // then combines
+  const int p = factors[0];
+  const int m = factors[1];
+  if (m == 1) {
+    for (int i = 0; i < p; i++)
+      out[i] = in[i * stride];
+  } else {
+    for (int i = 0; i < p; i++)
+      Work(out + i * m, in + i * stride, stride * p, factors + 2);
+  }
+  switch (p) {
+  case 1:
+    break;
+  case 2:
+    Butterfly2(out, stride, m);
+    break;
+  case 3:
+    Butterfly3(out, stride, m);
+    break;
+  case 4:
+    Butterfly4(out, stride, m);
+    break;
+  case 5:
+    Butterfly5(out, stride, m);
+    break;
+  default:
+    ButterflyGeneric(out, stride, m, p);
+  }
+}
+
+void FFT::Butterfly2(Complex *out, int stride, int m) const {
+  for (int k = 0; k < m; k++) {
+    const Complex t = out[k + m] * twiddles_[k * stride];
+    out[k + m] = out[k] - t;
+    out[k] += t;
+  }
+}
+
+void FFT::Butterfly3(Complex *out, int stride, int m) const {
+  const double sin3 = twiddles_[stride * m].imag();
+  for (int k = 0; k < m; k++) {
+    const Complex s1 = out[k + m] * twiddles_[k * stride];
+    const Complex s2 = out[k + 2 * m] * twiddles_[2 * k * stride];
+    const Complex sum = s1 + s2;
+    const Complex difference = (s1 - s2) * sin3;
+    const Complex mid = out[k] - sum * 0.5;
+    out[k] += sum;
+    out[k + m] = Complex(mid.real() - difference.imag(),
+                         mid.imag() + difference.real());
+    out[k + 2 * m] = Complex(mid.real() + difference.imag(),
+                             mid.imag() - difference.real());
+  }
+}
+
+void FFT::Butterfly4(Complex *out, int stride, int m) const {
+  for (int k = 0; k < m; k++) {
+    const Complex s0 = out[k + m] * twiddles_[k * stride];
+    const Complex s1 = out[k + 2 * m] * twiddles_[2 * k * stride];
+    const Complex s2 = out[k + 3 * m] * twiddles_[3 * k * stride];
+    const Complex s5 = out[k] - s1;
+    out[k] += s1;
+    const Complex s3 = s0 + s2;
+    const Complex s4 = s0 - s2;
+    out[k + 2 * m] = out[k] - s3;
+    out[k] += s3;
+    out[k + m] = Complex(s5.real() + s4.imag(), s5.imag() - s4.real());
+    out[k + 3 * m] = Complex(s5.real() - s4.imag(), s5.imag() + s4.real());
+  }
+}
+
+void FFT::Butterfly5(Complex *out, int stride, int m) const {
+  const Complex ya = twiddles_[stride * m];
+  const Complex yb = twiddles_[2 * stride * m];
+  for (int k = 0; k < m; k++) {
+    const Complex s0 = out[k];
+    const Complex s1 = out[k + m] * twiddles_[k * stride];
+    const Complex s2 = out[k + 2 * m] * twiddles_[2 * k * stride];
+    const Complex s3 = out[k + 3 * m] * twiddles_[3 * k * stride];
+    const Complex s4 = out[k + 4 * m] * twiddles_[4 * k * stride];
+    const Complex s7 = s1 + s4, s10 = s1 - s4;
+    const Complex s8 = s2 + s3, s9 = s2 - s3;
+    out[k] = s0 + s7 + s8;
+
+    const Complex s5 = s0 + s7 * ya.real() + s8 * yb.real();
+    const Complex s6(s10.imag() * ya.imag() + s9.imag() * yb.imag(),
+                     -(s10.real() * ya.imag() + s9.real() * yb.imag()));
+    out[k + m] = s5 - s6;
+    out[k + 4 * m] = s5 + s6;
+
+    const Complex s11 = s0 + s7 * yb.real() + s8 * ya.real();
+    const Complex s12(s9.imag() * ya.imag() - s10.imag() * yb.imag(),
+                      s10.real() * yb.imag() - s9.real() * ya.imag());
+    out[k + 2 * m] = s11 + s12;
+    out[k + 3 * m] = s11 - s12;
+  }
+}
+
+void FFT::ButterflyGeneric(Complex *out, int stride, int m, int p) const {
+  std::array<Complex, max_radix> scratch;
+  for (int u = 0; u < m; u++) {
+    for (int q = 0; q < p; q++)
+      scratch[q] = out[u + q * m];
+    for (int q1 = 0; q1 < p; q1++) {
+      const int k = u + q1 * m;
+      Complex sum = scratch[0];
+      int twiddle = 0;
+      for (int q = 1; q < p; q++) {
+        twiddle += stride * k;
+        if (twiddle >= n_)
+          twiddle -= n_;
+        sum += scratch[q] * twiddles_[twiddle];
+      }
+      out[k] = sum;
+    }
+  }
+}
+
+void FFT::Bluestein(Complex *x, Complex *work) const {
+  const int length = inner_->Size();
+  Complex *padded = work;
+  Complex *inner_work = work + length;
+  for (int j = 0; j < n_; j++)
+    padded[j] = x[j] * chirp_[j];
+  std::fill(padded + n_, padded + length, Complex(0));
+  inner_->Forward(padded, inner_work);
+  for (int k = 0; k < length; k++)
+    padded[k] *= filter_[k];
+  inner_->Inverse(padded, inner_work);
+  for (int k = 0; k < n_; k++)
+    x[k] = padded[k] * chirp_[k];
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <complex>
+#include <memory>
+#include <vector>
+
+/** @brief Fast Fourier transform of a fixed length n.
+ *
+ * Any n will do. The length is split into factors of 4, 2, 3 and 5, which
+ * have their own butterflies, and other prime factors up to max_radix,
+ * which share a generic one (mixed radix, as in KISS FFT). A length with a larger
+ * prime factor is transformed by Bluestein's algorithm, as a convolution of
+ * a power of two length.
+ *
+ * Transforms are in place and take a work area of WorkSize() values from
+ * the caller, so that threads can share a plan.
+ */
+class FFT {
+public:
+  using Complex = std::complex<double>;
+  static const int max_radix = 64;
+
+  void Resize(int n);
+  int Size() const { return n_; }
+  std::size_t WorkSize() const;
+
+  //! @brief X_k = sum_j x_j exp(-2 pi i j k / n)
+  void Forward(Complex *x, Complex *work) const;
+
+  //! @brief x_j = sum_k X_k exp(2 pi i j k / n), without a factor 1 / n
+  void Inverse(Complex *x, Complex *work) const;
+
+private:
+  void Work(Complex *out, const Complex *in, int stride,
+            const int *factors) const;
+  void Butterfly2(Complex *out, int stride, int m) const;
+  void Butterfly3(Complex *out, int stride, int m) const;
+  void Butterfly4(Complex *out, int stride, int m) const;
+  void Butterfly5(Complex *out, int stride, int m) const;
+  void ButterflyGeneric(Complex *out, int stride, int m, int p) const;
+  void Bluestein(Complex *x, Complex *work) const;
+
+  int n_ = 0;
+  // pairs of a radix p and the length m it splits into p parts of
+  std::vector<int> factors_;
+  // exp(-2 pi i k / n)
+  std::vector<Complex> twiddles_;
+
+  // for Bluestein: exp(-pi i k^2 / n), the transformed filter over its
+  // length, and the transform of that length
+  std::vector<Complex> chirp_, filter_;
+  std::shared_ptr<FFT> inner_;
+};
@@ -0,0 +1,331 @@
+#include "multigrid.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+namespace {
+
+// Calls f(first, last) for ranges of the columns [begin, end) of a level,
+// spread over the worker pool if there is enough work for it
+template <typename F> void ForColumns(int ny, int begin, int end, const F &f) {
+  const int n = end - begin;
+  if (n <= 0)
+    return;
+  ThreadPool &pool = WorkerPool();
+  const int tasks =
+      std::min({pool.Size(), n, static_cast<int>(1L * n * ny / 16384)});
+  if (tasks <= 1) {
+    f(begin, end);
+    return;
+  }
+  pool.ParallelFor(tasks, [&](int task) {
+    f(begin + task * n / tasks, begin + (task + 1) * n / tasks);
+  });
+}
+
+} // namespace
+
+void Multigrid::Resize(int nx, int ny, bool periodic, bool noflux) {
+  periodic_ = periodic;
+  noflux_ = noflux && !periodic;
+  if (!levels_.empty() && levels_[0].nx == nx && levels_[0].ny == ny)
+    return;
+
+  // Coarsen until a side gets too short to halve. A coarse site lies
+  // between its two fine sites, or on the fine site if there is only one.
+  levels_.clear();
+  zeros_.assign(ny, 0);
+  PDEFIELD_TYPE low = 1, high_x = 1, high_y = 1;
+  while (true) {
+    Level level;
+    level.nx = nx;
+    level.ny = ny;
+    level.low = low;
+    level.high_x = high_x;
+    level.high_y = high_y;
+    const std::size_t size = static_cast<std::size_t>(nx) * ny;
+    for (auto *v : {&level.a, &level.west, &level.east, &level.south,
+                    &level.north, &level.inverse, &level.c, &level.f})
+      v->assign(size, 0);
+    levels_.push_back(std::move(level));
+    if (nx < 4 || ny < 4)
+      break;
+    low = (low + 0.5) / 2;
+    high_x = nx % 2 ? high_x / 2 : (high_x + 0.5) / 2;
+    high_y = ny % 2 ? high_y / 2 : (high_y + 0.5) / 2;
+    nx = (nx + 1) / 2;
+    ny = (ny + 1) / 2;
+  }
+}
+
+void Multigrid::SetOperator(PDEFIELD_TYPE *const *D, PDEFIELD_TYPE dx2) {
+  Level &fine = levels_[0];
+  const int nx = fine.nx, ny = fine.ny;
+  ForColumns(ny, 0, nx, [&](int first, int last) {
+    for (int i = first; i < last; i++) {
+      const int x = i + 1;
+      for (int j = 0; j < ny; j++) {
+        const int y = j + 1;
+        const std::size_t k = static_cast<std::size_t>(i) * ny + j;
+        fine.west[k] = (i > 0 || !noflux_) ? D[x - 1][y] / dx2 : 0;
+        fine.east[k] = (i < nx - 1 || !noflux_) ? D[x + 1][y] / dx2 : 0;
+        fine.south[k] = (j > 0 || !noflux_) ? D[x][y - 1] / dx2 : 0;
+        fine.north[k] = (j < ny - 1 || !noflux_) ? D[x][y + 1] / dx2 : 0;
+      }
+    }
+  });
+
+  // A coarse site is the average of its (up to) four fine sites, with the
+  // weights of the fine sites on its sides, over the doubled spacing squared.
+  // A missing fine site counts its neighbour twice. The weight of an
+  // absorbing edge goes with the distance to it instead: a fine weight of
+  // D / (h d) becomes D / (2 h d'), with d' the distance of the coarse site.
+  for (std::size_t l = 1; l < levels_.size(); l++) {
+    const Level &f = levels_[l - 1];
+    Level &c = levels_[l];
+    const bool absorbing = !periodic_ && !noflux_;
+    const PDEFIELD_TYPE low = absorbing ? f.low / (2 * c.low) / 2 : 0.25;
+    const PDEFIELD_TYPE high_x =
+        absorbing ? f.high_x / (2 * c.high_x) / 2 : 0.25;
+    const PDEFIELD_TYPE high_y =
+        absorbing ? f.high_y / (2 * c.high_y) / 2 : 0.25;
+    ForColumns(c.ny, 0, c.nx, [&](int first, int last) {
+      for (int I = first; I < last; I++) {
+        const std::size_t i0 = 2 * I;
+        const std::size_t i1 = std::min(2 * I + 1, f.nx - 1);
+        for (int J = 0; J < c.ny; J++) {
+          const std::size_t j0 = 2 * J;
+          const std::size_t j1 = std::min(2 * J + 1, f.ny - 1);
+          const std::size_t k00 = i0 * f.ny + j0, k01 = i0 * f.ny + j1;
+          const std::size_t k10 = i1 * f.ny + j0, k11 = i1 * f.ny + j1;
+          const std::size_t k = static_cast<std::size_t>(I) * c.ny + J;
+          c.a[k] = (f.a[k00] + f.a[k01] + f.a[k10] + f.a[k11]) / 4;
+          c.west[k] = (f.west[k00] + f.west[k01]) / 2 * (I ? 0.25 : low);
+          c.east[k] = (f.east[k10] + f.east[k11]) / 2 *
+                      (I < c.nx - 1 ? 0.25 : high_x);
+          c.south[k] = (f.south[k00] + f.south[k10]) / 2 * (J ? 0.25 : low);
+          c.north[k] = (f.north[k01] + f.north[k11]) / 2 *
+                       (J < c.ny - 1 ? 0.25 : high_y);
+        }
+      }
+    });
+  }
+
+  for (Level &level : levels_)
+    ForColumns(level.ny, 0, level.nx, [&](int first, int last) {
+      const std::size_t end = static_cast<std::size_t>(last) * level.ny;
+      for (std::size_t k = std::size_t(first) * level.ny; k < end; k++)
+        level.inverse[k] = 1 / (level.a[k] + level.west[k] + level.east[k] +
+                                level.south[k] + level.north[k]);
+    });
+}
+
+int Multigrid::Solve(PDEFIELD_TYPE tolerance, int max_cycles) {
+  Level &fine = levels_[0];
+  PDEFIELD_TYPE scale = 0;
+  for (PDEFIELD_TYPE v : fine.f)
+    scale = std::max(scale, std::abs(v));
+  const PDEFIELD_TYPE target = tolerance * scale;
+
+  residual_ = LargestResidual(fine);
+  int cycles = 0;
+  while (cycles < max_cycles && residual_ > target) {
+    Cycle(0);
+    residual_ = LargestResidual(fine);
+    cycles++;
+  }
+  return cycles;
+}
+
+const PDEFIELD_TYPE *Multigrid::Column(const Level &level, int i) const {
+  if (i < 0)
+    i = periodic_ ? level.nx - 1 : -1;
+  else if (i >= level.nx)
+    i = periodic_ ? 0 : -1;
+  return i < 0 ? zeros_.data()
+               : level.c.data() + static_cast<std::size_t>(i) * level.ny;
+}
+
+void Multigrid::Relax(Level &level, int i, int colour) const {
+  const int ny = level.ny;
+  const PDEFIELD_TYPE *left = Column(level, i - 1);
+  const PDEFIELD_TYPE *right = Column(level, i + 1);
+  const std::size_t k0 = static_cast<std::size_t>(i) * ny;
+  PDEFIELD_TYPE *mid = level.c.data() + k0;
+  const PDEFIELD_TYPE *f = &level.f[k0], *inverse = &level.inverse[k0];
+  const PDEFIELD_TYPE *west = &level.west[k0], *east = &level.east[k0];
+  const PDEFIELD_TYPE *south = &level.south[k0], *north = &level.north[k0];
+  auto update = [&](int j, PDEFIELD_TYPE down, PDEFIELD_TYPE up) {
+    mid[j] = (f[j] + west[j] * left[j] + east[j] * right[j] +
+              south[j] * down + north[j] * up) *
+             inverse[j];
+  };
+  // the values beyond the ends of the column
+  const PDEFIELD_TYPE zero = 0;
+  const PDEFIELD_TYPE &below = periodic_ ? mid[ny - 1] : zero;
+  const PDEFIELD_TYPE &above = periodic_ ? mid[0] : zero;
+  int j = (i + colour) % 2;
+  if (j == 0) {
+    update(0, below, ny > 1 ? mid[1] : above);
+    j = 2;
+  }
+  for (; j < ny - 1; j += 2)
+    update(j, mid[j - 1], mid[j + 1]);
+  if (j == ny - 1)
+    update(j, mid[j - 1], above);
+}
+
+void Multigrid::Smooth(Level &level, int sweeps) {
+  // A sweep relaxes the red sites ((i + j) % 2 == 0) of column i and then
+  // the black sites of column i - 1, which have all their red neighbours by
+  // then, so that it goes through memory once. The black sites of the first
+  // and last column of a range wait until all ranges have done their red
+  // sites. With periodic edges and an odd nx, the first and last columns
+  // have neighbours of the same colour, and the last one goes on its own.
+  const int nx = level.nx;
+  const int n = periodic_ && nx % 2 ? nx - 1 : nx;
+  for (int s = 0; s < sweeps; s++) {
+    ForColumns(level.ny, 0, n, [&](int first, int last) {
+      for (int i = first; i < last; i++) {
+        Relax(level, i, 0);
+        if (i - 1 > first)
+          Relax(level, i - 1, 1);
+      }
+    });
+    if (n < nx)
+      Relax(level, nx - 1, 0);
+    ForColumns(level.ny, 0, n, [&](int first, int last) {
+      Relax(level, first, 1);
+      if (last - 1 > first)
+        Relax(level, last - 1, 1);
+    });
+    if (n < nx)
+      Relax(level, nx - 1, 1);
+  }
+}
+
+void Multigrid::ResidualColumn(const Level &level, int i,
+                               PDEFIELD_TYPE *r) const {
+  const int ny = level.ny;
+  const PDEFIELD_TYPE *left = Column(level, i - 1);
+  const PDEFIELD_TYPE *right = Column(level, i + 1);
+  const PDEFIELD_TYPE *mid = Column(level, i);
+  const std::size_t k0 = static_cast<std::size_t>(i) * ny;
+  const PDEFIELD_TYPE *f = &level.f[k0], *a = &level.a[k0];
+  const PDEFIELD_TYPE *west = &level.west[k0], *east = &level.east[k0];
+  const PDEFIELD_TYPE *south = &level.south[k0], *north = &level.north[k0];
+  // as differences, which are exact where the solution is smooth
+  auto residual = [&](int j, PDEFIELD_TYPE down, PDEFIELD_TYPE up) {
+    const PDEFIELD_TYPE c = mid[j];
+    return f[j] - a[j] * c + west[j] * (left[j] - c) +
+           east[j] * (right[j] - c) + south[j] * (down - c) +
+           north[j] * (up - c);
+  };
+  for (int j = 1; j < ny - 1; j++)
+    r[j] = residual(j, mid[j - 1], mid[j + 1]);
+  r[0] = residual(0, periodic_ ? mid[ny - 1] : 0, ny > 1 ? mid[1] : 0);
+  if (ny > 1)
+    r[ny - 1] = residual(ny - 1, mid[ny - 2], periodic_ ? mid[0] : 0);
+}
+
+PDEFIELD_TYPE Multigrid::LargestResidual(const Level &level) const {
+  std::mutex mutex;
+  PDEFIELD_TYPE largest = 0;
+  ForColumns(level.ny, 0, level.nx, [&](int first, int last) {
+    std::vector<PDEFIELD_TYPE> r(level.ny);
+    PDEFIELD_TYPE local = 0;
+    for (int i = first; i < last; i++) {
+      ResidualColumn(level, i, r.data());
+      for (PDEFIELD_TYPE v : r)
+        local = std::max(local, std::abs(v));
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    largest = std::max(largest, local);
+  });
+  return largest;
+}
+
+void Multigrid::Restrict(const Level &fine, Level &coarse) const {
+  // The right-hand side of a coarse site is the average residual of its
+  // fine sites
+  ForColumns(coarse.ny, 0, coarse.nx, [&](int first, int last) {
+    std::vector<PDEFIELD_TYPE> r0(fine.ny), r1(fine.ny);
+    for (int I = first; I < last; I++) {
+      ResidualColumn(fine, 2 * I, r0.data());
+      if (2 * I + 1 < fine.nx)
+        ResidualColumn(fine, 2 * I + 1, r1.data());
+      else
+        r1 = r0;
+      for (int J = 0; J < coarse.ny; J++) {
+        const int j0 = 2 * J;
+        const int j1 = std::min(2 * J + 1, fine.ny - 1);
+        const std::size_t k = static_cast<std::size_t>(I) * coarse.ny + J;
+        coarse.f[k] = (r0[j0] + r0[j1] + r1[j0] + r1[j1]) / 4;
+        coarse.c[k] = 0;
+      }
+    }
+  });
+}
+
+void Multigrid::Prolong(const Level &coarse, Level &fine) {
+  // Bilinear interpolation between the centres of the coarse sites, along
+  // each axis from the nearest one and the one on the other side. Towards
+  // an absorbing edge the correction goes linearly to 0 at the edge,
+  // towards a no-flux edge it stays constant. A fine site without a sibling
+  // lies on its coarse site.
+  struct Stencil {
+    std::size_t near, far;
+    PDEFIELD_TYPE w_near, w_far;
+  };
+  auto stencil = [&](int index, int n_fine, int n, PDEFIELD_TYPE low_fine,
+                     PDEFIELD_TYPE low, PDEFIELD_TYPE high_fine,
+                     PDEFIELD_TYPE high) {
+    const int near = index / 2;
+    const int far = index % 2 ? near + 1 : near - 1;
+    if (n_fine % 2 && index == n_fine - 1)
+      return Stencil{std::size_t(near), std::size_t(near), 1, 0};
+    if (far >= 0 && far < n)
+      return Stencil{std::size_t(near), std::size_t(far), 0.75, 0.25};
+    if (periodic_)
+      return Stencil{std::size_t(near), std::size_t(far < 0 ? n - 1 : 0),
+                     0.75, 0.25};
+    if (noflux_)
+      return Stencil{std::size_t(near), std::size_t(near), 1, 0};
+    const PDEFIELD_TYPE ratio = far < 0 ? low_fine / low : high_fine / high;
+    return Stencil{std::size_t(near), std::size_t(near), ratio / 2, 0};
+  };
+
+  std::vector<Stencil> along_y;
+  for (int j = 0; j < fine.ny; j++)
+    along_y.push_back(stencil(j, fine.ny, coarse.ny, fine.low, coarse.low,
+                              fine.high_y, coarse.high_y));
+  ForColumns(fine.ny, 0, fine.nx, [&](int first, int last) {
+    for (int i = first; i < last; i++) {
+      const Stencil sx = stencil(i, fine.nx, coarse.nx, fine.low, coarse.low,
+                                 fine.high_x, coarse.high_x);
+      const PDEFIELD_TYPE *near = &coarse.c[sx.near * coarse.ny];
+      const PDEFIELD_TYPE *far = &coarse.c[sx.far * coarse.ny];
+      PDEFIELD_TYPE *c = &fine.c[static_cast<std::size_t>(i) * fine.ny];
+      for (int j = 0; j < fine.ny; j++) {
+        const Stencil &sy = along_y[j];
+        c[j] += sx.w_near * (sy.w_near * near[sy.near] +
+                             sy.w_far * near[sy.far]) +
+                sx.w_far * (sy.w_near * far[sy.near] + sy.w_far * far[sy.far]);
+      }
+    }
+  });
+}
+
+void Multigrid::Cycle(int k) {
+  Level &level = levels_[k];
+  if (k + 1 == static_cast<int>(levels_.size())) {
+    Smooth(level, 2 * (level.nx + level.ny));
+    return;
+  }
+  Smooth(level, 2);
+  Restrict(level, levels_[k + 1]);
+  Cycle(k + 1);
+  Prolong(levels_[k + 1], level);
+  Smooth(level, 2);
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include "pdetype.h"
+#include <vector>
+
+/** @brief Geometric multigrid solver for reaction and diffusion on the
+ * interior of a PDE plane.
+ *
+ * Solves a c - sum_n w_n (c_n - c) = f on an nx by ny grid, where the sum
+ * runs over the four neighbours n of a site, and w_n is the diffusion
+ * coefficient of the neighbour over dx^2, as in PDE::Diffuse(). Beyond an
+ * absorbing edge the neighbours are 0, nothing flows through a no-flux
+ * edge, and periodic edges wrap around.
+ *
+ * Call Resize(), fill in Reaction(), Rhs() and the initial guess in
+ * Solution(), all indexed as i * ny + j, then call SetOperator() and
+ * Solve(). The coarse grids merge 2 x 2 sites and average the operator.
+ * Smoothing is red-black Gauss-Seidel on 'threads' threads.
+ */
+class Multigrid {
+public:
+  void Resize(int nx, int ny, bool periodic, bool noflux);
+
+  std::vector<PDEFIELD_TYPE> &Reaction() { return levels_[0].a; }
+  std::vector<PDEFIELD_TYPE> &Rhs() { return levels_[0].f; }
+  std::vector<PDEFIELD_TYPE> &Solution() { return levels_[0].c; }
+
+  /** @brief Set the diffusion part of the operator and the coarse grids
+   * @param D Diffusion coefficients of the plane, including its edges, so
+   * that D[i + 1][j + 1] belongs to site (i, j)
+   * @param dx2 Square of the grid spacing
+   */
+  void SetOperator(PDEFIELD_TYPE *const *D, PDEFIELD_TYPE dx2);
+
+  /** @brief Take V-cycles until the largest residual is at most tolerance
+   * times the largest right-hand side
+   * @return The number of cycles taken, 0 if the initial guess will do
+   */
+  int Solve(PDEFIELD_TYPE tolerance, int max_cycles);
+
+  //! @brief The largest residual left by the last Solve()
+  PDEFIELD_TYPE Residual() const { return residual_; }
+
+private:
+  struct Level {
+    int nx = 0, ny = 0;
+    // the reaction term, and the weights of the neighbours at x - 1, x + 1,
+    // y - 1 and y + 1
+    std::vector<PDEFIELD_TYPE> a, west, east, south, north;
+    // 1 / (a + sum of the weights)
+    std::vector<PDEFIELD_TYPE> inverse;
+    std::vector<PDEFIELD_TYPE> c, f;
+    // distance from the centres of the first sites to the low edges, and
+    // from the last sites along x and y to the high edges, in spacings
+    PDEFIELD_TYPE low = 1, high_x = 1, high_y = 1;
+  };
+
+  // column i of the solution, or zeros beyond an edge that does not wrap
+  const PDEFIELD_TYPE *Column(const Level &level, int i) const;
+  // Gauss-Seidel update of the sites of column i with (i + j) % 2 == colour
+  void Relax(Level &level, int i, int colour) const;
+  void Smooth(Level &level, int sweeps);
+  void ResidualColumn(const Level &level, int i, PDEFIELD_TYPE *r) const;
+  PDEFIELD_TYPE LargestResidual(const Level &level) const;
+  void Restrict(const Level &fine, Level &coarse) const;
+  void Prolong(const Level &coarse, Level &fine);
+  void Cycle(int k);
+
+  bool periodic_ = false;
+  bool noflux_ = false;
+  PDEFIELD_TYPE residual_ = 0;
+  std::vector<Level> levels_;
+  std::vector<PDEFIELD_TYPE> zeros_;
+};
@@ -20,11 +20,14 @@ Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
 02110-1301 USA
 
 */
+#include <algorithm>
 #include <cstdlib>
 #include <fstream>
 #include <math.h>
 #include <sstream>
+#include <stdexcept>
 #include <stdio.h>
+#include <string>
 
 #include "ca.hpp"
 #include "conrec.hpp"
@@ -32,6 +35,7 @@ Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
 #include "graph.hpp"
 #include "parameter.hpp"
 #include "pde.hpp"
+#include "thread_pool.hpp"
 
 /* STATIC DATA MEMBER INITIALISATION */
 const int PDE::nx[9] = {0, 1, 1, 1, 0, -1, -1, -1, 0};
@@ -203,7 +207,7 @@ void PDE::PlotInCells(Graphics *g, CellularPotts *cpm, const int l) {
     for (int y = 0; y < sizey; y++) {
       if (cpm->Sigma(x, y) > 0) {
         if (par.lambda_Act > 0) {
-          g->Rectangle(MapColour3(cpm->actPixels[{x, y}], l), x, y);
+          g->Rectangle(MapColour3(cpm->act_pixels.Level(x, y), l), x, y);
         } else {
           g->Rectangle(255, x, y);
         }
@@ -225,7 +229,8 @@ void PDE::PlotInCells(Graphics *g, CellularPotts *cpm, const int l) {
 void PDE::SetupOpenCL() {
   extern CLManager clm;
 
-  program = clm.make_program(par.opencl_core_path, OPENCL_PDE_TYPE);
+  program = clm.make_program(par.opencl_core_path,
+                             std::string(OPENCL_PDE_TYPE) + OPENCL_SPIN_TYPE);
 
   // Secretion and diffusion variables
   PDEFIELD_TYPE dt = (PDEFIELD_TYPE)par.dt;
@@ -240,7 +245,7 @@ void PDE::SetupOpenCL() {
 
   // Allocate memory on the GPU
   clm.cpm =
-      cl::Buffer(clm.context, CL_MEM_READ_WRITE, sizeof(int) * sizex * sizey);
+      cl::Buffer(clm.context, CL_MEM_READ_WRITE, sizeof(Spin) * sizex * sizey);
   clm.pdeA = cl::Buffer(clm.context, CL_MEM_READ_WRITE,
                         sizeof(PDEFIELD_TYPE) * sizex * sizey * layers);
   clm.pdeB = cl::Buffer(clm.context, CL_MEM_READ_WRITE,
@@ -276,6 +281,16 @@ void PDE::SetupOpenCL() {
   openclsetup = true;
 }
 
+const Spin *PDE::SecretionMask(CellularPotts *cpm) {
+  // The lattice has a halo and may be stored in tiles, so copy it site by site
+  const SpinLattice &sigma = cpm->getSigma();
+  secretion_mask.resize(static_cast<std::size_t>(sizex) * sizey);
+  for (int x = 0; x < sizex; x++)
+    for (int y = 0; y < sizey; y++)
+      secretion_mask[x * sizey + y] = sigma(x, y);
+  return secretion_mask.data();
+}
+
 void PDE::SecreteAndDiffuseCL(CellularPotts *cpm, int repeat) {
   extern CLManager clm;
   if (!openclsetup) {
@@ -286,8 +301,9 @@ void PDE::SecreteAndDiffuseCL(CellularPotts *cpm, int repeat) {
   int errorcode = 0;
 
   // Write the cellSigma array to GPU for secretion
-  clm.queue.enqueueWriteBuffer(clm.cpm, CL_TRUE, 0, sizeof(int) * sizex * sizey,
-                               cpm->getSigma()[0]);
+  clm.queue.enqueueWriteBuffer(clm.cpm, CL_TRUE, 0,
+                               sizeof(Spin) * sizex * sizey,
+                               SecretionMask(cpm));
 
   // Writing pdefield sigma is only necessary if modified outside of kernel
   if (first_round) {
@@ -332,6 +348,237 @@ void PDE::SecreteAndDiffuseCL(CellularPotts *cpm, int repeat) {
   if (errorcode != CL_SUCCESS)
     cout << "error:" << errorcode << endl;
   thetime += par.dt;
+  chemotaxis_potential.Stop();
+}
+
+void PDE::SetSecretion(int l, PDEFIELD_TYPE secretion, PDEFIELD_TYPE decay) {
+  rates.resize(layers);
+  rates[l] = Rates{secretion, decay, true};
+}
+
+void PDE::SecreteAndDiffuse(CellularPotts *cpm, int repeat) {
+  // The rates of the models are in Secrete() and DerivativesPDE(), which
+  // cannot be fused into the steps below, so they declare them separately
+  rates.resize(layers);
+  for (int l = 0; l < layers; l++)
+    if (!rates[l].declared)
+      throw std::runtime_error("PDE::SecreteAndDiffuse(): no secretion and "
+                               "decay declared for plane " +
+                               std::to_string(l) + ", see SetSecretion()");
+
+  const PDEFIELD_TYPE dt = par.dt;
+  const PDEFIELD_TYPE dx2 = par.dx * par.dx;
+  const bool periodic = par.periodic_boundaries;
+  const bool noflux = !periodic && par.pde_boundaries == "noflux";
+  const SpinLattice &sigma = cpm->getSigma();
+
+  // With a single diffusion coefficient, the stencil needs no coefficients
+  std::vector<bool> uniform(layers);
+  for (int l = 0; l < layers; l++)
+    uniform[l] = UniformDiffusion(l);
+
+  // The planes solved by multigrid or in a single split step are only
+  // carried along by the steps
+  std::vector<bool> solved(layers, false), split(layers, false);
+  for (double l : par.multigrid_layers)
+    if (l < layers)
+      solved[static_cast<int>(l)] = true;
+  for (int l = 0; l < layers; l++)
+    split[l] = !solved[l] && par.pde_solver != "euler";
+
+  // The steps are taken in blocks. Each task sweeps a strip of columns once
+  // per block, taking step t of column x as soon as step t - 1 of column
+  // x + 1 is known. Only three columns per step are live, so the planes go
+  // through memory once per block rather than once per step. A strip also
+  // computes the block columns on either side of it, so that its result is
+  // the same as that of single steps.
+  const int max_block = 32;
+  const int nx = sizex - 2;
+  ThreadPool &pool = WorkerPool();
+  const int tasks = std::min(pool.Size(), nx);
+  const std::vector<PDEFIELD_TYPE> zeros(sizey, 0);
+
+  for (int done = 0; done < repeat;) {
+    const int block = std::min(max_block, repeat - done);
+    for (int l = 0; l < layers; l++) {
+      if (solved[l] || split[l]) {
+        std::copy(PDEvars[l][0], PDEvars[l][0] + sizex * sizey,
+                  alt_PDEvars[l][0]);
+        continue;
+      }
+      const PDEFIELD_TYPE secreted = rates[l].secretion * dt;
+      const PDEFIELD_TYPE decay = rates[l].decay * dt;
+      PDEFIELD_TYPE **D = DiffCoeffs[l];
+      const PDEFIELD_TYPE c = D[0][0] * dt / dx2;
+      PDEFIELD_TYPE **in = PDEvars[l];
+      PDEFIELD_TYPE **out = alt_PDEvars[l];
+
+      // Column x of the plane, v, after secretion and decay, with the edges
+      // set as ApplyBoundaries() would set them
+      auto secrete = [&](int x, const PDEFIELD_TYPE *v, PDEFIELD_TYPE *s) {
+        for (int y = 1; y < sizey - 1; y++)
+          s[y] = v[y] + (sigma(x, y) > 0 ? secreted : -decay * v[y]);
+        if (periodic) {
+          s[0] = s[sizey - 2];
+          s[sizey - 1] = s[1];
+        } else if (noflux) {
+          s[0] = s[1];
+          s[sizey - 1] = s[sizey - 2];
+        } else {
+          s[0] = s[sizey - 1] = 0;
+        }
+      };
+
+      // Column x diffused, from the secreted columns x - 1, x and x + 1
+      auto diffuse = [&](int x, const PDEFIELD_TYPE *left,
+                         const PDEFIELD_TYPE *mid, const PDEFIELD_TYPE *right,
+                         PDEFIELD_TYPE *o) {
+        if (uniform[l]) {
+          for (int y = 1; y < sizey - 1; y++)
+            o[y] = mid[y] + c * (left[y] + right[y] + mid[y - 1] +
+                                 mid[y + 1] - 4 * mid[y]);
+        } else {
+          const PDEFIELD_TYPE *dl = D[x - 1], *dm = D[x], *dr = D[x + 1];
+          for (int y = 1; y < sizey - 1; y++) {
+            const PDEFIELD_TYPE sum =
+                left[y] * dl[y] + right[y] * dr[y] + mid[y - 1] * dm[y - 1] +
+                mid[y + 1] * dm[y + 1] -
+                mid[y] * (dl[y] + dr[y] + dm[y - 1] + dm[y + 1]);
+            o[y] = mid[y] + sum * dt / dx2;
+          }
+        }
+      };
+
+      pool.ParallelFor(tasks, [&](int task) {
+        const int x0 = 1 + task * nx / tasks;
+        const int x1 = 1 + (task + 1) * nx / tasks;
+        // The columns read by the strip. With periodic boundaries they run
+        // past the edges and wrap around, otherwise the edge columns are
+        // set from the columns next to them at every step.
+        const int lo = periodic ? x0 - block : std::max(1, x0 - block);
+        const int hi = periodic ? x1 + block : std::min(sizex - 1, x1 + block);
+        const bool low_edge = !periodic && lo == 1;
+        const bool high_edge = !periodic && hi == sizex - 1;
+        auto column_x = [&](int col) {
+          return periodic ? 1 + ((col - 1) % nx + nx) % nx : col;
+        };
+
+        // three secreted columns for each step, and one diffused column
+        std::vector<PDEFIELD_TYPE> buffer((3 * block + 1) * sizey);
+        auto secreted = [&](int t, int col) {
+          return &buffer[(3 * t + (col - lo) % 3) * sizey];
+        };
+        auto neighbour = [&](int t, int col) -> const PDEFIELD_TYPE * {
+          if (low_edge && col == 0)
+            return noflux ? secreted(t, 1) : zeros.data();
+          if (high_edge && col == sizex - 1)
+            return noflux ? secreted(t, sizex - 2) : zeros.data();
+          return secreted(t, col);
+        };
+        PDEFIELD_TYPE *diffused = &buffer[3 * block * sizey];
+
+        for (int front = lo; front < hi + block; front++)
+          for (int t = 0; t <= block; t++) {
+            const int col = front - t;
+            if (col < (low_edge ? lo : lo + t) ||
+                col >= (high_edge ? hi : hi - t))
+              continue;
+            const int x = column_x(col);
+            if (t == 0) {
+              secrete(x, in[x], secreted(0, col));
+            } else if (t < block) {
+              diffuse(x, neighbour(t - 1, col - 1), secreted(t - 1, col),
+                      neighbour(t - 1, col + 1), diffused);
+              secrete(x, diffused, secreted(t, col));
+            } else if (col >= x0 && col < x1) {
+              diffuse(x, neighbour(t - 1, col - 1), secreted(t - 1, col),
+                      neighbour(t - 1, col + 1), out[x]);
+            }
+          }
+      });
+    }
+    std::swap(PDEvars, alt_PDEvars);
+    done += block;
+  }
+  for (int l = 0; l < layers; l++) {
+    if (solved[l] && repeat > 0)
+      SolveMultigrid(cpm, l, repeat * dt);
+    if (split[l] && repeat > 0)
+      SecreteAndDiffuseSplit(cpm, l, repeat * dt);
+  }
+  ApplyBoundaries();
+  thetime += repeat * dt;
+  chemotaxis_potential.Stop();
+}
+
+void PDE::SolveMultigrid(CellularPotts *cpm, int l, PDEFIELD_TYPE step) {
+  const int nx = sizex - 2;
+  const int ny = sizey - 2;
+  const SpinLattice &sigma = cpm->getSigma();
+  const PDEFIELD_TYPE secreted = rates[l].secretion;
+  const PDEFIELD_TYPE decay = rates[l].decay;
+  // A backward Euler step adds c / step to both sides of the steady state
+  const PDEFIELD_TYPE inverse_step =
+      par.multigrid_mode == "implicit" ? 1 / step : 0;
+
+  if (multigrid.size() != static_cast<std::size_t>(layers))
+    multigrid.resize(layers);
+  Multigrid &solver = multigrid[l];
+  solver.Resize(nx, ny, par.periodic_boundaries,
+                par.pde_boundaries == "noflux");
+  std::vector<PDEFIELD_TYPE> &a = solver.Reaction();
+  std::vector<PDEFIELD_TYPE> &f = solver.Rhs();
+  std::vector<PDEFIELD_TYPE> &c = solver.Solution();
+  for (int x = 1; x < sizex - 1; x++)
+    for (int y = 1; y < sizey - 1; y++) {
+      const std::size_t k = static_cast<std::size_t>(x - 1) * ny + y - 1;
+      const bool inside = sigma(x, y) > 0;
+      const PDEFIELD_TYPE value = PDEvars[l][x][y];
+      a[k] = (inside ? 0 : decay) + inverse_step;
+      f[k] = (inside ? secreted : 0) + inverse_step * value;
+      c[k] = value;
+    }
+
+  solver.SetOperator(DiffCoeffs[l], par.dx * par.dx);
+  solver.Solve(par.multigrid_tolerance, par.multigrid_cycles);
+
+  for (int x = 1; x < sizex - 1; x++)
+    std::copy(&c[static_cast<std::size_t>(x - 1) * ny],
+              &c[static_cast<std::size_t>(x) * ny], &PDEvars[l][x][1]);
+}
+
+void PDE::SecreteAndDiffuseSplit(CellularPotts *cpm, int l,
+                                 PDEFIELD_TYPE step) {
+  const SpinLattice &sigma = cpm->getSigma();
+  const PDEFIELD_TYPE secreted = rates[l].secretion * step / 2;
+  const PDEFIELD_TYPE decay =
+      static_cast<PDEFIELD_TYPE>(exp(-rates[l].decay * step / 2));
+  PDEFIELD_TYPE **u = PDEvars[l];
+
+  // Secretion and decay have exact solutions for a given site, so they take
+  // half a step on either side of the diffusion (Strang splitting)
+  ThreadPool &pool = WorkerPool();
+  const int nx = sizex - 2;
+  const int tasks = std::min(pool.Size(), nx);
+  auto react = [&]() {
+    pool.ParallelFor(tasks, [&](int task) {
+      for (int x = 1 + task * nx / tasks; x < 1 + (task + 1) * nx / tasks;
+           x++)
+        for (int y = 1; y < sizey - 1; y++)
+          u[x][y] = sigma(x, y) > 0 ? u[x][y] + secreted : u[x][y] * decay;
+    });
+  };
+  react();
+  if (SpectralPlane(l)) {
+    DiffuseSpectral(l, u, step);
+  } else {
+    // DiffuseADI() writes the interior of alt_PDEvars
+    DiffuseADI(l, step);
+    for (int x = 1; x < sizex - 1; x++)
+      std::copy(&alt_PDEvars[l][x][1], &alt_PDEvars[l][x][sizey - 1],
+                &u[x][1]);
+  }
+  react();
 }
 
 void PDE::ForwardEulerStep(int repeat, CellularPotts *cpm) {
@@ -343,6 +590,7 @@ void PDE::ForwardEulerStep(int repeat, CellularPotts *cpm) {
         PDEvars[l][x][y] = alt_PDEvars[l][x][y] + derivs[l] * par.dt;
     }
   }
+  chemotaxis_potential.Stop();
 }
 
 // public
@@ -355,14 +603,20 @@ void PDE::Diffuse(int repeat) {
   const PDEFIELD_TYPE dt = par.dt;
   const PDEFIELD_TYPE dx2 = par.dx * par.dx;
 
-  for (int r = 0; r < repeat; r++) {
-    // NoFluxBoundaries();
-    if (par.periodic_boundaries) {
-      PeriodicBoundaries();
-    } else {
-      AbsorbingBoundaries();
-      // NoFluxBoundaries();
+  if (par.pde_solver != "euler") {
+    ApplyBoundaries();
+    for (int l = 0; l < layers; l++) {
+      if (SpectralPlane(l))
+        DiffuseSpectral(l, alt_PDEvars[l], repeat * dt);
+      else
+        DiffuseADI(l, repeat * dt);
     }
+    chemotaxis_potential.Stop();
+    return;
+  }
+
+  for (int r = 0; r < repeat; r++) {
+    ApplyBoundaries();
     for (int l = 0; l < layers; l++) {
       for (int x = 1; x < sizex - 1; x++)
         for (int y = 1; y < sizey - 1; y++) {
@@ -378,6 +632,126 @@ void PDE::Diffuse(int repeat) {
         }
     }
   }
+  chemotaxis_potential.Stop();
+}
+
+void PDE::DiffuseADI(int l, PDEFIELD_TYPE step) {
+  // The interior of the plane is solved, the edges are the boundaries
+  const int nx = sizex - 2;
+  const int ny = sizey - 2;
+  const bool periodic = par.periodic_boundaries;
+  const bool noflux = !periodic && par.pde_boundaries == "noflux";
+  const PDEFIELD_TYPE dx2 = par.dx * par.dx;
+  const PDEFIELD_TYPE twooverdt = 2 / step;
+
+  if (adiH.Size() != nx || adiH.Batch() != ny || adiH.Cyclic() != periodic) {
+    adiH.Resize(nx, ny, ny, 1, periodic);
+    adiV.Resize(ny, nx, nx, 1, periodic);
+    adiBH.resize(static_cast<std::size_t>(nx) * ny);
+    adiBV.resize(static_cast<std::size_t>(nx) * ny);
+  }
+
+  // Row i of a system of n, with the diffusion coefficients of the sites
+  // before and after it. Nothing flows through a no-flux edge, an absorbing
+  // edge is kept at 0 and a periodic edge is a copy of the opposite side.
+  struct Row {
+    PDEFIELD_TYPE lower, diag, upper;
+  };
+  auto row = [&](int i, int n, PDEFIELD_TYPE before, PDEFIELD_TYPE after) {
+    if (noflux && i == 0)
+      before = 0;
+    if (noflux && i == n - 1)
+      after = 0;
+    return Row{(i > 0 || periodic) ? -before / dx2 : 0,
+               (before + after) / dx2 + twooverdt,
+               (i < n - 1 || periodic) ? -after / dx2 : 0};
+  };
+
+  // Each thread takes a range of systems. Interleaved systems are solved
+  // a whole row at a time, so the ranges are as wide as possible.
+  ThreadPool &pool = WorkerPool();
+  const int tasks = pool.Size();
+  auto first = [tasks](int t, int n) { return t * n / tasks; };
+
+  PDEFIELD_TYPE **D = DiffCoeffs[l];
+  PDEFIELD_TYPE **u = PDEvars[l];
+
+  // The matrices of both half steps, as in InitialiseDiagonals
+  pool.ParallelFor(2 * tasks, [&](int t) {
+    if (t < tasks) {
+      for (int i = 0; i < nx; i++)
+        for (int j = first(t, ny); j < first(t + 1, ny); j++) {
+          const Row r = row(i, nx, D[i][j + 1], D[i + 2][j + 1]);
+          adiH.Lower(i, j) = r.lower;
+          adiH.Diag(i, j) = r.diag;
+          adiH.Upper(i, j) = r.upper;
+        }
+      adiH.Factorise(first(t, ny), first(t + 1, ny));
+    } else {
+      t -= tasks;
+      for (int j = 0; j < ny; j++)
+        for (int i = first(t, nx); i < first(t + 1, nx); i++) {
+          const Row r = row(j, ny, D[i + 1][j], D[i + 1][j + 2]);
+          adiV.Lower(j, i) = r.lower;
+          adiV.Diag(j, i) = r.diag;
+          adiV.Upper(j, i) = r.upper;
+        }
+      adiV.Factorise(first(t, nx), first(t + 1, nx));
+    }
+  });
+
+  // Implicit along x and explicit along y, then the other way round. The
+  // explicit part is (2/dt) u + (2/dt - A) u, with A the matrix of the
+  // other half step.
+  pool.ParallelFor(tasks, [&](int t) {
+    for (int i = 0; i < nx; i++)
+      for (int j = first(t, ny); j < first(t + 1, ny); j++) {
+        const int below = (j == 0) ? ny - 1 : j - 1;
+        const int above = (j == ny - 1) ? 0 : j + 1;
+        const Row r = row(j, ny, D[i + 1][j], D[i + 1][j + 2]);
+        adiBH[i * ny + j] =
+            2 * twooverdt * u[i + 1][j + 1] -
+            (r.lower * u[i + 1][below + 1] + r.diag * u[i + 1][j + 1] +
+             r.upper * u[i + 1][above + 1]);
+      }
+    adiH.Solve(adiBH.data(), first(t, ny), first(t + 1, ny));
+  });
+
+  pool.ParallelFor(tasks, [&](int t) {
+    const PDEFIELD_TYPE *v = adiBH.data();
+    for (int j = 0; j < ny; j++)
+      for (int i = first(t, nx); i < first(t + 1, nx); i++) {
+        const int left = (i == 0) ? nx - 1 : i - 1;
+        const int right = (i == nx - 1) ? 0 : i + 1;
+        const Row r = row(i, nx, D[i][j + 1], D[i + 2][j + 1]);
+        adiBV[j * nx + i] =
+            2 * twooverdt * v[i * ny + j] -
+            (r.lower * v[left * ny + j] + r.diag * v[i * ny + j] +
+             r.upper * v[right * ny + j]);
+      }
+    adiV.Solve(adiBV.data(), first(t, nx), first(t + 1, nx));
+    for (int i = first(t, nx); i < first(t + 1, nx); i++)
+      for (int j = 0; j < ny; j++)
+        alt_PDEvars[l][i + 1][j + 1] = adiBV[j * nx + i];
+  });
+}
+
+bool PDE::UniformDiffusion(int l) const {
+  const PDEFIELD_TYPE *d = DiffCoeffs[l][0];
+  return std::all_of(d, d + sizex * sizey,
+                     [d](PDEFIELD_TYPE v) { return v == *d; });
+}
+
+bool PDE::SpectralPlane(int l) const {
+  return par.pde_solver == "spectral" && par.periodic_boundaries &&
+         UniformDiffusion(l);
+}
+
+void PDE::DiffuseSpectral(int l, PDEFIELD_TYPE **out, PDEFIELD_TYPE step) {
+  if (spectral.size() != static_cast<std::size_t>(layers))
+    spectral.resize(layers);
+  spectral[l].Step(PDEvars[l], out, sizex - 2, sizey - 2, DiffCoeffs[l][0][0],
+                   par.dx * par.dx, step);
 }
 
 void PDE::ReactionDiffusion(CellularPotts *cpm) {
@@ -386,6 +760,16 @@ void PDE::ReactionDiffusion(CellularPotts *cpm) {
   thetime += par.dt;
 }
 
+void PDE::BuildChemotaxisPotential() {
+  std::vector<double> strengths = par.chemotaxis_strengths;
+  if (strengths.empty()) {
+    strengths.assign(layers, 0.0);
+    strengths[0] = par.chemotaxis;
+  }
+  chemotaxis_potential.Build(PDEvars, layers, sizex, sizey, strengths,
+                             par.saturation);
+}
+
 double PDE::GetChemAmount(const int layer) {
   // Sum the total amount of chemical in the lattice
   // in layer l
@@ -408,6 +792,17 @@ double PDE::GetChemAmount(const int layer) {
   return sum;
 }
 
+// private
+void PDE::ApplyBoundaries() {
+  if (par.periodic_boundaries) {
+    PeriodicBoundaries();
+  } else if (par.pde_boundaries == "noflux") {
+    NoFluxBoundaries();
+  } else {
+    AbsorbingBoundaries();
+  }
+}
+
 // private
 void PDE::NoFluxBoundaries(void) {
   // all gradients at the edges become zero,
@@ -494,6 +889,7 @@ void PDE::GradC(int layer, int first_grad_layer) {
                                             2 * PDEvars[layer][x][y];
     }
   }
+  chemotaxis_potential.Stop();
 }
 
 void PDE::PlotVectorField(Graphics &g, int stride, int linelength,
@@ -555,4 +951,5 @@ void PDE::InitLinearYGradient(int spec, double conc_top, double conc_bottom) {
     }
     cerr << y << " " << val << endl;
   }
+  chemotaxis_potential.Stop();
 }
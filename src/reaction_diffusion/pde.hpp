@@ -30,15 +30,21 @@ Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
 #include <vector>
 
 
+#include "chemotaxis_potential.hpp"
 #include "cl_manager.hpp"
 #include "graph.hpp"
+#include "multigrid.hpp"
 #include "pdetype.h"
+#include "spectral_diffusion.hpp"
+#include "spin.hpp"
+#include "tridiagonal.hpp"
 
 class CellularPotts;
 class Dish;
 class PDE {
 
   friend class Info;
+  friend class PDETest;
 
 public:
   /** \brief Constructor for PDE object containing arbitrary number of planes.
@@ -111,6 +117,7 @@ public:
   inline void setValue(const int layer, const int x, const int y,
                        const PDEFIELD_TYPE value) {
     PDEvars[layer][x][y] = value;
+    chemotaxis_potential.Stop();
   }
 
   /** \brief Adds a number to a PDE grid point.
@@ -121,6 +128,7 @@ public:
   inline void addtoValue(const int layer, const int x, const int y,
                          const PDEFIELD_TYPE value) {
     PDEvars[layer][x][y] += value;
+    chemotaxis_potential.Stop();
   }
 
   /** \brief Gets the maximum value of PDE layer l.
@@ -192,7 +200,9 @@ public:
 
   /** \brief Intialisation of PDE variables
   \param cpm: CellularPotts plane the PDE plane interacts with
-  Initial conditions conditions for the PDE should be given here.
+  Initial conditions conditions for the PDE should be given here. Call
+  InvalidateChemotaxisPotential() afterwards, as the potential of the PDE
+  variables from before may already have been computed.
   */
   void InitialisePDE(CellularPotts *cpm);
 
@@ -213,13 +223,17 @@ public:
 
   /** \brief Carry out $n$ diffusion steps for all PDE planes.
 
-  We use a forward Euler method here. Can be replaced for better algorithm.
+  We use a forward Euler method here, or if pde_solver is "adi", a single
+  alternating directions implicit step of n * dt (see DiffuseADI()). If
+  pde_solver is "spectral", the planes with periodic boundaries and a single
+  diffusion coefficient take an exact step of n * dt instead (see
+  DiffuseSpectral()), and the others an ADI step.
 
   * * \param repeat: Number of steps.
 
   Time step dt, space step dx, diffusion coefficient diff_coeff and
-  boundary conditions (bool periodic_boundary) are set as global
-  parameters in a parameter file using class Parameter.
+  boundary conditions (bool periodic_boundary, pde_boundaries) are set as
+  global parameters in a parameter file using class Parameter.
 
   */
   void Diffuse(int repeat);
@@ -240,6 +254,37 @@ public:
   // Secrete and diffuse functions accelerated using OpenCL
   void SecreteAndDiffuseCL(CellularPotts *cpm, int repeat);
 
+  /** \brief Declares the secretion and decay of plane l for
+  SecreteAndDiffuse().
+
+  SecreteAndDiffuse() steps these in place of the Secrete() and
+  DerivativesPDE() of the model, so a model that calls it declares every
+  plane, with rates of 0 for a plane that only diffuses.
+  * \param l: The PDE plane
+  * \param secretion: Amount per unit of time gained by sites inside cells
+  * \param decay: Rate at which the other sites lose their value
+  */
+  void SetSecretion(int l, PDEFIELD_TYPE secretion, PDEFIELD_TYPE decay);
+
+  /** \brief Secretion, decay and diffusion in one sweep per step, on the CPU.
+
+  Does what Secrete() followed by Diffuse(1) does in the models, for every
+  plane, with the rates declared by SetSecretion(): sites inside cells gain
+  secretion * dt, other sites lose decay * dt times their value, and the
+  result diffuses by forward Euler with the boundaries of Diffuse(). The result ends up in PDEvars,
+  with PDEvars and alt_PDEvars swapped as needed. Up to 32 steps are taken
+  in a single sweep over the planes, with the same result as single steps.
+  Uses 'threads' threads, and a single coefficient if the diffusion
+  coefficients of a plane are all equal. The planes in multigrid_layers are
+  solved by SolveMultigrid() instead. If pde_solver is "adi" or "spectral",
+  the other planes take a single step of repeat * dt by
+  SecreteAndDiffuseSplit(), which diffuses them as Diffuse() does.
+  Throws std::runtime_error if a plane has no declared rates.
+  * \param cpm: CellularPotts plane whose cells secrete
+  * \param repeat: Number of steps
+  */
+  void SecreteAndDiffuse(CellularPotts *cpm, int repeat);
+
   /** \brief Returns cumulative "simulated" time,
     i.e. number of time steps * dt. */
   inline double TheTime(void) const { return thetime; }
@@ -296,6 +341,25 @@ public:
 
   inline PDEFIELD_TYPE ***getPDEvars() { return PDEvars; }
 
+  /** \brief The chemotactic potential of the PDE planes, per cell type.
+
+  Recomputed on first use after the PDE variables have changed. The
+  strengths are taken from par.chemotaxis_strengths, or if that is empty,
+  par.chemotaxis for plane 0 and all cell types.
+  */
+  inline const ChemotaxisPotential &GetChemotaxisPotential() {
+    if (!chemotaxis_potential.Live())
+      BuildChemotaxisPotential();
+    return chemotaxis_potential;
+  }
+
+  /** \brief Have the next GetChemotaxisPotential() recompute the potential.
+
+  The solvers, setValue() and addtoValue() do this themselves. Code that
+  writes to the PDE variables through getPDEvars() must call it afterwards.
+  */
+  inline void InvalidateChemotaxisPotential() { chemotaxis_potential.Stop(); }
+
   // CUDA functions
 
   /**
@@ -413,8 +477,7 @@ protected:
   PDEFIELD_TYPE *d_decay_rate;
   int **celltype;
   int *d_celltype;
-  int **sigmafield;
-  int *d_sigmafield;
+  Spin *d_sigmafield;
   PDEFIELD_TYPE *lowerH, *upperH, *diagH, *BH, *lowerV, *upperV, *diagV, *BV;
 
 private:
@@ -430,6 +493,97 @@ private:
 
   std::vector<std::string> species_names;
 
+  void BuildChemotaxisPotential();
+  ChemotaxisPotential chemotaxis_potential;
+
+  //! \brief Sets the edges of the PDE planes as the boundaries require.
+  void ApplyBoundaries();
+
+  /** \brief A Peaceman-Rachford ADI diffusion step on the CPU.
+
+    Like cuHorizontalADIstep() and cuVerticalADIstep(), but for plane l
+    and without the reaction part: half a step implicit along x and explicit
+    along y, then half a step the other way round. The tridiagonal systems
+    are set up and stored interleaved like lowerH/diagH/upperH and
+    lowerV/diagV/upperV of the CUDA solver, and the threads each solve a
+    range of them. The interior of the plane is solved, with the edges
+    acting as absorbing, no-flux or periodic (cyclic systems) boundaries,
+    like in the forward Euler method. Reads PDEvars and leaves the result in
+    alt_PDEvars, like Diffuse().
+
+    \param l: The plane to diffuse
+    \param step: Size of the time step.
+  */
+  void DiffuseADI(int l, PDEFIELD_TYPE step);
+  TridiagonalBatch adiH, adiV;
+  std::vector<PDEFIELD_TYPE> adiBH, adiBV;
+
+  /** \brief Solves plane l of PDEvars with multigrid, for SecreteAndDiffuse().
+
+    Solves the steady state of secretion, decay and diffusion, or a
+    backward Euler step of them (see multigrid_mode), on the interior of the
+    plane, starting from its current contents. The edges are left to
+    ApplyBoundaries().
+
+    \param cpm: CellularPotts plane whose cells secrete
+    \param l: The plane to solve
+    \param step: Size of the time step for a backward Euler step
+  */
+  void SolveMultigrid(CellularPotts *cpm, int l, PDEFIELD_TYPE step);
+  std::vector<Multigrid> multigrid;
+
+  //! \brief Whether the diffusion coefficients of plane l are all equal.
+  bool UniformDiffusion(int l) const;
+
+  //! \brief Whether plane l is diffused by DiffuseSpectral().
+  bool SpectralPlane(int l) const;
+
+  /** \brief An exact diffusion step of plane l of PDEvars by FFT.
+
+    For periodic boundaries and a single diffusion coefficient, the Fourier
+    modes of the plane decay independently under the stencil of Diffuse(),
+    so a step of any size is the limit of many small forward Euler steps
+    (see SpectralDiffusion). Reads the interior of the plane, so the edges
+    need not be set.
+
+    \param l: The plane to diffuse
+    \param out: Where the interior of the result goes, which may be the
+    plane itself
+    \param step: Size of the time step
+  */
+  void DiffuseSpectral(int l, PDEFIELD_TYPE **out, PDEFIELD_TYPE step);
+
+  /** \brief Secretion, decay and a single diffusion step of plane l of
+    PDEvars, for SecreteAndDiffuse().
+
+    The plane diffuses by DiffuseSpectral() if it can, and by DiffuseADI()
+    otherwise. Secretion and decay are solved exactly for half a step before
+    and after the diffusion (Strang splitting), which is second order
+    accurate in the step and stable for any step. The edges are left to
+    ApplyBoundaries().
+
+    \param cpm: CellularPotts plane whose cells secrete
+    \param l: The plane to step
+    \param step: Size of the time step
+  */
+  void SecreteAndDiffuseSplit(CellularPotts *cpm, int l, PDEFIELD_TYPE step);
+  std::vector<SpectralDiffusion> spectral;
+
+  /** \brief The sigma of every lattice site, sizex x sizey and without the
+    halo of the CPM lattice, as the OpenCL and CUDA solvers expect it.
+    \param cpm: The CPM whose lattice is copied.
+    \return A pointer to a copy that lives until the next call.
+  */
+  const Spin *SecretionMask(CellularPotts *cpm);
+  std::vector<Spin> secretion_mask;
+
+  //! \brief The rates of a plane, as declared by SetSecretion().
+  struct Rates {
+    PDEFIELD_TYPE secretion = 0, decay = 0;
+    bool declared = false;
+  };
+  std::vector<Rates> rates;
+
   /** \brief Initialise the OpenCL implementation of reaction diffusion solving
     This solver is no longer supported. Use at your own risk. We recommend the
     CUDA solver if you have access to an Nvidia GPU.
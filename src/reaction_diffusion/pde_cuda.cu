@@ -11,7 +11,7 @@
 
 
 __device__ void DerivativesPDE(PDEFIELD_TYPE current_time, PDEFIELD_TYPE *y,
-                               PDEFIELD_TYPE *dydt, int *sigmafield, int id,
+                               PDEFIELD_TYPE *dydt, Spin *sigmafield, int id,
                                PDEFIELD_TYPE *secr_rate,
                                PDEFIELD_TYPE *decay_rate) {
   int sigma = sigmafield[id];
@@ -41,7 +41,7 @@ void PDE::InitialiseCuda() {
   cudaMalloc((void **)&d_diffusioncoefficient,
              layers * sizex * sizey * sizeof(PDEFIELD_TYPE));
   cudaMalloc((void **)&d_celltype, sizex * sizey * sizeof(int));
-  cudaMalloc((void **)&d_sigmafield, sizex * sizey * sizeof(int));
+  cudaMalloc((void **)&d_sigmafield, sizex * sizey * sizeof(Spin));
 
   cudaMalloc((void **)&d_PDEvars,
              layers * sizex * sizey * sizeof(PDEFIELD_TYPE));
@@ -287,7 +287,7 @@ __global__ void NewPDEfieldOthers(
 __global__ void ODEstepFE(PDEFIELD_TYPE dt, PDEFIELD_TYPE ddt, double thetime,
                           int layers, int sizex, int sizey,
                           PDEFIELD_TYPE *PDEvars, PDEFIELD_TYPE *alt_PDEvars,
-                          int *sigmafield, PDEFIELD_TYPE *secr_rate,
+                          Spin *sigmafield, PDEFIELD_TYPE *secr_rate,
                           PDEFIELD_TYPE *decay_rate) {
 
   int nr_of_iterations = round(dt / ddt);
@@ -340,11 +340,10 @@ void PDE::cuPDEsteps(CellularPotts *cpm, int repeat) {
   // device
   cudaError_t errSync;
   cudaError_t errAsync;
-  sigmafield = cpm->getSigma();
   cudaMemcpy(d_diffusioncoefficient, DiffCoeffs[0][0],
              layers * sizex * sizey * sizeof(PDEFIELD_TYPE),
              cudaMemcpyHostToDevice);
-  cudaMemcpy(d_sigmafield, sigmafield[0], sizex * sizey * sizeof(int),
+  cudaMemcpy(d_sigmafield, SecretionMask(cpm), sizex * sizey * sizeof(Spin),
              cudaMemcpyHostToDevice);
   cudaMemcpy(d_PDEvars, PDEvars[0][0],
              layers * sizex * sizey * sizeof(PDEFIELD_TYPE),
@@ -382,6 +381,7 @@ void PDE::cuPDEsteps(CellularPotts *cpm, int repeat) {
              layers * sizex * sizey * sizeof(PDEFIELD_TYPE),
              cudaMemcpyDeviceToHost);
   cudaDeviceSynchronize();
+  chemotaxis_potential.Stop();
 }
 
 void PDE::cuODEstep() {
@@ -1,4 +1,4 @@
-void kernel SecreteAndDiffuse(global const int *sigmacells,
+void kernel SecreteAndDiffuse(global const SPIN_TYPE *sigmacells,
                               global const PDEFIELD_TYPE *sigmaA,
                               global PDEFIELD_TYPE *sigmaB, int xsize,
                               int ysize, int layers, PDEFIELD_TYPE decay_rate,
@@ -0,0 +1,97 @@
+#include "spectral_diffusion.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <cmath>
+
+void SpectralDiffusion::Step(PDEFIELD_TYPE *const *in, PDEFIELD_TYPE **out,
+                             int nx, int ny, PDEFIELD_TYPE D,
+                             PDEFIELD_TYPE dx2, PDEFIELD_TYPE step) {
+  using Complex = FFT::Complex;
+  const int half = ny / 2 + 1;
+  const double exponent = static_cast<double>(D) * step / dx2;
+  if (along_x_.Size() != nx || along_y_.Size() != ny ||
+      exponent != exponent_) {
+    const double pi = 3.14159265358979323846;
+    along_x_.Resize(nx);
+    along_y_.Resize(ny);
+    spectrum_.resize(static_cast<std::size_t>(nx) * half);
+    // the factor 1 / (nx ny) of the inverse transforms goes in here
+    exponent_ = exponent;
+    factor_x_.resize(nx);
+    for (int k = 0; k < nx; k++)
+      factor_x_[k] =
+          std::exp(-4 * exponent * std::pow(std::sin(pi * k / nx), 2)) /
+          (static_cast<double>(nx) * ny);
+    factor_y_.resize(half);
+    for (int k = 0; k < half; k++)
+      factor_y_[k] =
+          std::exp(-4 * exponent * std::pow(std::sin(pi * k / ny), 2));
+  }
+
+  ThreadPool &pool = WorkerPool();
+  const int pairs = (nx + 1) / 2;
+  const int pair_tasks = std::min(pool.Size(), pairs);
+  const int column_tasks = std::min(pool.Size(), half);
+
+  // Along y. With z = a + i b, the transforms of columns a and b are
+  // (Z_k + conj(Z_-k)) / 2 and (Z_k - conj(Z_-k)) / 2i.
+  pool.ParallelFor(pair_tasks, [&](int task) {
+    std::vector<Complex> z(ny), work(along_y_.WorkSize());
+    for (int p = task * pairs / pair_tasks;
+         p < (task + 1) * pairs / pair_tasks; p++) {
+      const int x = 2 * p;
+      const bool two = x + 1 < nx;
+      for (int y = 0; y < ny; y++)
+        z[y] = Complex(in[x + 1][y + 1], two ? in[x + 2][y + 1] : 0);
+      along_y_.Forward(z.data(), work.data());
+      Complex *a = &spectrum_[static_cast<std::size_t>(x) * half];
+      for (int k = 0; k < half; k++) {
+        const Complex zk = z[k];
+        const Complex conjugate = std::conj(z[k ? ny - k : 0]);
+        a[k] = (zk + conjugate) * 0.5;
+        if (two)
+          a[half + k] = (zk - conjugate) * Complex(0, -0.5);
+      }
+    }
+  });
+
+  // Along x, one frequency along y at a time, there and back again
+  pool.ParallelFor(column_tasks, [&](int task) {
+    std::vector<Complex> v(nx), work(along_x_.WorkSize());
+    for (int ky = task * half / column_tasks;
+         ky < (task + 1) * half / column_tasks; ky++) {
+      for (int x = 0; x < nx; x++)
+        v[x] = spectrum_[static_cast<std::size_t>(x) * half + ky];
+      along_x_.Forward(v.data(), work.data());
+      for (int kx = 0; kx < nx; kx++)
+        v[kx] *= factor_x_[kx] * factor_y_[ky];
+      along_x_.Inverse(v.data(), work.data());
+      for (int x = 0; x < nx; x++)
+        spectrum_[static_cast<std::size_t>(x) * half + ky] = v[x];
+    }
+  });
+
+  // Back along y, with the frequencies ky < 0 of the real columns from
+  // those ky > 0
+  pool.ParallelFor(pair_tasks, [&](int task) {
+    std::vector<Complex> z(ny), work(along_y_.WorkSize());
+    for (int p = task * pairs / pair_tasks;
+         p < (task + 1) * pairs / pair_tasks; p++) {
+      const int x = 2 * p;
+      const bool two = x + 1 < nx;
+      const Complex *a = &spectrum_[static_cast<std::size_t>(x) * half];
+      const Complex *b = two ? a + half : nullptr;
+      for (int k = 0; k < half; k++)
+        z[k] = a[k] + (two ? Complex(0, 1) * b[k] : Complex(0));
+      for (int k = half; k < ny; k++)
+        z[k] = std::conj(a[ny - k]) +
+               (two ? Complex(0, 1) * std::conj(b[ny - k]) : Complex(0));
+      along_y_.Inverse(z.data(), work.data());
+      for (int y = 0; y < ny; y++) {
+        out[x + 1][y + 1] = z[y].real();
+        if (two)
+          out[x + 2][y + 1] = z[y].imag();
+      }
+    }
+  });
+}
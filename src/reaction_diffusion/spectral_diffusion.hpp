@@ -0,0 +1,43 @@
+#pragma once
+#include "fft.hpp"
+#include "pdetype.h"
+#include <vector>
+
+/** @brief Exact diffusion steps on a periodic plane with a single diffusion
+ * coefficient.
+ *
+ * The Fourier modes of the periodic nx by ny interior of a plane are the
+ * eigenvectors of the stencil of PDE::Diffuse(), with eigenvalues
+ * -4 D / dx^2 (sin^2(pi kx / nx) + sin^2(pi ky / ny)). A step transforms
+ * the plane, multiplies each mode by the exponential of its eigenvalue times
+ * the step, and transforms back. That is what many small forward Euler
+ * steps tend to, and it is stable for any step size.
+ *
+ * The plane is real, so the columns are transformed two at a time, as the
+ * real and imaginary parts of a single complex transform, and only the
+ * ny / 2 + 1 frequencies ky >= 0 are kept. The transforms are spread over
+ * the worker pool.
+ */
+class SpectralDiffusion {
+public:
+  /** @brief Take a step on the interior of a plane.
+   * @param in The plane, including its edges, so that in[x + 1][y + 1] is
+   * site (x, y) of the interior
+   * @param out The plane to write the interior of, which may be in
+   * @param nx, ny Size of the interior
+   * @param D Diffusion coefficient
+   * @param dx2 Square of the grid spacing
+   * @param step Size of the time step
+   */
+  void Step(PDEFIELD_TYPE *const *in, PDEFIELD_TYPE **out, int nx, int ny,
+            PDEFIELD_TYPE D, PDEFIELD_TYPE dx2, PDEFIELD_TYPE step);
+
+private:
+  FFT along_x_, along_y_;
+  // D step / dx2 of the factors, and the factors of the modes along x and
+  // along y, whose products are the factors of the modes
+  double exponent_ = -1;
+  std::vector<double> factor_x_, factor_y_;
+  // the transform of the plane along y, nx by ny / 2 + 1
+  std::vector<FFT::Complex> spectrum_;
+};
@@ -0,0 +1,147 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "mock_model.cpp"
+#include "tissue.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+
+// Reads the planes that Diffuse() writes, which tests may do as friends
+class PDETest {
+public:
+  // The amount of chemical in the interior of plane l of alt_PDEvars
+  static double Diffused(const PDE &pde, int l) {
+    double sum = 0;
+    for (int x = 1; x < pde.sizex - 1; x++)
+      for (int y = 1; y < pde.sizey - 1; y++)
+        sum += pde.alt_PDEvars[l][x][y];
+    return sum;
+  }
+
+  static PDEFIELD_TYPE Diffused(const PDE &pde, int l, int x, int y) {
+    return pde.alt_PDEvars[l][x][y];
+  }
+};
+
+namespace {
+/* The amount of chemical before and after an ADI step of n dt, on a plane
+ * of random values. */
+void Diffuse(int sizex, int sizey, int n, double &before, double &after) {
+  par.n_chem = 1;
+  par.diff_coeff = {1e-13};
+  par.dx = 2e-6;
+  par.dt = 2.0;
+  par.pde_solver = "adi";
+  PDE pde(1, sizex, sizey);
+  pde.InitialiseDiffusionCoefficients(nullptr);
+  std::mt19937 rng(sizex * sizey + n);
+  std::uniform_real_distribution<PDEFIELD_TYPE> uniform(0, 1);
+  for (int x = 1; x < sizex - 1; x++)
+    for (int y = 1; y < sizey - 1; y++)
+      pde.setValue(0, x, y, uniform(rng));
+  before = pde.GetChemAmount(0);
+  pde.Diffuse(n);
+  after = PDETest::Diffused(pde, 0);
+}
+
+void Check(bool periodic, const std::string &boundaries) {
+  par.periodic_boundaries = periodic;
+  par.pde_boundaries = boundaries;
+  for (int sizex : {12, 31})
+    for (int sizey : {9, 40})
+      for (int n : {1, 15, 1000}) {
+        INFO(sizex << " by " << sizey << ", " << n << " steps, periodic "
+                   << periodic << ", " << boundaries);
+        double before, after;
+        Diffuse(sizex, sizey, n, before, after);
+        if (periodic || boundaries == "noflux")
+          REQUIRE(std::abs(after - before) <= 1e-4 * before);
+        else
+          REQUIRE(after < before);
+      }
+}
+
+/* SecreteAndDiffuse() with pde_solver adi, or spectral where that cannot
+ * be used, steps PDEvars, which the models read. Without secretion and decay
+ * its step is that of Diffuse(), and with secretion only and closed edges
+ * the cells add exactly what they secrete. */
+void CheckSecreteAndDiffuse(bool periodic, const std::string &boundaries,
+                            const std::string &solver) {
+  SetTissue(31, 40, periodic, 5, 8);
+  par.pde_boundaries = boundaries;
+  par.n_chem = 1;
+  par.diff_coeff = {1e-13};
+  par.dx = 2e-6;
+  par.dt = 2.0;
+  par.pde_solver = solver;
+  par.multigrid_layers.clear();
+  auto dish = MakeDish(29);
+  CellularPotts *cpm = dish->CPM;
+  const int repeat = 15;
+  INFO("periodic " << periodic << ", " << boundaries << ", " << solver);
+
+  PDE stepped(1, par.sizex, par.sizey), diffused(1, par.sizex, par.sizey);
+  stepped.InitialiseDiffusionCoefficients(cpm);
+  stepped.SetSecretion(0, 0, 0);
+  diffused.InitialiseDiffusionCoefficients(cpm);
+  std::mt19937 rng(repeat);
+  std::uniform_real_distribution<PDEFIELD_TYPE> uniform(0, 1);
+  for (int x = 1; x < par.sizex - 1; x++)
+    for (int y = 1; y < par.sizey - 1; y++) {
+      const PDEFIELD_TYPE value = uniform(rng);
+      stepped.setValue(0, x, y, value);
+      diffused.setValue(0, x, y, value);
+    }
+  stepped.SecreteAndDiffuse(cpm, repeat);
+  diffused.Diffuse(repeat);
+
+  int changed = 0;
+  double worst = 0;
+  for (int x = 1; x < par.sizex - 1; x++)
+    for (int y = 1; y < par.sizey - 1; y++) {
+      const double value = stepped.get_PDEvars(0, x, y);
+      changed += value != diffused.get_PDEvars(0, x, y);
+      worst = std::max(
+          worst, std::abs(value - PDETest::Diffused(diffused, 0, x, y)));
+    }
+  REQUIRE(changed > 0);
+  REQUIRE(worst <= 1e-6);
+
+  if (boundaries == "absorbing" && !periodic)
+    return;
+  stepped.SetSecretion(0, 1e-3, 0);
+  int inside = 0;
+  for (int x = 1; x < par.sizex - 1; x++)
+    for (int y = 1; y < par.sizey - 1; y++)
+      inside += cpm->Sigma(x, y) > 0;
+  const double before = stepped.GetChemAmount(0);
+  stepped.SecreteAndDiffuse(cpm, repeat);
+  const double secreted = 1e-3 * par.dt * repeat * inside;
+  REQUIRE(inside > 0);
+  REQUIRE(std::abs(stepped.GetChemAmount(0) - before - secreted) <=
+          1e-5 * (before + secreted));
+}
+} // namespace
+
+TEST_CASE("ADI diffusion conserves mass with no-flux edges", "[adi]") {
+  Check(false, "noflux");
+}
+
+TEST_CASE("ADI diffusion conserves mass with periodic edges", "[adi]") {
+  Check(true, "absorbing");
+}
+
+TEST_CASE("ADI diffusion loses mass through absorbing edges", "[adi]") {
+  Check(false, "absorbing");
+}
+
+TEST_CASE("SecreteAndDiffuse() takes ADI steps of the models' planes",
+          "[adi]") {
+  CheckSecreteAndDiffuse(false, "noflux", "adi");
+  CheckSecreteAndDiffuse(false, "absorbing", "adi");
+  CheckSecreteAndDiffuse(true, "absorbing", "adi");
+  CheckSecreteAndDiffuse(false, "noflux", "spectral");
+  CheckSecreteAndDiffuse(false, "absorbing", "spectral");
+}
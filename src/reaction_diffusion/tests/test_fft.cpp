@@ -0,0 +1,73 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "fft.cpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+using Complex = FFT::Complex;
+
+// The discrete Fourier transform by its definition, with sign -1 forward
+std::vector<Complex> NaiveDFT(const std::vector<Complex> &x, int sign) {
+  const int n = x.size();
+  const double pi = 3.14159265358979323846;
+  std::vector<Complex> result(n);
+  for (int k = 0; k < n; k++)
+    for (int j = 0; j < n; j++)
+      // j * k mod n keeps the angle small and accurate
+      result[k] += x[j] * std::polar(1.0, sign * 2 * pi *
+                                              ((1L * j * k) % n) / n);
+  return result;
+}
+
+double LargestDifference(const std::vector<Complex> &a,
+                         const std::vector<Complex> &b) {
+  double largest = 0;
+  for (std::size_t i = 0; i < a.size(); i++)
+    largest = std::max(largest, std::abs(a[i] - b[i]));
+  return largest;
+}
+
+void Check(int n) {
+  INFO("n = " << n);
+  std::mt19937 rng(n);
+  std::uniform_real_distribution<double> uniform(-1, 1);
+  std::vector<Complex> x(n);
+  for (Complex &v : x)
+    v = Complex(uniform(rng), uniform(rng));
+
+  FFT fft;
+  fft.Resize(n);
+  REQUIRE(fft.Size() == n);
+  std::vector<Complex> work(fft.WorkSize());
+  const double tolerance = 1e-12 * n;
+
+  std::vector<Complex> forward(x);
+  fft.Forward(forward.data(), work.data());
+  REQUIRE(LargestDifference(forward, NaiveDFT(x, -1)) <= tolerance);
+
+  std::vector<Complex> inverse(x);
+  fft.Inverse(inverse.data(), work.data());
+  REQUIRE(LargestDifference(inverse, NaiveDFT(x, 1)) <= tolerance);
+
+  // and there and back again gives n times the input
+  fft.Inverse(forward.data(), work.data());
+  for (Complex &v : forward)
+    v /= n;
+  REQUIRE(LargestDifference(forward, x) <= tolerance);
+}
+} // namespace
+
+TEST_CASE("FFT matches the DFT for lengths of small factors", "[fft]") {
+  for (int n : {1, 2, 3, 4, 5, 12, 1024})
+    Check(n);
+}
+
+TEST_CASE("FFT matches the DFT for lengths of other primes", "[fft]") {
+  // 7 takes the generic butterfly, 139 Bluestein's algorithm
+  for (int n : {7, 139})
+    Check(n);
+}
@@ -0,0 +1,206 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "mock_model.cpp"
+#include "tissue.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Sets the diffusion coefficients of a plane, which tests may do as friends
+class PDETest {
+public:
+  static void SetDiffusionCoefficient(PDE &pde, int l, int x, int y,
+                                      PDEFIELD_TYPE d) {
+    pde.DiffCoeffs[l][x][y] = d;
+  }
+};
+
+namespace {
+/* Diffusion coefficients for a plane of nx by ny sites with its edges,
+ * around D, in the layout of PDE::DiffCoeffs. With periodic edges, those
+ * on the edges are copies of the opposite side. */
+class Coefficients {
+public:
+  Coefficients(int nx, int ny, bool periodic, double D, unsigned seed)
+      : values_(nx + 2, std::vector<PDEFIELD_TYPE>(ny + 2)) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> uniform(0.5, 1.5);
+    for (auto &column : values_)
+      for (PDEFIELD_TYPE &d : column)
+        d = D * uniform(rng);
+    if (periodic) {
+      for (int x = 0; x < nx + 2; x++) {
+        values_[x][0] = values_[x][ny];
+        values_[x][ny + 1] = values_[x][1];
+      }
+      for (int y = 0; y < ny + 2; y++) {
+        values_[0][y] = values_[nx][y];
+        values_[nx + 1][y] = values_[1][y];
+      }
+    }
+    for (auto &column : values_)
+      rows_.push_back(column.data());
+  }
+
+  PDEFIELD_TYPE *const *Rows() const { return rows_.data(); }
+  PDEFIELD_TYPE operator()(int x, int y) const { return values_[x][y]; }
+
+private:
+  std::vector<std::vector<PDEFIELD_TYPE>> values_;
+  std::vector<PDEFIELD_TYPE *> rows_;
+};
+
+/* The largest residual after each of a few V-cycles, starting from a
+ * random guess, with decay on some sites and not on others, as outside
+ * and inside cells. */
+std::vector<double> Residuals(int nx, int ny, bool periodic, bool noflux) {
+  const double dx2 = 4e-12;
+  const Coefficients D(nx, ny, periodic, 1e-13, nx * ny);
+  std::mt19937 rng(nx + ny);
+  std::uniform_real_distribution<PDEFIELD_TYPE> uniform(0, 1);
+
+  Multigrid solver;
+  solver.Resize(nx, ny, periodic, noflux);
+  for (int k = 0; k < nx * ny; k++) {
+    solver.Reaction()[k] = uniform(rng) < 0.5 ? 1e-3 : 0;
+    solver.Rhs()[k] = uniform(rng) * 1e-3;
+    solver.Solution()[k] = uniform(rng);
+  }
+  solver.SetOperator(D.Rows(), dx2);
+
+  std::vector<double> residuals;
+  solver.Solve(0, 0);
+  residuals.push_back(solver.Residual());
+  for (int cycle = 0; cycle < 3; cycle++) {
+    solver.Solve(0, 1);
+    residuals.push_back(solver.Residual());
+  }
+  return residuals;
+}
+
+void CheckCycles(bool periodic, bool noflux) {
+  for (auto size : {std::make_pair(64, 48), std::make_pair(61, 37),
+                    std::make_pair(50, 75)}) {
+    const auto residuals = Residuals(size.first, size.second, periodic, noflux);
+    for (std::size_t i = 1; i < residuals.size(); i++) {
+      INFO(size.first << " by " << size.second << ", periodic " << periodic
+                      << ", noflux " << noflux << ", cycle " << i);
+      REQUIRE(residuals[i] <= 0.5 * residuals[i - 1]);
+    }
+  }
+}
+
+/* The steady state of secretion in cells, decay outside them and diffusion
+ * on a small plane, by Gaussian elimination of the equations of Multigrid.
+ * Sites are numbered (x - 1) * ny + y - 1. */
+std::vector<double> DirectSolve(const CellularPotts &cpm,
+                                const Coefficients &D, double dx2) {
+  const int nx = par.sizex - 2, ny = par.sizey - 2, n = nx * ny;
+  const bool periodic = par.periodic_boundaries;
+  const bool noflux = !periodic && par.pde_boundaries == "noflux";
+  std::vector<std::vector<double>> m(n, std::vector<double>(n + 1, 0));
+  for (int x = 1; x <= nx; x++)
+    for (int y = 1; y <= ny; y++) {
+      const int k = (x - 1) * ny + y - 1;
+      const bool inside = cpm.Sigma(x, y) > 0;
+      m[k][k] = inside ? 0 : par.decay_rate[0];
+      m[k][n] = inside ? par.secr_rate[0] : 0;
+      const int dx[] = {-1, 1, 0, 0}, dy[] = {0, 0, -1, 1};
+      for (int i = 0; i < 4; i++) {
+        int xn = x + dx[i], yn = y + dy[i];
+        const double w = D(xn, yn) / dx2;
+        const bool edge = xn < 1 || xn > nx || yn < 1 || yn > ny;
+        if (edge && noflux)
+          continue;
+        m[k][k] += w;
+        if (edge && !periodic)
+          continue;
+        xn = (xn + nx - 1) % nx + 1;
+        yn = (yn + ny - 1) % ny + 1;
+        m[k][(xn - 1) * ny + yn - 1] -= w;
+      }
+    }
+
+  for (int col = 0; col < n; col++) {
+    int pivot = col;
+    for (int row = col + 1; row < n; row++)
+      if (std::abs(m[row][col]) > std::abs(m[pivot][col]))
+        pivot = row;
+    std::swap(m[col], m[pivot]);
+    for (int row = 0; row < n; row++) {
+      if (row == col)
+        continue;
+      const double factor = m[row][col] / m[col][col];
+      for (int j = col; j <= n; j++)
+        m[row][j] -= factor * m[col][j];
+    }
+  }
+  std::vector<double> c(n);
+  for (int k = 0; k < n; k++)
+    c[k] = m[k][n] / m[k][k];
+  return c;
+}
+
+void CheckSteady(bool periodic, const std::string &boundaries) {
+  SetTissue(13, 10, periodic, 3, 3);
+  par.pde_boundaries = boundaries;
+  par.n_chem = 1;
+  par.diff_coeff = {1e-13};
+  par.secr_rate = {1e-3};
+  par.decay_rate = {1e-3};
+  par.dx = 2e-6;
+  par.dt = 2.0;
+  par.multigrid_layers = {0};
+  par.multigrid_mode = "steady";
+  par.multigrid_tolerance = 1e-6;
+  par.multigrid_cycles = 100;
+  auto dish = MakeDish(31);
+  CellularPotts &cpm = *dish->CPM;
+  PDE &pde = *dish->PDEfield;
+
+  const Coefficients D(par.sizex - 2, par.sizey - 2, periodic, 1e-13, 7);
+  for (int x = 0; x < par.sizex; x++)
+    for (int y = 0; y < par.sizey; y++)
+      PDETest::SetDiffusionCoefficient(pde, 0, x, y, D(x, y));
+  pde.SecreteAndDiffuse(&cpm, par.pde_its);
+  const auto expected = DirectSolve(cpm, D, par.dx * par.dx);
+
+  INFO("periodic " << periodic << ", " << boundaries);
+  double worst = 0, largest = 0;
+  for (int x = 1; x < par.sizex - 1; x++)
+    for (int y = 1; y < par.sizey - 1; y++) {
+      const double c = expected[(x - 1) * (par.sizey - 2) + y - 1];
+      worst = std::max(worst, std::abs(pde.get_PDEvars(0, x, y) - c));
+      largest = std::max(largest, std::abs(c));
+    }
+  REQUIRE(largest > 0);
+  REQUIRE(worst <= 1e-4 * largest);
+  par.multigrid_layers.clear();
+}
+} // namespace
+
+TEST_CASE("A V-cycle reduces the residual with absorbing edges",
+          "[multigrid]") {
+  CheckCycles(false, false);
+}
+
+TEST_CASE("A V-cycle reduces the residual with no-flux edges",
+          "[multigrid]") {
+  CheckCycles(false, true);
+}
+
+TEST_CASE("A V-cycle reduces the residual with periodic edges",
+          "[multigrid]") {
+  CheckCycles(true, false);
+}
+
+TEST_CASE("Steady multigrid matches a direct solve", "[multigrid]") {
+  CheckSteady(false, "absorbing");
+  CheckSteady(false, "noflux");
+  CheckSteady(true, "absorbing");
+}
@@ -0,0 +1,161 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "mock_model.cpp"
+#include "tissue.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+// Runs the steps of the models by hand, which tests may do as friends
+class PDETest {
+public:
+  /* What the models do instead of SecreteAndDiffuse(cpm, repeat): Secrete()
+   * reads alt_PDEvars and Diffuse(1) writes it, so the planes are copied
+   * over before the first step and back after the last. */
+  static void SecreteThenDiffuse(PDE &pde, CellularPotts *cpm, int repeat) {
+    const int sites = pde.layers * pde.sizex * pde.sizey;
+    std::copy(pde.PDEvars[0][0], pde.PDEvars[0][0] + sites,
+              pde.alt_PDEvars[0][0]);
+    for (int r = 0; r < repeat; r++) {
+      pde.Secrete(cpm);
+      pde.Diffuse(1);
+    }
+    std::copy(pde.alt_PDEvars[0][0], pde.alt_PDEvars[0][0] + sites,
+              pde.PDEvars[0][0]);
+  }
+
+  static void SetDiffusionCoefficient(PDE &pde, int l, int x, int y,
+                                      PDEFIELD_TYPE d) {
+    pde.DiffCoeffs[l][x][y] = d;
+  }
+};
+
+namespace {
+std::unique_ptr<Dish> Tissue(int sizex, int sizey, bool periodic,
+                             const std::string &boundaries) {
+  SetTissue(sizex, sizey, periodic, 12, 8);
+  par.pde_boundaries = boundaries;
+  par.n_chem = 2;
+  par.diff_coeff = {1e-13, 3e-13};
+  par.secr_rate = {1e-3, 5e-4};
+  par.decay_rate = {1e-3, 2e-3};
+  par.dx = 2e-6;
+  par.dt = 2.0;
+  par.pde_solver = "euler";
+  par.multigrid_layers.clear();
+  return MakeDish(23);
+}
+
+// A plane with random values and, unless uniform, diffusion coefficients
+void Fill(PDE &pde, CellularPotts *cpm, bool uniform, unsigned seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<PDEFIELD_TYPE> uniform_value(0, 1);
+  pde.InitialiseDiffusionCoefficients(cpm);
+  for (int l = 0; l < pde.Layers(); l++)
+    pde.SetSecretion(l, par.secr_rate[l], par.decay_rate[l]);
+  for (int l = 0; l < pde.Layers(); l++)
+    for (int x = 0; x < pde.SizeX(); x++)
+      for (int y = 0; y < pde.SizeY(); y++) {
+        pde.setValue(l, x, y, uniform_value(rng));
+        if (!uniform)
+          PDETest::SetDiffusionCoefficient(
+              pde, l, x, y,
+              par.diff_coeff[l] * (0.5 + uniform_value(rng)));
+      }
+}
+
+void Check(bool periodic, const std::string &boundaries, bool uniform) {
+  auto dish = Tissue(50, 43, periodic, boundaries);
+  CellularPotts *cpm = dish->CPM;
+  for (int repeat : {1, 5, 32, 45}) {
+    INFO(repeat << " steps, periodic " << periodic << ", " << boundaries
+                << ", uniform " << uniform);
+    PDE fused(par.n_chem, par.sizex, par.sizey);
+    PDE models(par.n_chem, par.sizex, par.sizey);
+    Fill(fused, cpm, uniform, repeat);
+    Fill(models, cpm, uniform, repeat);
+    fused.SecreteAndDiffuse(cpm, repeat);
+    PDETest::SecreteThenDiffuse(models, cpm, repeat);
+
+    // the same within float rounding
+    double worst = 0;
+    for (int l = 0; l < par.n_chem; l++)
+      for (int x = 1; x < par.sizex - 1; x++)
+        for (int y = 1; y < par.sizey - 1; y++) {
+          const double expected = models.get_PDEvars(l, x, y);
+          const double error = std::abs(fused.get_PDEvars(l, x, y) - expected);
+          worst = std::max(worst, error / std::max(1.0, std::abs(expected)));
+        }
+    REQUIRE(worst <= 1e-5);
+  }
+}
+
+/* SecreteAndDiffuse(cpm, repeat) takes its steps in blocks, which must give
+ * exactly what as many single steps give, also on planes narrower than a
+ * block and split over several threads. */
+void CheckBlocks(int sizex, int sizey, bool periodic,
+                 const std::string &boundaries, int threads) {
+  auto dish = Tissue(sizex, sizey, periodic, boundaries);
+  CellularPotts *cpm = dish->CPM;
+  par.threads = threads;
+  for (bool uniform : {true, false})
+    for (int repeat : {2, 31, 32, 33, 70}) {
+      INFO(sizex << " by " << sizey << ", " << repeat << " steps, periodic "
+                 << periodic << ", " << boundaries << ", " << threads
+                 << " threads, uniform " << uniform);
+      PDE blocks(par.n_chem, par.sizex, par.sizey);
+      PDE single(par.n_chem, par.sizex, par.sizey);
+      Fill(blocks, cpm, uniform, repeat);
+      Fill(single, cpm, uniform, repeat);
+      blocks.SecreteAndDiffuse(cpm, repeat);
+      for (int r = 0; r < repeat; r++)
+        single.SecreteAndDiffuse(cpm, 1);
+
+      int different = 0;
+      for (int l = 0; l < par.n_chem; l++)
+        for (int x = 1; x < par.sizex - 1; x++)
+          for (int y = 1; y < par.sizey - 1; y++)
+            different +=
+                blocks.get_PDEvars(l, x, y) != single.get_PDEvars(l, x, y);
+      REQUIRE(different == 0);
+    }
+  par.threads = 1;
+}
+} // namespace
+
+TEST_CASE("SecreteAndDiffuse() does what Secrete() and Diffuse() do",
+          "[secrete_and_diffuse]") {
+  for (bool uniform : {true, false}) {
+    Check(false, "absorbing", uniform);
+    Check(false, "noflux", uniform);
+    Check(true, "absorbing", uniform);
+  }
+}
+
+TEST_CASE("SecreteAndDiffuse() in blocks gives the same as single steps",
+          "[secrete_and_diffuse]") {
+  for (int threads : {1, 3}) {
+    for (bool periodic : {false, true}) {
+      CheckBlocks(24, 30, periodic, "absorbing", threads);
+      CheckBlocks(80, 45, periodic, "absorbing", threads);
+    }
+    CheckBlocks(24, 30, false, "noflux", threads);
+    CheckBlocks(80, 45, false, "noflux", threads);
+  }
+}
+
+TEST_CASE("SecreteAndDiffuse() needs the rates of every plane",
+          "[secrete_and_diffuse]") {
+  auto dish = Tissue(24, 30, false, "absorbing");
+  CellularPotts *cpm = dish->CPM;
+  PDE pde(par.n_chem, par.sizex, par.sizey);
+  pde.InitialiseDiffusionCoefficients(cpm);
+  pde.SetSecretion(0, par.secr_rate[0], par.decay_rate[0]);
+  REQUIRE_THROWS_AS(pde.SecreteAndDiffuse(cpm, 1), std::runtime_error);
+  pde.SetSecretion(1, 0, 0);
+  REQUIRE_NOTHROW(pde.SecreteAndDiffuse(cpm, 1));
+}
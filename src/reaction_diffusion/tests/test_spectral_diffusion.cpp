@@ -0,0 +1,93 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "mock_model.cpp"
+#include "spectral_diffusion.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+const double pi = 3.14159265358979323846;
+const PDEFIELD_TYPE D = 1e-13, dx2 = 4e-12, step = 20;
+
+// An nx by ny plane with its edges, as PDE keeps them
+class Plane {
+public:
+  Plane(int nx, int ny) : values_(nx + 2, std::vector<PDEFIELD_TYPE>(ny + 2)) {
+    for (auto &column : values_)
+      rows_.push_back(column.data());
+  }
+
+  PDEFIELD_TYPE **Rows() { return rows_.data(); }
+  // site (x, y) of the interior
+  PDEFIELD_TYPE &operator()(int x, int y) { return values_[x + 1][y + 1]; }
+
+private:
+  std::vector<std::vector<PDEFIELD_TYPE>> values_;
+  std::vector<PDEFIELD_TYPE *> rows_;
+};
+
+/* A single Fourier mode decays by exp(-4 D step / dx2 (sin^2(pi kx / nx) +
+ * sin^2(pi ky / ny))), and keeps its shape. Returns the largest deviation
+ * from that. */
+double ModeError(int nx, int ny, int kx, int ky) {
+  Plane in(nx, ny), out(nx, ny);
+  auto mode = [&](int x, int y) {
+    return std::cos(2 * pi * (double(kx) * x / nx + double(ky) * y / ny) +
+                    0.3);
+  };
+  for (int x = 0; x < nx; x++)
+    for (int y = 0; y < ny; y++)
+      in(x, y) = mode(x, y);
+
+  SpectralDiffusion spectral;
+  spectral.Step(in.Rows(), out.Rows(), nx, ny, D, dx2, step);
+  const double factor =
+      std::exp(-4 * D * step / dx2 *
+               (std::pow(std::sin(pi * kx / nx), 2) +
+                std::pow(std::sin(pi * ky / ny), 2)));
+  double largest = 0;
+  for (int x = 0; x < nx; x++)
+    for (int y = 0; y < ny; y++)
+      largest = std::max(largest, std::abs(out(x, y) - factor * mode(x, y)));
+  return largest;
+}
+} // namespace
+
+TEST_CASE("Spectral steps decay Fourier modes by their factors",
+          "[spectral_diffusion]") {
+  // an odd nx leaves a single column over from the pairs of columns
+  for (int nx : {15, 16})
+    for (int ny : {9, 12})
+      for (int kx : {0, 1, 3, nx / 2})
+        for (int ky : {0, 2, ny / 2}) {
+          INFO(nx << " by " << ny << ", mode " << kx << ", " << ky);
+          REQUIRE(ModeError(nx, ny, kx, ky) <= 1e-5);
+        }
+}
+
+TEST_CASE("Spectral steps conserve mass", "[spectral_diffusion]") {
+  for (int nx : {1, 15, 32})
+    for (int ny : {1, 7, 40}) {
+      INFO(nx << " by " << ny);
+      std::mt19937 rng(nx * ny);
+      std::uniform_real_distribution<PDEFIELD_TYPE> uniform(0, 1);
+      Plane plane(nx, ny);
+      double before = 0;
+      for (int x = 0; x < nx; x++)
+        for (int y = 0; y < ny; y++)
+          before += plane(x, y) = uniform(rng);
+
+      // in place, as SecreteAndDiffuseSplit() steps
+      SpectralDiffusion spectral;
+      for (int s = 0; s < 3; s++)
+        spectral.Step(plane.Rows(), plane.Rows(), nx, ny, D, dx2, step);
+      double after = 0;
+      for (int x = 0; x < nx; x++)
+        for (int y = 0; y < ny; y++)
+          after += plane(x, y);
+      REQUIRE(std::abs(after - before) <= 1e-5 * before);
+    }
+}
@@ -0,0 +1,76 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "tridiagonal.cpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+/* Solves a batch of random, diagonally dominant systems in two ranges of
+ * systems, and returns the largest residual |Ax - b| relative to the
+ * largest |b|. */
+double Residual(int n, int batch, int element_stride, int system_stride,
+                bool cyclic, unsigned seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> uniform(-1, 1);
+
+  TridiagonalBatch a;
+  a.Resize(n, batch, element_stride, system_stride, cyclic);
+  std::vector<PDEFIELD_TYPE> b(static_cast<std::size_t>(n) * batch);
+  for (int s = 0; s < batch; s++)
+    for (int i = 0; i < n; i++) {
+      a.Lower(i, s) = uniform(rng);
+      a.Upper(i, s) = uniform(rng);
+      a.Diag(i, s) = (uniform(rng) < 0 ? -1 : 1) *
+                     (std::abs(a.Lower(i, s)) + std::abs(a.Upper(i, s)) +
+                      0.5 + std::abs(uniform(rng)));
+      b[i * element_stride + s * system_stride] = 10 * uniform(rng);
+    }
+
+  const int middle = batch / 2;
+  a.Factorise(0, middle);
+  a.Factorise(middle, batch);
+  std::vector<PDEFIELD_TYPE> x(b);
+  a.Solve(x.data(), 0, middle);
+  a.Solve(x.data(), middle, batch);
+
+  // Lower(0) and Upper(n - 1) only couple around in a cyclic system
+  auto at = [&](int i, int s) -> double {
+    return x[i * element_stride + s * system_stride];
+  };
+  double residual = 0, largest = 0;
+  for (int s = 0; s < batch; s++)
+    for (int i = 0; i < n; i++) {
+      double ax = a.Diag(i, s) * at(i, s);
+      if (i > 0 || cyclic)
+        ax += a.Lower(i, s) * at((i + n - 1) % n, s);
+      if (i < n - 1 || cyclic)
+        ax += a.Upper(i, s) * at((i + 1) % n, s);
+      const double bi = b[i * element_stride + s * system_stride];
+      residual = std::max(residual, std::abs(ax - bi));
+      largest = std::max(largest, std::abs(bi));
+    }
+  return residual / largest;
+}
+
+void Check(bool cyclic) {
+  for (int n : {1, 2, 3, 5, 16, 101}) {
+    if (cyclic && n < 2)
+      continue;
+    for (int batch : {1, 4, 37}) {
+      INFO(n << " equations, " << batch << " systems, cyclic " << cyclic);
+      // interleaved, as DiffuseADI() uses them, and one after the other
+      REQUIRE(Residual(n, batch, batch, 1, cyclic, n * batch) < 1e-5);
+      REQUIRE(Residual(n, batch, 1, n, cyclic, n * batch + 1) < 1e-5);
+    }
+  }
+}
+} // namespace
+
+TEST_CASE("Tridiagonal systems are solved", "[tridiagonal]") { Check(false); }
+
+TEST_CASE("Cyclic tridiagonal systems are solved", "[tridiagonal]") {
+  Check(true);
+}
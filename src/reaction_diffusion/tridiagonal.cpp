@@ -0,0 +1,100 @@
+#include "tridiagonal.hpp"
+
+void TridiagonalBatch::Resize(int n, int batch, int element_stride,
+                              int system_stride, bool cyclic) {
+  n_ = n;
+  batch_ = batch;
+  element_stride_ = element_stride;
+  system_stride_ = system_stride;
+  cyclic_ = cyclic;
+  const std::size_t size = static_cast<std::size_t>(n) * batch;
+  lower_.assign(size, 0);
+  diag_.assign(size, 0);
+  upper_.assign(size, 0);
+  pivot_.resize(size);
+  upper_factor_.resize(size);
+  if (cyclic) {
+    z_.resize(size);
+    beta_over_gamma_.resize(batch);
+    correction_.resize(batch);
+  }
+}
+
+void TridiagonalBatch::Factorise(int first, int last) {
+  // A cyclic system is split as A = A' + u v^T, with u = (gamma, 0, .., alpha)
+  // and v = (1, 0, .., beta / gamma), which leaves A' tridiagonal. The
+  // diagonal of A' goes into pivot_ first.
+  for (int i = 0; i < n_; i++)
+    for (int s = first; s < last; s++)
+      pivot_[Index(i, s)] = diag_[Index(i, s)];
+  if (cyclic_) {
+    for (int s = first; s < last; s++) {
+      const PDEFIELD_TYPE gamma = -diag_[Index(0, s)];
+      beta_over_gamma_[s] = lower_[Index(0, s)] / gamma;
+      pivot_[Index(0, s)] -= gamma;
+      pivot_[Index(n_ - 1, s)] -=
+          upper_[Index(n_ - 1, s)] * beta_over_gamma_[s];
+    }
+  }
+
+  for (int s = first; s < last; s++) {
+    const int k = Index(0, s);
+    pivot_[k] = 1 / pivot_[k];
+    upper_factor_[k] = upper_[k] * pivot_[k];
+  }
+  for (int i = 1; i < n_; i++) {
+    const int row = i * element_stride_;
+    for (int s = first; s < last; s++) {
+      const int k = row + s * system_stride_;
+      pivot_[k] =
+          1 / (pivot_[k] - lower_[k] * upper_factor_[k - element_stride_]);
+      upper_factor_[k] = upper_[k] * pivot_[k];
+    }
+  }
+
+  if (!cyclic_)
+    return;
+  for (int i = 0; i < n_; i++)
+    for (int s = first; s < last; s++)
+      z_[Index(i, s)] = 0;
+  for (int s = first; s < last; s++) {
+    z_[Index(0, s)] += -diag_[Index(0, s)];
+    z_[Index(n_ - 1, s)] += upper_[Index(n_ - 1, s)];
+  }
+  Thomas(z_.data(), first, last);
+  for (int s = first; s < last; s++)
+    correction_[s] = 1 / (1 + z_[Index(0, s)] +
+                          beta_over_gamma_[s] * z_[Index(n_ - 1, s)]);
+}
+
+void TridiagonalBatch::Solve(PDEFIELD_TYPE *x, int first, int last) const {
+  Thomas(x, first, last);
+  if (!cyclic_)
+    return;
+  for (int s = first; s < last; s++) {
+    const PDEFIELD_TYPE factor =
+        (x[Index(0, s)] + beta_over_gamma_[s] * x[Index(n_ - 1, s)]) *
+        correction_[s];
+    for (int i = 0; i < n_; i++)
+      x[Index(i, s)] -= factor * z_[Index(i, s)];
+  }
+}
+
+void TridiagonalBatch::Thomas(PDEFIELD_TYPE *x, int first, int last) const {
+  for (int s = first; s < last; s++)
+    x[Index(0, s)] *= pivot_[Index(0, s)];
+  for (int i = 1; i < n_; i++) {
+    const int row = i * element_stride_;
+    for (int s = first; s < last; s++) {
+      const int k = row + s * system_stride_;
+      x[k] = (x[k] - lower_[k] * x[k - element_stride_]) * pivot_[k];
+    }
+  }
+  for (int i = n_ - 2; i >= 0; i--) {
+    const int row = i * element_stride_;
+    for (int s = first; s < last; s++) {
+      const int k = row + s * system_stride_;
+      x[k] -= upper_factor_[k] * x[k + element_stride_];
+    }
+  }
+}
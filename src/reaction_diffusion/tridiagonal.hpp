@@ -0,0 +1,68 @@
+#pragma once
+#include "pdetype.h"
+#include <vector>
+
+/** @brief A batch of tridiagonal systems of n equations each.
+ *
+ * Equation i of system s is stored at i * element_stride + s * system_stride,
+ * With system_stride 1 the systems are interleaved, as for
+ * cusparse<t>gtsvInterleavedBatch, which lets the solver work on a whole
+ * row of systems at a time.
+ *
+ * Fill in the matrix with Lower(), Diag() and Upper(), call Factorise() and
+ * then Solve() as often as needed. Row i couples to unknowns i - 1, i and
+ * i + 1. In a cyclic batch, Lower(0, s) couples to unknown n - 1 and
+ * Upper(n - 1, s) to unknown 0, otherwise they are ignored. Cyclic systems
+ * are solved by the Sherman-Morrison formula and need n >= 2.
+ *
+ * Factorise() and Solve() work on a range of systems, so that different
+ * threads can handle different systems.
+ */
+class TridiagonalBatch {
+public:
+  void Resize(int n, int batch, int element_stride, int system_stride,
+              bool cyclic);
+
+  int Size() const { return n_; }
+  int Batch() const { return batch_; }
+  bool Cyclic() const { return cyclic_; }
+
+  PDEFIELD_TYPE &Lower(int i, int s) { return lower_[Index(i, s)]; }
+  PDEFIELD_TYPE &Diag(int i, int s) { return diag_[Index(i, s)]; }
+  PDEFIELD_TYPE &Upper(int i, int s) { return upper_[Index(i, s)]; }
+  PDEFIELD_TYPE Lower(int i, int s) const { return lower_[Index(i, s)]; }
+  PDEFIELD_TYPE Diag(int i, int s) const { return diag_[Index(i, s)]; }
+  PDEFIELD_TYPE Upper(int i, int s) const { return upper_[Index(i, s)]; }
+
+  //! @brief Factorise systems first up to last
+  void Factorise(int first, int last);
+
+  /** @brief Solve systems first up to last in place
+   * @param x The right-hand sides on entry and the solutions on return, in
+   * the layout of the batch.
+   */
+  void Solve(PDEFIELD_TYPE *x, int first, int last) const;
+
+private:
+  int Index(int i, int s) const {
+    return i * element_stride_ + s * system_stride_;
+  }
+  void Thomas(PDEFIELD_TYPE *x, int first, int last) const;
+
+  int n_ = 0;
+  int batch_ = 0;
+  int element_stride_ = 0;
+  int system_stride_ = 0;
+  bool cyclic_ = false;
+
+  std::vector<PDEFIELD_TYPE> lower_, diag_, upper_;
+
+  // the factorisation: the reciprocal pivots and the eliminated upper
+  // diagonal of the Thomas algorithm
+  std::vector<PDEFIELD_TYPE> pivot_, upper_factor_;
+
+  // for cyclic systems, the solution for the Sherman-Morrison correction,
+  // and per system Lower(0) / gamma and 1 / (1 + v.z)
+  std::vector<PDEFIELD_TYPE> z_;
+  std::vector<PDEFIELD_TYPE> beta_over_gamma_, correction_;
+};
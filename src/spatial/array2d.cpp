@@ -1,4 +1,5 @@
 #include "array2d.hpp"
+#include <cstdint>
 
 /// Takes care of the mapping of coordinates based on type of boundary
 Vec2<int> map_coordinate_torus(Vec2<int> coordinate, int sizex, int sizey) {
@@ -72,6 +73,11 @@ template <typename DataType> DataType *Array2d<DataType>::get_data() {
   return data_.data();
 }
 
+template <typename DataType>
+const DataType *Array2d<DataType>::get_data() const {
+  return data_.data();
+}
+
 template <typename DataType>
 void Array2d<DataType>::set(Vec2<int> coordinate, int layer, DataType value) {
   if (layer < 0 or layer >= layers_) {
@@ -88,4 +94,7 @@ void Array2d<DataType>::set(Vec2<int> coordinate, int layer, DataType value) {
 
 template class Array2d<int>;
 template class Array2d<double>;
-template class Array2d<float>;
\ No newline at end of file
+template class Array2d<float>;
+#ifdef COMPACT_SPINS_ENABLED
+template class Array2d<std::int16_t>;
+#endif
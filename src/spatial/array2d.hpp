@@ -88,6 +88,12 @@ public:
    */
   DataType *get_data();
 
+  /**
+   * @brief Used to get the underlying pointer to the continuous data;
+   * @return Pointer to the data
+   */
+  const DataType *get_data() const;
+
 private:
   int sizex_;
   int sizey_;
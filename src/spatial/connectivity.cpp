@@ -0,0 +1,80 @@
+#include "connectivity.hpp"
+#include <algorithm>
+
+namespace Connectivity {
+
+void SameSpinMasks(const Spin *left, const Spin *mid, const Spin *right, int n,
+                   unsigned char *masks) {
+  for (int k = 0; k < n; k++) {
+    const int spin = mid[k];
+    masks[k] = (left[k] == spin) | (left[k - 1] == spin) << 1 |
+               (mid[k - 1] == spin) << 2 | (right[k - 1] == spin) << 3 |
+               (right[k] == spin) << 4 | (right[k + 1] == spin) << 5 |
+               (mid[k + 1] == spin) << 6 | (left[k + 1] == spin) << 7;
+  }
+}
+
+std::vector<int> FragmentedCells(const SpinLattice &sigma, int sizex,
+                                 int sizey, bool periodic) {
+  const int px = sizex - 2, py = sizey - 2;
+  auto site = [py](int x, int y) { return (x - 1) * py + (y - 1); };
+
+  // the pattern of each site for its own spin tells which neighbours belong
+  // to the same piece
+  // SameSpinMasks works on contiguous columns, whatever the layout of sigma
+  std::vector<unsigned char> masks(px * py);
+  std::vector<Spin> columns(3 * sizey);
+  for (int x = 1; x <= px; x++) {
+    for (int i = 0; i < 3; i++)
+      for (int y = 0; y < sizey; y++)
+        columns[i * sizey + y] = sigma(x - 1 + i, y);
+    SameSpinMasks(&columns[1], &columns[sizey + 1], &columns[2 * sizey + 1],
+                  py, &masks[site(x, 1)]);
+  }
+
+  std::vector<bool> visited(px * py, false);
+  std::vector<bool> seen;
+  std::vector<int> fragmented;
+  std::vector<std::array<int, 2>> stack;
+  for (int x = 1; x <= px; x++)
+    for (int y = 1; y <= py; y++) {
+      const int spin = sigma(x, y);
+      if (spin <= 0 || visited[site(x, y)])
+        continue;
+
+      // a new piece: the cell is fragmented if it had one already
+      if (spin >= static_cast<int>(seen.size()))
+        seen.resize(spin + 1, false);
+      if (seen[spin])
+        fragmented.push_back(spin);
+      seen[spin] = true;
+
+      visited[site(x, y)] = true;
+      stack.push_back({x, y});
+      while (!stack.empty()) {
+        auto [cx, cy] = stack.back();
+        stack.pop_back();
+        const unsigned mask = masks[site(cx, cy)];
+        for (int i = 0; i < 8; i++) {
+          if (!(mask & (1 << i)))
+            continue;
+          int nx = cx + ring_x[i], ny = cy + ring_y[i];
+          if (periodic) {
+            nx = (nx < 1) ? nx + px : (nx > px) ? nx - px : nx;
+            ny = (ny < 1) ? ny + py : (ny > py) ? ny - py : ny;
+          }
+          if (!visited[site(nx, ny)]) {
+            visited[site(nx, ny)] = true;
+            stack.push_back({nx, ny});
+          }
+        }
+      }
+    }
+
+  std::sort(fragmented.begin(), fragmented.end());
+  fragmented.erase(std::unique(fragmented.begin(), fragmented.end()),
+                   fragmented.end());
+  return fragmented;
+}
+
+} // namespace Connectivity
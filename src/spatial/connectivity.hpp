@@ -0,0 +1,121 @@
+#pragma once
+#include <array>
+#include <vector>
+
+#include "spin_lattice.hpp"
+
+/** Connectivity of spins on the lattice
+ *
+ * The 8 neighbours of a site are numbered in cyclic order, starting on the
+ * left, and a neighbourhood pattern is packed into a byte with bit i set if
+ * neighbour i has the spin of interest. Local questions about connectivity
+ * are then answered from tables with an entry for each of the 256 patterns,
+ * rather than by walking the neighbourhood with branches.
+ */
+namespace Connectivity {
+
+/// Offsets of neighbour i in the cyclic order
+constexpr int ring_x[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
+constexpr int ring_y[8] = {0, -1, -1, -1, 0, 1, 1, 1};
+
+namespace detail {
+
+constexpr std::array<bool, 256> MakeLocallyConnected() {
+  // Durand, M., & Guesnet, E. (2016). An efficient Cellular Potts Model
+  // algorithm that forbids cell fragmentation. Computer Physics
+  // Communications, 208, 54-63.
+  std::array<bool, 256> table{};
+  for (int mask = 0; mask < 256; mask++) {
+    int components = 0;
+    bool in_component = false;
+    for (int i = 0; i < 8; i++) {
+      bool same = mask & (1 << i);
+      if (same && !in_component)
+        components++;
+      in_component = same;
+    }
+    // the first and last neighbour are adjacent too
+    bool looped = (mask & 1) && (mask & 128);
+    table[mask] = looped ? components < 3 : components < 2;
+  }
+  return table;
+}
+
+constexpr std::array<unsigned char, 256> MakeBorderCount() {
+  std::array<unsigned char, 256> table{};
+  for (int mask = 0; mask < 256; mask++) {
+    int changes = mask ^ (((mask >> 1) | (mask << 7)) & 0xff);
+    int count = 0;
+    for (int i = 0; i < 8; i++)
+      count += (changes >> i) & 1;
+    table[mask] = count;
+  }
+  return table;
+}
+
+} // namespace detail
+
+/// Whether a pattern is locally connected, i.e. its neighbours form at most
+/// one connected piece around the site
+inline constexpr std::array<bool, 256> locally_connected =
+    detail::MakeLocallyConnected();
+
+/// The number of pairs of cyclically adjacent neighbours of which exactly one
+/// is in the pattern
+inline constexpr std::array<unsigned char, 256> border_count =
+    detail::MakeBorderCount();
+
+/**
+ * @brief The pattern of the neighbours of (x,y) with spin.
+ *
+ * All neighbours must lie within sigma, e.g. in its border ring or halo.
+ */
+inline unsigned SameSpinMask(const SpinLattice &sigma, int x, int y,
+                             int spin) {
+  return (sigma(x - 1, y) == spin) | (sigma(x - 1, y - 1) == spin) << 1 |
+         (sigma(x, y - 1) == spin) << 2 | (sigma(x + 1, y - 1) == spin) << 3 |
+         (sigma(x + 1, y) == spin) << 4 | (sigma(x + 1, y + 1) == spin) << 5 |
+         (sigma(x, y + 1) == spin) << 6 | (sigma(x - 1, y + 1) == spin) << 7;
+}
+
+/**
+ * @brief Check if spin is locally connected at (x,y).
+ *
+ * If this holds for both the old and the new spin of a site, changing it
+ * neither fragments a cell nor makes a hole in it.
+ */
+inline bool LocallyConnected(const SpinLattice &sigma, int x, int y,
+                             int spin) {
+  return locally_connected[SameSpinMask(sigma, x, y, spin)];
+}
+
+/**
+ * @brief Patterns of n consecutive sites of a column, each for its own spin.
+ *
+ * Site k is mid[k], and its neighbours are in the columns left and right and
+ * at mid[k - 1] and mid[k + 1], which must all be readable. The loop has no
+ * branches, so that the compiler can vectorise it and build the patterns of
+ * many sites at once.
+ *
+ * @param left The column before that of the sites.
+ * @param mid The column of the sites.
+ * @param right The column after that of the sites.
+ * @param n The number of sites.
+ * @param masks Output, the n patterns.
+ */
+void SameSpinMasks(const Spin *left, const Spin *mid, const Spin *right, int n,
+                   unsigned char *masks);
+
+/**
+ * @brief The cells that are in more than one piece.
+ *
+ * Checks the whole lattice, [1, sizex - 2] x [1, sizey - 2], taking pixels
+ * of a cell that touch at a corner to be connected. If periodic, sigma's
+ * halo must be filled, otherwise its border ring must be set.
+ *
+ * @return The fragmented cells, in increasing order.
+ */
+std::vector<int> FragmentedCells(const SpinLattice &sigma, int sizex,
+                                 int sizey, bool periodic);
+
+} // namespace Connectivity
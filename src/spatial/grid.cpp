@@ -1,5 +1,6 @@
 
 #include "grid.hpp"
+#include "connectivity.hpp"
 #include "parameter.hpp"
 
 extern Parameter par;
@@ -33,48 +34,10 @@ Neighbours Grid::neighbours(PixelPos coordinate) {
 
 bool LocalConnectedness(const Grid &grid, PixelPos pos, int spin)
 {
-    // Algorithm from Durand, M., & Guesnet, E. (2016). An efficient Cellular
-    // Potts Model algorithm that forbids cell fragmentation. Computer Physics
-    // Communications, 208, 54-63. Checks if cell sigma is locally connected at
-    // lattice point (x,y) if using LocalConnectedness(x,y,sigma[x][y]) and
-    // LocalConnectedness(x,y,sigma[xp][yp] both are true
-
-    // Use local nx and ny in a cyclic order (starts at upper left corner)
-    const int cyc_nx[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
-    const int cyc_ny[8] = {0, -1, -1, -1, 0, 1, 1, 1};
-    const PixelPos cyc[8] = {
-      { -1,  0}, { -1, -1}, {  0, -1}, {  1, -1}, {  1,  0}, {  1,  1},
-      {  0,  1}, { -1,  1}
-    };     
-    bool connected_component = false;
-    // Currently in a connected component
-    int nr_connected_components = 0;
-    // Total number of conncected components around x,y
-    for (int i = 0; i <= 7; i++)
-    {
-        int s_nb = grid.get(pos + cyc[i]);
-        if (s_nb == spin && !connected_component)
-        {
-            // start of a connected component
-            connected_component = true;
-            nr_connected_components++;
-        }
-        else if (s_nb != spin && connected_component)
-        {
-            // end of a conencted component
-            connected_component = false;
-        }
-    }
-    bool looped = false;
-    if (grid.get(pos + cyc[0]) == spin &&
-        grid.get(pos + cyc[7]) == spin)
-        looped = true;
-    // Check if the first and last element are connected
-    if ((nr_connected_components >= 2 && !looped) ||
-        nr_connected_components >= 3 && looped)
-        // permit one more component when the first and last element are
-        // connected
-        return false;
-    else
-        return true;
-}
\ No newline at end of file
+    unsigned mask = 0;
+    for (int i = 0; i < 8; i++)
+        if (grid.get(pos + PixelDisplacement(Connectivity::ring_x[i],
+                                             Connectivity::ring_y[i])) == spin)
+            mask |= 1u << i;
+    return Connectivity::locally_connected[mask];
+}
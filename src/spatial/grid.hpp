@@ -2,8 +2,8 @@
 
 #include "array2d.hpp"
 #include "neighbours.hpp"
+#include "spin.hpp"
 
-typedef int Spin;
 typedef std::pair<PixelPos, PixelPos> CopyAttempt;
 
 /**
@@ -21,7 +21,7 @@ public:
   Neighbours neighbours(PixelPos);
 
 private:
-  Array2d<int> spinfield_;
+  Array2d<Spin> spinfield_;
 };
 
 /**
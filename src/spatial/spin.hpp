@@ -0,0 +1,24 @@
+#pragma once
+#include <cstdint>
+
+/** @brief The type of a site of the CPM lattice.
+ *
+ * A site holds the sigma of the cell it belongs to, 0 for the medium or -1
+ * for the border. By default that is an int, but when building with
+ * COMPACT_SPINS = enabled it is a 16-bit integer instead, which halves the
+ * memory traffic of the lattice and lets larger lattices fit in the cache.
+ * The border and the medium keep their values, so compact builds are limited
+ * to SPIN_MAX = 32767 cells, which Cell checks when a cell is created.
+ *
+ * OPENCL_SPIN_TYPE is the matching definition for the OpenCL kernels, to be
+ * prepended to the kernel source like OPENCL_PDE_TYPE.
+ */
+#ifdef COMPACT_SPINS_ENABLED
+typedef std::int16_t Spin;
+#define SPIN_MAX INT16_MAX
+#define OPENCL_SPIN_TYPE "#define SPIN_TYPE short\n"
+#else
+typedef int Spin;
+#define SPIN_MAX INT32_MAX
+#define OPENCL_SPIN_TYPE "#define SPIN_TYPE int\n"
+#endif
@@ -0,0 +1,17 @@
+#include "spin_lattice.hpp"
+
+SpinLattice::SpinLattice(int sizex, int sizey, int pad, Spin fill)
+    : sizex_(sizex), sizey_(sizey), pad_(pad) {
+  const std::ptrdiff_t columns = sizex + 2 * pad;
+  const std::ptrdiff_t rows = sizey + 2 * pad;
+#ifdef TILED_LATTICE_ENABLED
+  // round up to whole tiles
+  tiles_y_ = (rows + tile - 1) / tile;
+  const std::size_t tiles_x = (columns + tile - 1) / tile;
+  sites_.assign(tiles_x * tiles_y_ * tile * tile, fill);
+#else
+  stride_ = rows;
+  origin_ = pad * stride_ + pad;
+  sites_.assign(columns * rows, fill);
+#endif
+}
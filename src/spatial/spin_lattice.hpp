@@ -0,0 +1,63 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+#include "spin.hpp"
+
+/** @brief The sites of the CPM lattice.
+ *
+ * Holds sizex x sizey sites surrounded by pad more layers of sites, so that
+ * (x,y) is addressable for -pad <= x < sizex + pad and -pad <= y < sizey + pad.
+ * All reads and writes go through operator(), which leaves the order in which
+ * the sites are stored to the lattice.
+ *
+ * By default the sites are stored column by column, y running fastest, like
+ * the Spin ** lattice that this replaces. When building with
+ * TILED_LATTICE = enabled they are stored in tiles of 4 x 4 sites instead.
+ * A site and its neighbours then mostly lie in one or two tiles, rather than
+ * in three to five columns that are a whole column apart in memory.
+ */
+class SpinLattice {
+public:
+  SpinLattice() = default;
+
+  /** @brief A lattice of sizex x sizey sites and pad layers around them
+   * @param fill The initial value of every site, including the pad layers.
+   */
+  SpinLattice(int sizex, int sizey, int pad, Spin fill);
+
+  Spin &operator()(int x, int y) { return sites_[Index(x, y)]; }
+  Spin operator()(int x, int y) const { return sites_[Index(x, y)]; }
+
+  int SizeX() const { return sizex_; }
+  int SizeY() const { return sizey_; }
+  int Pad() const { return pad_; }
+
+private:
+#ifdef TILED_LATTICE_ENABLED
+  static constexpr std::size_t tile = 4;
+
+  std::size_t Index(int x, int y) const {
+    // unsigned, so that / and % are shifts and masks
+    const std::size_t u = x + pad_, v = y + pad_;
+    return ((u / tile) * tiles_y_ + v / tile) * (tile * tile) +
+           (u % tile) * tile + v % tile;
+  }
+
+  // the number of tiles along y, including the pad layers
+  std::size_t tiles_y_ = 0;
+#else
+  std::ptrdiff_t Index(int x, int y) const {
+    return origin_ + x * stride_ + y;
+  }
+
+  // the number of sites in a column, and the index of site (0,0)
+  std::ptrdiff_t stride_ = 0;
+  std::ptrdiff_t origin_ = 0;
+#endif
+
+  int sizex_ = 0;
+  int sizey_ = 0;
+  int pad_ = 0;
+  std::vector<Spin> sites_;
+};
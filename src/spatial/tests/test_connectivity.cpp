@@ -0,0 +1,116 @@
+#include "connectivity.cpp"
+#include "spin_lattice.cpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <vector>
+
+namespace {
+
+// The original walk around the neighbourhood, from Durand and Guesnet
+bool ReferenceLocalConnectedness(const SpinLattice &sigma, int x, int y,
+                                 int s) {
+  const int cyc_nx[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
+  const int cyc_ny[8] = {0, -1, -1, -1, 0, 1, 1, 1};
+  bool connected_component = false;
+  int nr_connected_components = 0;
+  for (int i = 0; i <= 7; i++) {
+    int s_nb = sigma(x + cyc_nx[i], y + cyc_ny[i]);
+    if (s_nb == s && !connected_component) {
+      connected_component = true;
+      nr_connected_components++;
+    } else if (s_nb != s && connected_component)
+      connected_component = false;
+  }
+  bool looped = sigma(x + cyc_nx[0], y + cyc_ny[0]) == s &&
+                sigma(x + cyc_nx[7], y + cyc_ny[7]) == s;
+  return !((nr_connected_components >= 2 && !looped) ||
+           (nr_connected_components >= 3 && looped));
+}
+
+} // namespace
+
+TEST_CASE("Tables agree with walking the neighbourhood", "[connectivity]") {
+  // a lattice with a border ring of -1, as in CellularPotts
+  SpinLattice sigma(3, 3, 0, -1);
+  for (int pattern = 0; pattern < 256; pattern++) {
+    for (int i = 0; i < 8; i++)
+      sigma(1 + Connectivity::ring_x[i], 1 + Connectivity::ring_y[i]) =
+          (pattern & (1 << i)) ? 1 : 2;
+    sigma(1, 1) = 1;
+
+    REQUIRE(Connectivity::SameSpinMask(sigma, 1, 1, 1) ==
+            static_cast<unsigned>(pattern));
+    REQUIRE(Connectivity::LocallyConnected(sigma, 1, 1, 1) ==
+            ReferenceLocalConnectedness(sigma, 1, 1, 1));
+  }
+
+  REQUIRE(Connectivity::border_count[0x00] == 0);
+  REQUIRE(Connectivity::border_count[0xff] == 0);
+  REQUIRE(Connectivity::border_count[0x01] == 2);
+  REQUIRE(Connectivity::border_count[0x81] == 2);
+  REQUIRE(Connectivity::border_count[0x55] == 8);
+}
+
+TEST_CASE("Patterns of a column are built at once", "[connectivity]") {
+  SpinLattice sigma(5, 12, 0, -1);
+  for (int x = 1; x < 4; x++)
+    for (int y = 1; y < 11; y++)
+      sigma(x, y) = (x * 5 + y * 3 + x * y) % 3;
+
+  std::vector<Spin> columns(3 * 12);
+  for (int x = 1; x < 4; x++)
+    for (int y = 0; y < 12; y++)
+      columns[(x - 1) * 12 + y] = sigma(x, y);
+
+  unsigned char masks[10];
+  Connectivity::SameSpinMasks(&columns[1], &columns[13], &columns[25], 10,
+                              masks);
+  for (int y = 1; y < 11; y++)
+    REQUIRE(masks[y - 1] == Connectivity::SameSpinMask(sigma, 2, y,
+                                                       sigma(2, y)));
+}
+
+TEST_CASE("Fragmented cells are found", "[connectivity]") {
+  SpinLattice sigma(8, 8, 0, -1);
+  for (int x = 1; x < 7; x++)
+    for (int y = 1; y < 7; y++)
+      sigma(x, y) = 0;
+
+  SECTION("Cells touching at a corner are in one piece") {
+    sigma(1, 1) = 1;
+    sigma(2, 2) = 1;
+    sigma(3, 3) = 1;
+    sigma(5, 5) = 2;
+    REQUIRE(Connectivity::FragmentedCells(sigma, 8, 8, false).empty());
+  }
+
+  SECTION("Split cells are reported once") {
+    sigma(1, 1) = 3;
+    sigma(4, 4) = 3;
+    sigma(6, 6) = 3;
+    sigma(2, 5) = 1;
+    sigma(5, 2) = 1;
+    sigma(3, 3) = 2;
+    REQUIRE(Connectivity::FragmentedCells(sigma, 8, 8, false) ==
+            std::vector<int>{1, 3});
+  }
+
+  SECTION("Pieces may join across a periodic boundary") {
+    sigma(1, 3) = 1;
+    sigma(6, 3) = 1;
+    REQUIRE(Connectivity::FragmentedCells(sigma, 8, 8, false) ==
+            std::vector<int>{1});
+
+    // fill the halo, here just the ring
+    for (int y = 0; y < 8; y++) {
+      sigma(0, y) = sigma(6, y);
+      sigma(7, y) = sigma(1, y);
+    }
+    for (int x = 0; x < 8; x++) {
+      sigma(x, 0) = sigma(x, 6);
+      sigma(x, 7) = sigma(x, 1);
+    }
+    REQUIRE(Connectivity::FragmentedCells(sigma, 8, 8, true).empty());
+  }
+}
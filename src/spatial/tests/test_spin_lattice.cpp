@@ -0,0 +1,39 @@
+// Load the code to be tested
+#include "spin_lattice.cpp"
+
+// Dependencies for the test itself
+#include <catch2/catch_test_macros.hpp>
+
+TEST_CASE("Sites of a spin lattice", "[spin_lattice]") {
+  // odd sizes, so that tiles stick out of the lattice
+  const int sizex = 11, sizey = 7, pad = 2;
+  SpinLattice sigma(sizex, sizey, pad, -1);
+  REQUIRE(sigma.SizeX() == sizex);
+  REQUIRE(sigma.SizeY() == sizey);
+  REQUIRE(sigma.Pad() == pad);
+
+  SECTION("All sites start out filled") {
+    for (int x = -pad; x < sizex + pad; x++)
+      for (int y = -pad; y < sizey + pad; y++)
+        REQUIRE(sigma(x, y) == -1);
+  }
+
+  SECTION("Every site, including the pad layers, is a site of its own") {
+    auto value = [](int x, int y) { return Spin((x + 10) * 100 + y + 10); };
+    for (int x = -pad; x < sizex + pad; x++)
+      for (int y = -pad; y < sizey + pad; y++)
+        sigma(x, y) = value(x, y);
+
+    const SpinLattice &constant = sigma;
+    for (int x = -pad; x < sizex + pad; x++)
+      for (int y = -pad; y < sizey + pad; y++)
+        REQUIRE(constant(x, y) == value(x, y));
+  }
+
+  SECTION("Copies are independent") {
+    SpinLattice copy = sigma;
+    copy(3, 4) = 5;
+    REQUIRE(copy(3, 4) == 5);
+    REQUIRE(sigma(3, 4) == -1);
+  }
+}
@@ -0,0 +1,31 @@
+# Tests that run the whole CPM or PDE link against the sources of a model,
+# built once into a library in build/, and define the functions that a model
+# defines in mock_model.cpp, next to this file. The CPM and the PDE are too
+# slow to test without optimisation.
+#
+# Set CORE_TESTS to the names of these tests, then include this file.
+CXXFLAGS += -I../../test_support
+
+CORE_DIRS := adhesions cellular_potts compute parameters plotting \
+             reaction_diffusion spatial util
+CORE_SOURCES := $(wildcard $(CORE_DIRS:%=../../%/*.cpp)) ../../graphics/graph.cpp
+CORE_OBJECTS := $(CORE_SOURCES:../../%.cpp=build/core/%.o)
+CORE_LIBS := -L../../../lib/libCellShape -lcellshape
+CORE_LIBS += -L../../../lib/MultiCellDS/v1.0/v1.0.0/libMCDS/xsde/libxsde/xsde -lxsde
+CORE_LIBS += -lOpenCL -pthread
+
+build/core/%.o: ../../%.cpp
+	mkdir -p $(dir $@)
+	$(CXX) -c -o $@ $(CPPFLAGS) $(CXXFLAGS) -O2 -I../../../lib/libCellShape $<
+
+build/libcore.a: $(CORE_OBJECTS)
+	$(AR) rcs $@ $^
+
+$(CORE_TESTS:%=build/%): CXXFLAGS += -O2
+$(CORE_TESTS:%=build/%): LDFLAGS += build/libcore.a $(CORE_LIBS)
+$(CORE_TESTS:%=build/%): build/libcore.a
+
+.PHONY: clean_core
+clean_core:
+	rm -f build/libcore.a
+	rm -rf build/core
@@ -0,0 +1,54 @@
+// The functions that a model defines, for the tests that run the whole CPM or
+// PDE. The cells are set up as in the models, from the parameters, and the
+// secretion, decay and diffusion of every plane are those of the models.
+#include "dish.hpp"
+#include "parameter.hpp"
+#include "pde.hpp"
+#include "plotter.hpp"
+
+extern Parameter par;
+
+INIT
+{
+    CPM->GrowInCells(par.n_init_cells, par.size_init_cells, par.subfield);
+    CPM->ConstructInitCells(*this);
+    CPM->SetRandomTypes();
+    CPM->InitialiseEdgeList();
+    for (int l = 0; l < par.n_chem; l++)
+        PDEfield->SetSecretion(l, par.secr_rate[l], par.decay_rate[l]);
+}
+
+void Plotter::Plot() {}
+
+void PDE::DerivativesPDE(CellularPotts *cpm, PDEFIELD_TYPE *derivs, int x,
+                         int y)
+{
+    for (int l = 0; l < layers; l++)
+        derivs[l] = cpm->Sigma(x, y) ? par.secr_rate[l]
+                                     : -par.decay_rate[l] * PDEvars[l][x][y];
+}
+
+int PDE::MapColour(double val) { return 0; }
+
+void PDE::Secrete(CellularPotts *cpm)
+{
+    const double dt = par.dt;
+    for (int l = 0; l < layers; l++)
+        for (int x = 0; x < sizex; x++)
+            for (int y = 0; y < sizey; y++)
+                PDEvars[l][x][y] =
+                    cpm->Sigma(x, y)
+                        ? alt_PDEvars[l][x][y] + par.secr_rate[l] * dt
+                        : alt_PDEvars[l][x][y] -
+                              par.decay_rate[l] * dt * alt_PDEvars[l][x][y];
+}
+
+void PDE::InitialiseDiffusionCoefficients(CellularPotts *cpm)
+{
+    for (int l = 0; l < layers; l++)
+        for (int x = 0; x < sizex; x++)
+            for (int y = 0; y < sizey; y++)
+                DiffCoeffs[l][x][y] = par.diff_coeff[l];
+}
+
+void PDE::InitialisePDE(CellularPotts *cpm) {}
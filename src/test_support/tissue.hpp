@@ -0,0 +1,51 @@
+#ifndef _TISSUE_HPP_
+#define _TISSUE_HPP_
+
+// A dish of cells for the tests that run the whole CPM or PDE, together with
+// mock_model.cpp, which defines what a model would.
+#include "dish.hpp"
+#include "parameter.hpp"
+#include "random.hpp"
+
+#include <memory>
+
+extern Parameter par;
+
+/** Set the lattice and initial cells of a test dish
+ *
+ * This sets the parameters that every test dish shares. Anything else a test
+ * needs, like its update scheme or chemicals, it sets itself before calling
+ * MakeDish().
+ *
+ * @param sizex Width of the lattice, including the border
+ * @param sizey Height of the lattice, including the border
+ * @param periodic Whether the lattice has periodic boundaries
+ * @param n_cells Number of cells to grow
+ * @param cell_size Number of Eden growth steps for each cell
+ */
+inline void SetTissue(int sizex, int sizey, bool periodic, int n_cells,
+                      int cell_size)
+{
+    par.sizex = sizex;
+    par.sizey = sizey;
+    par.periodic_boundaries = periodic;
+    par.neighbours = 2;
+    par.n_init_cells = n_cells;
+    par.size_init_cells = cell_size;
+    par.subfield = 1.0;
+    par.Jtable = "../../../data/Jsorting.dat";
+    par.T = 50;
+}
+
+/** Make a dish from the current parameters
+ *
+ * @param seed Seed for the random number generator, so that the cells are
+ *        grown in the same places every time.
+ */
+inline std::unique_ptr<Dish> MakeDish(long seed)
+{
+    Seed(seed);
+    return std::make_unique<Dish>();
+}
+
+#endif
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief The Philox4x32-10 block function.
+ *
+ * From Salmon, J. K., Moraes, M. A., Dror, R. O., & Shaw, D. E. (2011).
+ * Parallel random numbers: as easy as 1, 2, 3. SC'11. A bijection of a
+ * 128-bit counter under a 64-bit key, giving four statistically independent
+ * 32-bit words per counter value.
+ */
+struct Philox4x32 {
+  using Counter = std::array<std::uint32_t, 4>;
+  using Key = std::array<std::uint32_t, 2>;
+
+  static Counter Block(Counter ctr, Key key) {
+    for (int round = 0; round < 10; round++) {
+      if (round > 0) {
+        key[0] += 0x9E3779B9;
+        key[1] += 0xBB67AE85;
+      }
+      std::uint64_t p0 = std::uint64_t(0xD2511F53) * ctr[0];
+      std::uint64_t p1 = std::uint64_t(0xCD9E8D57) * ctr[2];
+      ctr = {std::uint32_t(p1 >> 32) ^ ctr[1] ^ key[0], std::uint32_t(p1),
+             std::uint32_t(p0 >> 32) ^ ctr[3] ^ key[1], std::uint32_t(p0)};
+    }
+    return ctr;
+  }
+};
+
+/**
+ * @brief Counter-based random number stream.
+ *
+ * A stream is identified by a seed and a stream id; its n-th 32-bit word is
+ * a pure function of (seed, stream, n). Streams with different ids are
+ * independent, so each thread, tile or site can draw from its own stream
+ * and the results don't depend on the order in which they are evaluated.
+ * The state is just the position in the stream, which makes checkpointing
+ * trivial.
+ */
+class CounterRNG {
+public:
+  CounterRNG(std::uint64_t seed = 0, std::uint64_t stream = 0)
+      : seed_(seed), stream_(stream), block_(0), used_(4) {}
+
+  //! Next 32 random bits.
+  std::uint32_t Next() {
+    if (used_ == 4) {
+      buffer_ = Block(block_++);
+      used_ = 0;
+    }
+    return buffer_[used_++];
+  }
+
+  //! Uniform deviate in the open interval (0,1).
+  double Uniform() { return ToUniform(Next()); }
+
+  /** @brief Fill out[0..n) with uniform deviates in (0,1).
+   *
+   * Gives the same numbers as n calls to Uniform().
+   */
+  void Fill(double *out, std::size_t n) {
+    std::size_t i = 0;
+    for (; i < n && used_ < 4; i++)
+      out[i] = ToUniform(buffer_[used_++]);
+    for (; i + 4 <= n; i += 4) {
+      auto words = Block(block_++);
+      out[i] = ToUniform(words[0]);
+      out[i + 1] = ToUniform(words[1]);
+      out[i + 2] = ToUniform(words[2]);
+      out[i + 3] = ToUniform(words[3]);
+    }
+    for (; i < n; i++)
+      out[i] = Uniform();
+  }
+
+  //! Number of 32-bit words drawn from this stream so far.
+  std::uint64_t Position() const { return 4 * block_ - (4 - used_); }
+
+  //! Continue the stream at a position returned by Position().
+  void SetPosition(std::uint64_t position) {
+    block_ = position / 4;
+    used_ = 4;
+    for (std::uint64_t i = 0; i < position % 4; i++)
+      Next();
+  }
+
+  std::uint64_t Seed() const { return seed_; }
+  std::uint64_t Stream() const { return stream_; }
+
+  //! The word at position index of stream (seed, stream), without state.
+  static std::uint32_t At(std::uint64_t seed, std::uint64_t stream,
+                          std::uint64_t index) {
+    return CounterRNG(seed, stream).Block(index / 4)[index % 4];
+  }
+
+  static double ToUniform(std::uint32_t word) {
+    return (word + 0.5) * (1.0 / 4294967296.0);
+  }
+
+private:
+  Philox4x32::Counter Block(std::uint64_t block) const {
+    return Philox4x32::Block(
+        {std::uint32_t(block), std::uint32_t(block >> 32),
+         std::uint32_t(stream_), std::uint32_t(stream_ >> 32)},
+        {std::uint32_t(seed_), std::uint32_t(seed_ >> 32)});
+  }
+
+  std::uint64_t seed_;
+  std::uint64_t stream_;
+  std::uint64_t block_;
+  Philox4x32::Counter buffer_;
+  int used_;
+};
@@ -67,7 +67,7 @@ void Info::Menu() {
       cout << "Areas and deviations from target area:\n";
 
       int t = 0;
-      vector<Cell>::const_iterator i;
+      CellPool::const_iterator i;
       for ((i = dish->cell.begin(), i++); i != dish->cell.end(); i++) {
         t += i->Area() - i->TargetArea();
         *os << i->Sigma() << " " << i->Area() - i->TargetArea() << " "
@@ -91,7 +91,7 @@ void Info::Menu() {
       break;
     case 'V': {
       int t = 0;
-      vector<Cell>::iterator i;
+      CellPool::iterator i;
       for ((i = dish->cell.begin(), i++); i != dish->cell.end(); i++) {
         // extern double lambda; int ll; char tempstring[100];
         t += i->Area() - i->TargetArea();
@@ -150,26 +150,22 @@ void Info::Menu() {
     } break;
     case 'N': {
       cerr << "Getting neighbors\n";
-      int **neighbours = dish->CPM->SearchNeighbours();
-      vector<Cell>::iterator i;
+      const ContactGraph &neighbours = dish->CPM->SearchNeighbours();
+      CellPool::iterator i;
       for ((i = dish->cell.begin(), i++); i != dish->cell.end(); i++) {
         printf("Neighbours of cell %d are : ", i->Sigma());
-        for (int j = 0; j <= (signed int)(dish->cell.size()); j++) {
-          if (neighbours[i->Sigma()][j] >= 0)
-            printf("%d ", neighbours[i->Sigma()][j]);
-        }
+        for (const auto &contact : neighbours.Contacts(i->Sigma()))
+          printf("%d ", contact.spin);
         printf("\n");
       }
       printf(" \n");
-      free(neighbours[0]);
-      free(neighbours);
     } break;
 
     case '#':
       printf("number of (living) cells = %d \n", dish->CountCells());
       break;
     case 'B': {
-      vector<Cell>::const_iterator i;
+      CellPool::const_iterator i;
       for ((i = dish->cell.begin(), i++); i != dish->cell.end(); i++) {
         printf("Cell: %d, mother: %d\n time of birth: %d\n divisions: %d\n "
                "type at birth: %d\n current type: %d\n daughter: %d\n",
@@ -244,7 +244,7 @@ void IO::CountSigma(std::ostream &os) {
   }
   for (int x = 1; x < par.sizex - 1; x++) {
     for (int y = 1; y < par.sizey - 1; y++) {
-      sum_sigma[dish->CPM->getSigma()[x][y]]++;
+      sum_sigma[dish->CPM->getSigma()(x, y)]++;
     }
   }
   for (int i = 0; i < Cell::MaxSigma(); i++) {
@@ -257,30 +257,22 @@ void IO::WriteContactInterfaces(void) {
   int RedRedSurface = 0;
   int RedYellowSurface = 0;
   int YellowYellowSurface = 0;
-  for (int x = 1; x < par.sizex - 1; x++)
-    for (int y = 1; y < par.sizey - 1; y++) {
-      for (int i = 1; i <= 4; i++) {
-        int x2, y2;
-        x2 = x + dish->CPM->getNbhx(i);
-        y2 = y + dish->CPM->getNbhy(i);
-        if (dish->CPM->getSigma()[x][y] != dish->CPM->getSigma()[x2][y2]) {
-          // dish->CPM->getCell())[dish->CPM->getSigma()[x][y]] returns the cell
-          // corresponding to the sigma found on position (x,y)
-          if ((dish->CPM->getCell(dish->CPM->getSigma()[x][y])).getTau() == 1 &&
-              (dish->CPM->getCell(dish->CPM->getSigma()[x2][y2])).getTau() == 1)
-            RedRedSurface++;
-          if ((dish->CPM->getCell(dish->CPM->getSigma()[x][y])).getTau() == 2 &&
-              (dish->CPM->getCell(dish->CPM->getSigma()[x2][y2])).getTau() == 1)
-            RedYellowSurface++;
-          if ((dish->CPM->getCell(dish->CPM->getSigma()[x][y])).getTau() == 1 &&
-              (dish->CPM->getCell(dish->CPM->getSigma()[x2][y2])).getTau() == 2)
-            RedYellowSurface++;
-          if ((dish->CPM->getCell(dish->CPM->getSigma()[x][y])).getTau() == 2 &&
-              (dish->CPM->getCell(dish->CPM->getSigma()[x2][y2])).getTau() == 2)
-            YellowYellowSurface++;
-        }
-      }
+  // every interface is visited from both of its sides
+  const ContactGraph &contacts = dish->CPM->GetContactGraph();
+  for (int a = 1; a < contacts.Spins(); a++) {
+    const int tau_a = dish->CPM->getCell(a).getTau();
+    for (const auto &contact : contacts.Contacts(a)) {
+      if (contact.spin <= 0)
+        continue;
+      const int tau_b = dish->CPM->getCell(contact.spin).getTau();
+      if (tau_a == 1 && tau_b == 1)
+        RedRedSurface += contact.length;
+      if ((tau_a == 2 && tau_b == 1) || (tau_a == 1 && tau_b == 2))
+        RedYellowSurface += contact.length;
+      if (tau_a == 2 && tau_b == 2)
+        YellowYellowSurface += contact.length;
     }
+  }
   // cout << "Red-red surface = " << RedRedSurface << endl;
   // cout << "Red-yellow surface = " << RedYellowSurface << endl;
   // cout << "Yellow-yellow surface = " << YellowYellowSurface << endl;
@@ -291,19 +283,27 @@ void IO::WriteContactInterfaces(void) {
   myfile.close();
 }
 
+/** Write the contact graph as a block of lines "a b length", one for every
+ * pair of touching spins a < b (0 being the medium), after a line
+ * "# time t". Appending a block every MCS gives the contact statistics over
+ * time.
+ */
+void IO::WriteContactGraph(std::ostream &os) {
+  os << "# time " << dish->CPM->Time() << '\n';
+  dish->CPM->GetContactGraph().Write(os);
+}
+
 void IO::WriteConfiguration(char *write_loc) {
   // Write the current configuration in json format
   json Configuration;
   // Convert sigmafield to vector
-  int *sigmafieldarray = dish->CPM->getSigma()[0];
-  int size = par.sizex * par.sizey;
-  vector<int> sigmafieldvector(sigmafieldarray, sigmafieldarray + size);
+  vector<int> sigmafieldvector = dish->CPM->getSigmaArray();
   // Write sigmafield to json
   Configuration["sigma"] = sigmafieldvector;
 
   // Construct a cell types matrix
   vector<int> celltypes;
-  vector<Cell>::iterator c = dish->CPM->getCellArray()->begin();
+  CellPool::iterator c = dish->CPM->getCellArray()->begin();
   ++c;
   for (; c != dish->CPM->getCellArray()->end(); c++) {
     celltypes.push_back(c->getTau());
@@ -324,15 +324,18 @@ void IO::ReadConfiguration(void) {
 
   /* Fill CA plane with imported configuration */
   {
-    for (int i = 0; i < par.sizex * par.sizey; i++)
-      dish->CPM->getSigma()[0][i] = Configuration["sigma"][i];
+    SpinLattice &sigma = dish->CPM->getSigma();
+    for (int x = 0; x < par.sizex; x++)
+      for (int y = 0; y < par.sizey; y++)
+        sigma(x, y) = Configuration["sigma"][x * par.sizey + y];
+    dish->CPM->InvalidateSpinIndices();
   }
 
   // Construct the cells
   dish->CPM->ConstructInitCells(*dish);
 
   // Assign celltypes
-  vector<Cell>::iterator c = dish->CPM->getCellArray()->begin();
+  CellPool::iterator c = dish->CPM->getCellArray()->begin();
   ++c;
   for (; c != dish->CPM->getCellArray()->end(); c++) {
     c->setTau(Configuration["tau"][c->sigma - 1]);
@@ -53,6 +53,8 @@ public:
   void CountSigma(std::ostream &os);
   // Write contact surfaces to a file.
   void WriteContactInterfaces(void);
+  // Write the contact graph of the cells to an ostream
+  void WriteContactGraph(std::ostream &os);
   // Read and write json files
   void WriteConfiguration(char *write_loc);
   void ReadConfiguration(void);
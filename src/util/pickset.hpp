@@ -1,3 +1,4 @@
+#include "counter_rng.hpp"
 #include <cstddef>
 #include <functional>
 #include <random>
@@ -52,6 +53,10 @@ template <typename T, typename H = std::hash<T>> struct PickSet {
     return _vector[_distribution(_generator) % _vector.size()];
   }
 
+  const T &pickRandom(CounterRNG &rng) const {
+    return _vector[static_cast<std::size_t>(rng.Uniform() * _vector.size())];
+  }
+
   std::unordered_set<const T *, Hasher<T, H>, EqualTo<T, H>> _unorderedSet;
   std::vector<T> _vector;
 
@@ -30,6 +30,7 @@ Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
 #include <stdlib.h>
 
 static long idum = -1;
+static long current_seed = 0;
 
 /*! \return A random double between 0 and 1
  **/
@@ -92,6 +93,7 @@ long Seed(long seed) {
   } else {
     int rseed = (seed % (MBIG - 1));
     int i;
+    current_seed = seed;
     idum = -rseed;
     for (i = 0; i < 100; i++)
       RANDOM();
@@ -99,6 +101,11 @@ long Seed(long seed) {
   }
 }
 
+/*! \return The seed last passed to Seed(), or the one chosen by Randomize().
+  Seeds the counter-based generators, which don't depend on RANDOM()'s state.
+**/
+long CurrentSeed(void) { return current_seed; }
+
 /*! Returns a random integer value between 1 and 'max'
   \param The maximum value (long)
   \return A random integer (long)
@@ -27,6 +27,7 @@ Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
 
 double RANDOM();
 long Seed(long seed);
+long CurrentSeed(void);
 long RandomNumber(long max);
 void AskSeed();
 long Randomize(void);
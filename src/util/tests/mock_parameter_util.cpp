@@ -0,0 +1,4 @@
+#include "mock_parameter_util.hpp"
+
+
+Parameter par;
@@ -0,0 +1,8 @@
+#pragma once
+
+class MockParameter {
+    public:
+        int threads;
+};
+
+using Parameter = MockParameter;
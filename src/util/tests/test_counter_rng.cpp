@@ -0,0 +1,78 @@
+// Load the code to be tested
+#include "counter_rng.hpp"
+
+// Dependencies for the test itself
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <vector>
+
+TEST_CASE("Philox4x32-10 known answers", "[counter_rng]")
+{
+    // Known-answer vectors from the Random123 distribution
+    using C = Philox4x32::Counter;
+    REQUIRE(Philox4x32::Block({0, 0, 0, 0}, {0, 0}) ==
+            C{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8});
+    REQUIRE(Philox4x32::Block({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+                              {0xffffffff, 0xffffffff}) ==
+            C{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd});
+    REQUIRE(Philox4x32::Block({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344},
+                              {0xa4093822, 0x299f31d0}) ==
+            C{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1});
+}
+
+TEST_CASE("Fill gives the same numbers as Uniform", "[counter_rng]")
+{
+    CounterRNG a(42, 7), b(42, 7);
+    // start off a block boundary, then fill a length that isn't a multiple
+    // of four either
+    a.Uniform();
+    b.Uniform();
+
+    std::vector<double> filled(13);
+    a.Fill(filled.data(), filled.size());
+    for (double u : filled)
+        CHECK(u == b.Uniform());
+    REQUIRE(a.Position() == b.Position());
+    REQUIRE(a.Position() == 14);
+}
+
+TEST_CASE("Streams can be resumed from their position", "[counter_rng]")
+{
+    CounterRNG a(1234, 3);
+    for (int i = 0; i < 6; i++)
+        a.Next();
+
+    CounterRNG b(1234, 3);
+    b.SetPosition(a.Position());
+    for (int i = 0; i < 10; i++)
+        CHECK(a.Next() == b.Next());
+
+    CounterRNG c(1234, 3);
+    for (std::uint64_t i = 0; i < 10; i++)
+        CHECK(c.Next() == CounterRNG::At(1234, 3, i));
+}
+
+TEST_CASE("Streams are distinct and uniform", "[counter_rng]")
+{
+    CounterRNG s0(5, 0), s1(5, 1), other_seed(6, 0);
+    int same = 0;
+    for (int i = 0; i < 100; i++) {
+        auto w = s0.Next();
+        same += (w == s1.Next()) + (w == other_seed.Next());
+    }
+    REQUIRE(same == 0);
+
+    CounterRNG rng(99, 0);
+    double sum = 0.0, lowest = 1.0, highest = 0.0;
+    const int n = 100000;
+    for (int i = 0; i < n; i++) {
+        double u = rng.Uniform();
+        lowest = std::min(lowest, u);
+        highest = std::max(highest, u);
+        sum += u;
+    }
+    REQUIRE(lowest > 0.0);
+    REQUIRE(highest < 1.0);
+    REQUIRE(sum / n > 0.49);
+    REQUIRE(sum / n < 0.51);
+}
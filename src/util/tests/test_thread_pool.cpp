@@ -0,0 +1,66 @@
+#define _MOCK_PARAMETER_HPP_ "mock_parameter_util.hpp"
+
+// Load the code to be tested
+#include "mock_parameter_util.cpp"
+
+#include "thread_pool.cpp"
+
+// Dependencies for the test itself
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("ParallelFor runs every task exactly once", "[thread_pool]")
+{
+    for (int n_threads : {1, 2, 4}) {
+        ThreadPool pool(n_threads);
+        REQUIRE(pool.Size() == n_threads);
+
+        for (int n_tasks : {0, 1, 7, 100}) {
+            std::vector<std::atomic<int>> count(n_tasks);
+            pool.ParallelFor(n_tasks, [&](int i) { count[i]++; });
+            for (int i = 0; i < n_tasks; i++)
+                CHECK(count[i] == 1);
+        }
+    }
+}
+
+TEST_CASE("ParallelFor can be called repeatedly", "[thread_pool]")
+{
+    ThreadPool pool(3);
+    std::atomic<long> sum(0);
+    for (int round = 0; round < 200; round++)
+        pool.ParallelFor(10, [&](int i) { sum += i; });
+    REQUIRE(sum == 200 * 45);
+}
+
+TEST_CASE("ParallelFor rethrows task exceptions", "[thread_pool]")
+{
+    ThreadPool pool(2);
+    std::atomic<int> count(0);
+    REQUIRE_THROWS_AS(pool.ParallelFor(8, [&](int i) {
+        count++;
+        if (i == 3)
+            throw std::runtime_error("task failed");
+    }), std::runtime_error);
+    REQUIRE(count == 8);
+
+    // the pool is still usable afterwards
+    count = 0;
+    pool.ParallelFor(8, [&](int) { count++; });
+    REQUIRE(count == 8);
+}
+
+TEST_CASE("WorkerPool follows the threads parameter", "[thread_pool]")
+{
+    for (int n_threads : {1, 3, 3, 2, 1}) {
+        par.threads = n_threads;
+        ThreadPool &pool = WorkerPool();
+        REQUIRE(pool.Size() == n_threads);
+
+        std::atomic<int> count(0);
+        pool.ParallelFor(10, [&](int) { count++; });
+        REQUIRE(count == 10);
+    }
+}
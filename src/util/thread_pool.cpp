@@ -0,0 +1,108 @@
+#include "thread_pool.hpp"
+#include "parameter.hpp"
+#include <algorithm>
+#include <memory>
+
+extern Parameter par;
+
+ThreadPool::ThreadPool(int n_threads) {
+  for (int i = 1; i < n_threads; i++)
+    workers_.emplace_back(&ThreadPool::WorkerLoop, this);
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  work_cv_.notify_all();
+  for (auto &worker : workers_)
+    worker.join();
+}
+
+void ThreadPool::ParallelFor(int n_tasks,
+                             const std::function<void(int)> &task) {
+  if (workers_.empty() || n_tasks <= 1) {
+    std::exception_ptr error;
+    for (int i = 0; i < n_tasks; i++) {
+      try {
+        task(i);
+      } catch (...) {
+        if (!error)
+          error = std::current_exception();
+      }
+    }
+    if (error)
+      std::rethrow_exception(error);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    task_ = &task;
+    n_tasks_ = n_tasks;
+    next_task_ = 0;
+    busy_workers_ = static_cast<int>(workers_.size());
+    error_ = nullptr;
+    generation_++;
+  }
+  work_cv_.notify_all();
+
+  RunTasks();
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_cv_.wait(lock, [this] { return busy_workers_ == 0; });
+  task_ = nullptr;
+  if (error_)
+    std::rethrow_exception(error_);
+}
+
+void ThreadPool::RunTasks() {
+  while (true) {
+    int i;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (next_task_ >= n_tasks_)
+        return;
+      i = next_task_++;
+    }
+    try {
+      (*task_)(i);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!error_)
+        error_ = std::current_exception();
+    }
+  }
+}
+
+void ThreadPool::WorkerLoop() {
+  unsigned seen_generation = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      work_cv_.wait(lock, [&] {
+        return stop_ || generation_ != seen_generation;
+      });
+      if (stop_)
+        return;
+      seen_generation = generation_;
+    }
+
+    RunTasks();
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      busy_workers_--;
+    }
+    done_cv_.notify_one();
+  }
+}
+
+ThreadPool &WorkerPool() {
+  static std::unique_ptr<ThreadPool> pool;
+  const int n_threads = std::max(1, par.threads);
+  if (!pool || pool->Size() != n_threads)
+    pool = std::make_unique<ThreadPool>(n_threads);
+  return *pool;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed-size pool of worker threads for data-parallel loops.
+ *
+ * The thread calling ParallelFor() takes part in the work, so a pool of size
+ * n starts n - 1 workers and a pool of size 1 runs everything inline.
+ */
+class ThreadPool {
+public:
+  /** @brief Create a pool that runs loops on n_threads threads in total.
+   *
+   * @param n_threads Number of threads, including the calling thread.
+   */
+  explicit ThreadPool(int n_threads);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /** @brief Number of threads that take part in a ParallelFor. */
+  int Size() const { return static_cast<int>(workers_.size()) + 1; }
+
+  /** @brief Call task(i) for every i in [0, n_tasks) and wait for all.
+   *
+   * Tasks are handed out dynamically, so the assignment of tasks to threads
+   * differs from run to run; tasks must not depend on it. If a task throws,
+   * the remaining tasks are still run and the first exception is rethrown
+   * on the calling thread.
+   */
+  void ParallelFor(int n_tasks, const std::function<void(int)> &task);
+
+private:
+  void WorkerLoop();
+  void RunTasks();
+
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable work_cv_;
+  std::condition_variable done_cv_;
+
+  const std::function<void(int)> *task_ = nullptr;
+  int n_tasks_ = 0;
+  int next_task_ = 0;
+  int busy_workers_ = 0;
+  unsigned generation_ = 0;
+  bool stop_ = false;
+  std::exception_ptr error_;
+};
+
+/** @brief The shared pool, sized by the "threads" parameter.
+ *
+ * The pool is started again if the parameter has changed since the last
+ * call, so callers should not keep the reference past their loops.
+ */
+ThreadPool &WorkerPool();